@@ -0,0 +1,164 @@
+#pragma once
+
+#include "cinder/Timer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined( _MSC_VER )
+	#include <intrin.h>
+#endif
+
+//! Minimal Google Benchmark style harness. Benchmarks are free functions taking a State and
+//! looping on State::keepRunning(), registered with BENCHMARK( fn ). Results are reported as
+//! Google Benchmark compatible JSON so per-commit numbers can be compared with its tools.
+namespace benchmark {
+
+class State {
+public:
+	State( uint64_t maxIterations )
+		: mMaxIterations( maxIterations ) {}
+
+	bool keepRunning() {
+		if( 0 == mIterations ) {
+			resumeTiming();
+		}
+
+		if( mIterations < mMaxIterations ) {
+			++mIterations;
+			return true;
+		}
+
+		pauseTiming();
+		return false;
+	}
+
+	//! Excludes setup work inside the loop from the measurement
+	void pauseTiming() {
+		if( mRunning ) {
+			mTimer.stop();
+			mSeconds += mTimer.getSeconds();
+			mRunning = false;
+		}
+	}
+
+	void resumeTiming() {
+		if( ! mRunning ) {
+			mTimer.start();
+			mRunning = true;
+		}
+	}
+
+	uint64_t getIterations() const { return mMaxIterations; }
+	double getSeconds() const { return mSeconds; }
+
+	uint64_t getItemsProcessed() const { return mItemsProcessed; }
+	void setItemsProcessed( uint64_t value ) { mItemsProcessed = value; }
+
+private:
+	uint64_t		mMaxIterations = 0;
+	uint64_t		mIterations = 0;
+	uint64_t		mItemsProcessed = 0;
+	ci::Timer		mTimer;
+	bool			mRunning = false;
+	double			mSeconds = 0.0;
+};
+
+using Function = std::function<void(State&)>;
+
+struct Result {
+	std::string		name;
+	uint64_t		iterations = 0;
+	double			nsPerIteration = 0.0;
+	double			itemsPerSecond = 0.0;
+};
+
+//! Keeps the compiler from discarding a computed value. The whole object escapes and memory is
+//! clobbered, so every write that fed it has to happen.
+template <typename T> 
+inline void doNotOptimize( const T& value )
+{
+#if defined( _MSC_VER )
+	static const void* volatile sSink = nullptr;
+	sSink = &value;
+	_ReadWriteBarrier();
+#else
+	asm volatile( "" : : "g"( &value ) : "memory" );
+#endif
+}
+
+inline std::vector<std::pair<std::string, Function>>& getRegistry()
+{
+	static std::vector<std::pair<std::string, Function>> sRegistry;
+	return sRegistry;
+}
+
+inline bool registerBenchmark( const std::string& name, const Function& fn )
+{
+	getRegistry().push_back( std::make_pair( name, fn ) );
+	return true;
+}
+
+//! Runs every benchmark whose name contains \a filter, growing the iteration count until a run takes at least \a minTime seconds.
+inline std::vector<Result> runBenchmarks( const std::string& filter = "", double minTime = 0.5 )
+{
+	const uint64_t kMaxIterations = 1000000000;
+
+	std::vector<Result> results;
+	for( const auto& elem : getRegistry() ) {
+		if( ( ! filter.empty() ) && ( std::string::npos == elem.first.find( filter ) ) ) {
+			continue;
+		}
+
+		uint64_t iterations = 1;
+		while( true ) {
+			State state( iterations );
+			elem.second( state );
+
+			double seconds = state.getSeconds();
+			if( ( seconds >= minTime ) || ( iterations >= kMaxIterations ) ) {
+				Result result;
+				result.name = elem.first;
+				result.iterations = iterations;
+				result.nsPerIteration = 1.0e9 * seconds / static_cast<double>( iterations );
+				result.itemsPerSecond = ( seconds > 0.0 ) ? static_cast<double>( state.getItemsProcessed() ) / seconds : 0.0;
+				results.push_back( result );
+				break;
+			}
+
+			// Same growth policy as Google Benchmark: aim for 1.4x the minimum time, at most 10x per step
+			double multiplier = ( seconds > 0.0 ) ? std::min( 10.0, std::max( 1.0, 1.4 * minTime / seconds ) ) : 10.0;
+			iterations = std::min( kMaxIterations, std::max( iterations + 1, static_cast<uint64_t>( static_cast<double>( iterations ) * multiplier ) ) );
+		}
+	}
+	return results;
+}
+
+inline std::string toJson( const std::vector<Result>& results )
+{
+	std::stringstream ss;
+	ss << "{\n  \"benchmarks\": [\n";
+	for( size_t i = 0; i < results.size(); ++i ) {
+		const auto& result = results[i];
+		ss << "    {\n";
+		ss << "      \"name\": \"" << result.name << "\",\n";
+		ss << "      \"iterations\": " << result.iterations << ",\n";
+		ss << "      \"real_time\": " << result.nsPerIteration << ",\n";
+		ss << "      \"cpu_time\": " << result.nsPerIteration << ",\n";
+		ss << "      \"time_unit\": \"ns\"";
+		if( result.itemsPerSecond > 0.0 ) {
+			ss << ",\n      \"items_per_second\": " << result.itemsPerSecond;
+		}
+		ss << "\n    }" << ( ( i + 1 ) < results.size() ? "," : "" ) << "\n";
+	}
+	ss << "  ]\n}\n";
+	return ss.str();
+}
+
+} // namespace benchmark
+
+#define BENCHMARK( fn ) static bool fn##_registered = ::benchmark::registerBenchmark( #fn, fn )
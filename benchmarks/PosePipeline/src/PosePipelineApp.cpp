@@ -0,0 +1,674 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Log.h"
+#include "cinder/Rand.h"
+#include "cinder/Utilities.h"
+
+#include "cinder/vr/vr.h"
+#include "cinder/vr/PoseMath.h"
+#include "cinder/vr/InputThread.h"
+#include "cinder/vr/RayQuery.h"
+#include "cinder/vr/simulated/Controller.h"
+#include "cinder/vr/simulated/DeviceManager.h"
+#if defined( CINDER_VR_ENABLE_OCULUS )
+	#include "cinder/vr/oculus/Controller.h"
+#endif
+#if defined( CINDER_VR_ENABLE_OPENVR )
+	#include "cinder/vr/openvr/OpenVr.h"
+#endif
+
+#include "Benchmark.h"
+
+#include <fstream>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Session shared by the benchmarks that need a context
+static ci::vr::Context* sVrContext = nullptr;
+
+// -------------------------------------------------------------------------------------------------
+// Helpers
+// -------------------------------------------------------------------------------------------------
+static ci::mat4 randPoseMatrix( ci::Rand& rnd )
+{
+	ci::quat q = glm::angleAxis( rnd.nextFloat( 0.0f, 6.28f ), rnd.nextVec3() );
+	ci::mat4 result = glm::translate( rnd.nextVec3() * 2.0f ) * glm::mat4_cast( q );
+	return result;
+}
+
+//! Exposes the protected input entry points of the simulated controller
+class BenchController : public ci::vr::simulated::Controller {
+public:
+	BenchController( ci::vr::Controller::Type type, ci::vr::Context *context )
+		: ci::vr::simulated::Controller( type, context ) {}
+
+	void setTrigger( float value ) { setTriggerValue( getTrigger( ci::vr::Controller::TRIGGER_1 ), value ); }
+	void setAxis( const ci::vec2& value ) { setAxisValue( getAxis( ci::vr::Controller::AXIS_1 ), value ); }
+};
+
+// -------------------------------------------------------------------------------------------------
+// OpenVR pose conversion, as done per frame in openvr::Context::updatePoseData
+// -------------------------------------------------------------------------------------------------
+#if defined( CINDER_VR_ENABLE_OPENVR )
+static std::vector<::vr::TrackedDevicePose_t> randOpenVrPoses( ci::Rand& rnd )
+{
+	std::vector<::vr::TrackedDevicePose_t> result( ::vr::k_unMaxTrackedDeviceCount );
+	for( auto& pose : result ) {
+		ci::mat4 m = randPoseMatrix( rnd );
+		for( int r = 0; r < 3; ++r ) {
+			for( int c = 0; c < 4; ++c ) {
+				pose.mDeviceToAbsoluteTracking.m[r][c] = m[c][r];
+			}
+		}
+		pose.bPoseIsValid = true;
+	}
+	return result;
+}
+
+static void BM_OpenVrUpdatePoseMatrices( benchmark::State& state )
+{
+	ci::Rand rnd( 1 );
+	std::vector<::vr::TrackedDevicePose_t> poses = randOpenVrPoses( rnd );
+
+	std::vector<ci::mat4> deviceToTracking( ::vr::k_unMaxTrackedDeviceCount );
+	std::vector<ci::mat4> trackingToDevice( ::vr::k_unMaxTrackedDeviceCount );
+	while( state.keepRunning() ) {
+		for( ::vr::TrackedDeviceIndex_t deviceIndex = ::vr::k_unTrackedDeviceIndex_Hmd; deviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++deviceIndex ) {
+			if( poses[deviceIndex].bPoseIsValid ) {
+				deviceToTracking[deviceIndex] = ci::vr::openvr::fromOpenVr( poses[deviceIndex].mDeviceToAbsoluteTracking );
+				trackingToDevice[deviceIndex] = glm::affineInverse( deviceToTracking[deviceIndex] );
+			}
+		}
+		benchmark::doNotOptimize( trackingToDevice[::vr::k_unMaxTrackedDeviceCount - 1] );
+	}
+	state.setItemsProcessed( state.getIterations() * ::vr::k_unMaxTrackedDeviceCount );
+}
+BENCHMARK( BM_OpenVrUpdatePoseMatrices );
+
+static void BM_OpenVrUpdatePoseMatricesBatch( benchmark::State& state )
+{
+	ci::Rand rnd( 1 );
+	std::vector<::vr::TrackedDevicePose_t> poses = randOpenVrPoses( rnd );
+
+	std::vector<ci::mat4> deviceToTracking( ::vr::k_unMaxTrackedDeviceCount );
+	std::vector<ci::mat4> trackingToDevice( ::vr::k_unMaxTrackedDeviceCount );
+	while( state.keepRunning() ) {
+		ci::vr::convertRowMajor3x4( &poses[0].mDeviceToAbsoluteTracking, sizeof( ::vr::TrackedDevicePose_t ), deviceToTracking.data(), ::vr::k_unMaxTrackedDeviceCount );
+		ci::vr::invertRigid( deviceToTracking.data(), trackingToDevice.data(), ::vr::k_unMaxTrackedDeviceCount );
+		benchmark::doNotOptimize( trackingToDevice[::vr::k_unMaxTrackedDeviceCount - 1] );
+	}
+	state.setItemsProcessed( state.getIterations() * ::vr::k_unMaxTrackedDeviceCount );
+}
+BENCHMARK( BM_OpenVrUpdatePoseMatricesBatch );
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// Pose store update with a few moving devices among many static ones (base stations, props)
+// -------------------------------------------------------------------------------------------------
+static void BM_PoseStoreUpdate( benchmark::State& state )
+{
+	const uint32_t kNumMoving = 4;
+
+	ci::Rand rnd( 5 );
+	ci::mat4 poses[2][ci::vr::kPoseStoreMaxDevices];
+	for( uint32_t i = 0; i < ci::vr::kPoseStoreMaxDevices; ++i ) {
+		poses[0][i] = randPoseMatrix( rnd );
+		poses[1][i] = ( i < kNumMoving ) ? randPoseMatrix( rnd ) : poses[0][i];
+	}
+
+	ci::vr::PoseStore store;
+	uint32_t frame = 0;
+	while( state.keepRunning() ) {
+		const ci::mat4* framePoses = poses[frame & 1];
+		store.beginUpdate();
+		for( uint32_t deviceIndex = 0; deviceIndex < ci::vr::kPoseStoreMaxDevices; ++deviceIndex ) {
+			store.setPose( deviceIndex, framePoses[deviceIndex], ci::vec3( 0 ), ci::vec3( 0 ), 0.0 );
+		}
+		store.endUpdate();
+		benchmark::doNotOptimize( store.getTrackingToDeviceMatrix( 0 ) );
+		++frame;
+	}
+	state.setItemsProcessed( state.getIterations() * ci::vr::kPoseStoreMaxDevices );
+}
+BENCHMARK( BM_PoseStoreUpdate );
+
+// -------------------------------------------------------------------------------------------------
+// Rigid transform kernels against the equivalent glm expressions
+// -------------------------------------------------------------------------------------------------
+static const size_t kPoseMathBatchSize = 64;
+
+static void BM_GlmAffineInverse( benchmark::State& state )
+{
+	ci::Rand rnd( 7 );
+	std::vector<ci::mat4> src( kPoseMathBatchSize );
+	std::vector<ci::mat4> dst( kPoseMathBatchSize );
+	for( auto& m : src ) {
+		m = randPoseMatrix( rnd );
+	}
+
+	while( state.keepRunning() ) {
+		for( size_t i = 0; i < kPoseMathBatchSize; ++i ) {
+			dst[i] = glm::affineInverse( src[i] );
+		}
+		benchmark::doNotOptimize( dst[kPoseMathBatchSize - 1] );
+	}
+	state.setItemsProcessed( state.getIterations() * kPoseMathBatchSize );
+}
+BENCHMARK( BM_GlmAffineInverse );
+
+static void BM_PoseMathInvertRigid( benchmark::State& state )
+{
+	ci::Rand rnd( 7 );
+	std::vector<ci::mat4> src( kPoseMathBatchSize );
+	std::vector<ci::mat4> dst( kPoseMathBatchSize );
+	for( auto& m : src ) {
+		m = randPoseMatrix( rnd );
+	}
+
+	while( state.keepRunning() ) {
+		ci::vr::invertRigid( src.data(), dst.data(), kPoseMathBatchSize );
+		benchmark::doNotOptimize( dst[kPoseMathBatchSize - 1] );
+	}
+	state.setItemsProcessed( state.getIterations() * kPoseMathBatchSize );
+}
+BENCHMARK( BM_PoseMathInvertRigid );
+
+static void BM_GlmQuatPosition( benchmark::State& state )
+{
+	ci::Rand rnd( 8 );
+	std::vector<ci::quat> rotations( kPoseMathBatchSize );
+	std::vector<ci::vec3> positions( kPoseMathBatchSize );
+	std::vector<ci::mat4> dst( kPoseMathBatchSize );
+	for( size_t i = 0; i < kPoseMathBatchSize; ++i ) {
+		rotations[i] = glm::angleAxis( rnd.nextFloat( 0.0f, 6.28f ), rnd.nextVec3() );
+		positions[i] = rnd.nextVec3();
+	}
+
+	while( state.keepRunning() ) {
+		for( size_t i = 0; i < kPoseMathBatchSize; ++i ) {
+			dst[i] = glm::translate( positions[i] ) * glm::mat4_cast( rotations[i] );
+		}
+		benchmark::doNotOptimize( dst[kPoseMathBatchSize - 1] );
+	}
+	state.setItemsProcessed( state.getIterations() * kPoseMathBatchSize );
+}
+BENCHMARK( BM_GlmQuatPosition );
+
+static void BM_PoseMathConvertQuatPosition( benchmark::State& state )
+{
+	// Same layout as ovrPosef
+	struct QuatPosition {
+		float	rotation[4];
+		float	position[3];
+	};
+
+	ci::Rand rnd( 8 );
+	std::vector<QuatPosition> src( kPoseMathBatchSize );
+	std::vector<ci::mat4> dst( kPoseMathBatchSize );
+	for( auto& pose : src ) {
+		ci::quat q = glm::angleAxis( rnd.nextFloat( 0.0f, 6.28f ), rnd.nextVec3() );
+		ci::vec3 p = rnd.nextVec3();
+		pose.rotation[0] = q.x; pose.rotation[1] = q.y; pose.rotation[2] = q.z; pose.rotation[3] = q.w;
+		pose.position[0] = p.x; pose.position[1] = p.y; pose.position[2] = p.z;
+	}
+
+	while( state.keepRunning() ) {
+		ci::vr::convertQuatPosition( src.data(), sizeof( QuatPosition ), dst.data(), kPoseMathBatchSize );
+		benchmark::doNotOptimize( dst[kPoseMathBatchSize - 1] );
+	}
+	state.setItemsProcessed( state.getIterations() * kPoseMathBatchSize );
+}
+BENCHMARK( BM_PoseMathConvertQuatPosition );
+
+static void BM_GlmInputRayChain( benchmark::State& state )
+{
+	ci::Rand rnd( 9 );
+	ci::mat4 inverseLook = randPoseMatrix( rnd );
+	ci::mat4 inverseOrigin = randPoseMatrix( rnd );
+	std::vector<ci::mat4> src( kPoseMathBatchSize );
+	std::vector<ci::mat4> dst( kPoseMathBatchSize );
+	for( auto& m : src ) {
+		m = randPoseMatrix( rnd );
+	}
+
+	while( state.keepRunning() ) {
+		for( size_t i = 0; i < kPoseMathBatchSize; ++i ) {
+			dst[i] = inverseLook * inverseOrigin * src[i];
+		}
+		benchmark::doNotOptimize( dst[kPoseMathBatchSize - 1] );
+	}
+	state.setItemsProcessed( state.getIterations() * kPoseMathBatchSize );
+}
+BENCHMARK( BM_GlmInputRayChain );
+
+static void BM_PoseMathInputRayChain( benchmark::State& state )
+{
+	ci::Rand rnd( 9 );
+	ci::mat4 inverseLook = randPoseMatrix( rnd );
+	ci::mat4 inverseOrigin = randPoseMatrix( rnd );
+	std::vector<ci::mat4> src( kPoseMathBatchSize );
+	std::vector<ci::mat4> dst( kPoseMathBatchSize );
+	for( auto& m : src ) {
+		m = randPoseMatrix( rnd );
+	}
+
+	while( state.keepRunning() ) {
+		ci::vr::multiplyTransforms( inverseLook * inverseOrigin, src.data(), dst.data(), kPoseMathBatchSize );
+		benchmark::doNotOptimize( dst[kPoseMathBatchSize - 1] );
+	}
+	state.setItemsProcessed( state.getIterations() * kPoseMathBatchSize );
+}
+BENCHMARK( BM_PoseMathInputRayChain );
+
+// -------------------------------------------------------------------------------------------------
+// Oculus Touch input processing
+// -------------------------------------------------------------------------------------------------
+#if defined( CINDER_VR_ENABLE_OCULUS )
+//! Exposes the protected input entry points of the Touch controller
+class BenchControllerTouch : public ci::vr::oculus::ControllerTouch {
+public:
+	BenchControllerTouch( ci::vr::Controller::Type type, ci::vr::Context *context )
+		: ci::vr::oculus::ControllerTouch( type, context ) {}
+
+	void buttons( const ::ovrInputState& state ) { processButtons( state ); }
+	void inputState( const ::ovrInputState& state ) { processInputState( state ); }
+};
+
+static void BM_OculusProcessButtons( benchmark::State& state )
+{
+	BenchControllerTouch ctrl( ci::vr::Controller::TYPE_RIGHT, sVrContext );
+
+	// Alternate between no buttons and A+B held so every pass produces down and up transitions
+	::ovrInputState inputStates[2] = {};
+	inputStates[1].Buttons = ::ovrButton_A | ::ovrButton_B;
+
+	uint32_t i = 0;
+	while( state.keepRunning() ) {
+		ctrl.buttons( inputStates[i & 1] );
+		++i;
+	}
+}
+BENCHMARK( BM_OculusProcessButtons );
+
+static void BM_OculusProcessInputState( benchmark::State& state )
+{
+	BenchControllerTouch ctrl( ci::vr::Controller::TYPE_RIGHT, sVrContext );
+
+	::ovrInputState inputStates[2] = {};
+	inputStates[1].Buttons = ::ovrButton_A | ::ovrButton_B;
+	inputStates[1].IndexTrigger[::ovrHand_Right] = 0.75f;
+	inputStates[1].HandTrigger[::ovrHand_Right] = 0.25f;
+	inputStates[1].Thumbstick[::ovrHand_Right].x = 0.5f;
+
+	uint32_t i = 0;
+	while( state.keepRunning() ) {
+		ctrl.inputState( inputStates[i & 1] );
+		++i;
+	}
+}
+BENCHMARK( BM_OculusProcessInputState );
+#endif
+
+// -------------------------------------------------------------------------------------------------
+// Trigger and axis signal emission
+// -------------------------------------------------------------------------------------------------
+static void BM_TriggerSetValue( benchmark::State& state )
+{
+	BenchController ctrl( ci::vr::Controller::TYPE_LEFT, sVrContext );
+	uint64_t count = 0;
+	auto conn = sVrContext->getSignalControllerTrigger().connect( [&count]( const ci::vr::Controller::Trigger* ) { ++count; } );
+
+	uint32_t i = 0;
+	while( state.keepRunning() ) {
+		ctrl.setTrigger( static_cast<float>( i & 0xFF ) / 255.0f );
+		++i;
+	}
+	benchmark::doNotOptimize( count );
+	conn.disconnect();
+}
+BENCHMARK( BM_TriggerSetValue );
+
+static void BM_AxisSetValue( benchmark::State& state )
+{
+	BenchController ctrl( ci::vr::Controller::TYPE_LEFT, sVrContext );
+	uint64_t count = 0;
+	auto conn = sVrContext->getSignalControllerAxis().connect( [&count]( const ci::vr::Controller::Axis* ) { ++count; } );
+
+	uint32_t i = 0;
+	while( state.keepRunning() ) {
+		float t = static_cast<float>( i & 0xFF ) / 255.0f;
+		ctrl.setAxis( ci::vec2( t, 1.0f - t ) );
+		++i;
+	}
+	benchmark::doNotOptimize( count );
+	conn.disconnect();
+}
+BENCHMARK( BM_AxisSetValue );
+
+// A held trigger with sensor noise, polled four times per frame, signalled immediately and
+// through the event queue with a change threshold
+static const uint32_t kTriggerPollsPerFrame = 4;
+
+static float heldTriggerValue( uint32_t poll )
+{
+	return 0.5f + 0.001f * static_cast<float>( ( poll * 7 ) % 5 );
+}
+
+static void BM_TriggerHeldImmediate( benchmark::State& state )
+{
+	BenchController ctrl( ci::vr::Controller::TYPE_LEFT, sVrContext );
+	uint64_t count = 0;
+	auto conn = sVrContext->getSignalControllerTrigger().connect( [&count]( const ci::vr::Controller::Trigger* ) { ++count; } );
+
+	uint32_t poll = 0;
+	while( state.keepRunning() ) {
+		for( uint32_t i = 0; i < kTriggerPollsPerFrame; ++i ) {
+			ctrl.setTrigger( heldTriggerValue( poll++ ) );
+		}
+	}
+	benchmark::doNotOptimize( count );
+	conn.disconnect();
+}
+BENCHMARK( BM_TriggerHeldImmediate );
+
+static void BM_TriggerHeldQueued( benchmark::State& state )
+{
+	BenchController ctrl( ci::vr::Controller::TYPE_LEFT, sVrContext );
+	uint64_t count = 0;
+	auto conn = sVrContext->getSignalControllerTrigger().connect( [&count]( const ci::vr::Controller::Trigger* ) { ++count; } );
+
+	ci::vr::ControllerEventQueueRef queue = ci::vr::ControllerEventQueue::create();
+	queue->setDefaultTriggerPolicy( ci::vr::ControllerEventQueue::Policy( 0.02f, 0.01f ) );
+	ci::vr::Controller::Trigger* trigger = ctrl.getTrigger( ci::vr::Controller::TRIGGER_1 );
+
+	uint32_t poll = 0;
+	while( state.keepRunning() ) {
+		for( uint32_t i = 0; i < kTriggerPollsPerFrame; ++i ) {
+			queue->pushTrigger( trigger, heldTriggerValue( poll++ ) );
+		}
+		queue->dispatch();
+	}
+	benchmark::doNotOptimize( count );
+	conn.disconnect();
+}
+BENCHMARK( BM_TriggerHeldQueued );
+
+// -------------------------------------------------------------------------------------------------
+// CameraEye matrix updates
+// -------------------------------------------------------------------------------------------------
+static void BM_CameraEyeViewMatrix( benchmark::State& state )
+{
+	ci::Rand rnd( 2 );
+	ci::mat4 hmdMatrices[16];
+	for( auto& m : hmdMatrices ) {
+		m = glm::affineInverse( randPoseMatrix( rnd ) );
+	}
+
+	ci::vr::CameraEye cam( ci::vr::EYE_LEFT );
+	cam.setViewMatrix( glm::translate( ci::vec3( 0.032f, 0, 0 ) ) );
+
+	uint32_t i = 0;
+	while( state.keepRunning() ) {
+		cam.setHmdMatrix( hmdMatrices[i & 15] );
+		benchmark::doNotOptimize( cam.getViewMatrix() );
+		++i;
+	}
+}
+BENCHMARK( BM_CameraEyeViewMatrix );
+
+static void BM_CameraEyeInverseView( benchmark::State& state )
+{
+	ci::Rand rnd( 3 );
+	ci::mat4 hmdMatrices[16];
+	for( auto& m : hmdMatrices ) {
+		m = glm::affineInverse( randPoseMatrix( rnd ) );
+	}
+
+	ci::vr::CameraEye cam( ci::vr::EYE_LEFT );
+	cam.setViewMatrix( glm::translate( ci::vec3( 0.032f, 0, 0 ) ) );
+
+	uint32_t i = 0;
+	while( state.keepRunning() ) {
+		cam.setHmdMatrix( hmdMatrices[i & 15] );
+		benchmark::doNotOptimize( cam.getInverseViewMatrix() );
+		++i;
+	}
+}
+BENCHMARK( BM_CameraEyeInverseView );
+
+// -------------------------------------------------------------------------------------------------
+// Pose prediction, as done per tracked device when querying poses at display time
+// -------------------------------------------------------------------------------------------------
+static void BM_TrackedPoseExtrapolate( benchmark::State& state )
+{
+	ci::Rand rnd( 4 );
+	ci::vr::TrackedPose poses[16];
+	for( auto& pose : poses ) {
+		pose.set( randPoseMatrix( rnd ), rnd.nextVec3() * 0.5f, rnd.nextVec3() * 3.0f, 0.0 );
+	}
+
+	uint32_t i = 0;
+	while( state.keepRunning() ) {
+		benchmark::doNotOptimize( poses[i & 15].extrapolate( 0.011 ) );
+		++i;
+	}
+}
+BENCHMARK( BM_TrackedPoseExtrapolate );
+
+// -------------------------------------------------------------------------------------------------
+// Library overhead of one frame on the simulated HMD with an empty scene
+// -------------------------------------------------------------------------------------------------
+static void BM_SimulatedFrame( benchmark::State& state )
+{
+	ci::vr::Hmd* hmd = sVrContext->getHmd();
+	while( state.keepRunning() ) {
+		hmd->bind();
+		for( auto eye : hmd->getEyes() ) {
+			hmd->enableEye( eye );
+			hmd->drawControllers( eye );
+		}
+		hmd->unbind();
+		hmd->submitFrame();
+	}
+}
+BENCHMARK( BM_SimulatedFrame );
+
+// -------------------------------------------------------------------------------------------------
+// Nearest-hit input ray queries against a scene of interactive objects, as the samples' linear
+// UiIntersectable scan and as a RayQuery
+// -------------------------------------------------------------------------------------------------
+static const uint32_t kRayQueryNumColliders = 4096;
+static const uint32_t kRayQueryNumRays = 1024;
+
+static ci::vr::RayQueryRef randRayQueryScene( ci::Rand& rnd, std::vector<ci::vr::RayQuery::ColliderId> *outColliders = nullptr )
+{
+	ci::vr::RayQueryRef result = ci::vr::RayQuery::create();
+	for( uint32_t i = 0; i < kRayQueryNumColliders; ++i ) {
+		const ci::vec3 center = ci::vec3( rnd.randFloat( -20.0f, 20.0f ), rnd.randFloat( 0.0f, 4.0f ), rnd.randFloat( -20.0f, 20.0f ) );
+		const float size = rnd.randFloat( 0.05f, 0.5f );
+		ci::vr::RayQuery::ColliderId collider = ( i & 1 )
+			? result->addSphere( ci::Sphere( center, size ) )
+			: result->addBox( ci::AxisAlignedBox( center - ci::vec3( size ), center + ci::vec3( size ) ) );
+		if( nullptr != outColliders ) {
+			outColliders->push_back( collider );
+		}
+	}
+	result->update();
+	return result;
+}
+
+static std::vector<ci::Ray> randInputRays( ci::Rand& rnd, uint32_t count )
+{
+	std::vector<ci::Ray> result;
+	for( uint32_t i = 0; i < count; ++i ) {
+		result.push_back( ci::Ray( ci::vec3( rnd.randFloat( -1.0f, 1.0f ), 1.6f, rnd.randFloat( -1.0f, 1.0f ) ), rnd.randVec3() ) );
+	}
+	return result;
+}
+
+static void BM_RayQueryLinear( benchmark::State& state )
+{
+	ci::Rand rnd( 11 );
+	ci::vr::RayQueryRef query = randRayQueryScene( rnd );
+	std::vector<ci::Ray> rays = randInputRays( rnd, 3 );
+	while( state.keepRunning() ) {
+		for( const auto& ray : rays ) {
+			benchmark::doNotOptimize( query->queryNearestLinear( ray ) );
+		}
+	}
+	state.setItemsProcessed( state.getIterations() * rays.size() );
+}
+BENCHMARK( BM_RayQueryLinear );
+
+static void BM_RayQueryBvh( benchmark::State& state )
+{
+	ci::Rand rnd( 11 );
+	ci::vr::RayQueryRef query = randRayQueryScene( rnd );
+	std::vector<ci::Ray> rays = randInputRays( rnd, 3 );
+	std::vector<ci::vr::RayQuery::Hit> hits( rays.size() );
+	while( state.keepRunning() ) {
+		query->queryNearest( rays.data(), rays.size(), hits.data() );
+		benchmark::doNotOptimize( hits[0] );
+	}
+	state.setItemsProcessed( state.getIterations() * rays.size() );
+}
+BENCHMARK( BM_RayQueryBvh );
+
+static void BM_RayQueryBvhBatch( benchmark::State& state )
+{
+	ci::Rand rnd( 11 );
+	ci::vr::RayQueryRef query = randRayQueryScene( rnd );
+	std::vector<ci::Ray> rays = randInputRays( rnd, kRayQueryNumRays );
+	std::vector<ci::vr::RayQuery::Hit> hits( rays.size() );
+	while( state.keepRunning() ) {
+		query->queryNearest( rays.data(), rays.size(), hits.data() );
+		benchmark::doNotOptimize( hits[0] );
+	}
+	state.setItemsProcessed( state.getIterations() * rays.size() );
+}
+BENCHMARK( BM_RayQueryBvhBatch );
+
+// One in twenty objects moves every frame
+static void BM_RayQueryBvhRefit( benchmark::State& state )
+{
+	ci::Rand rnd( 11 );
+	std::vector<ci::vr::RayQuery::ColliderId> colliders;
+	ci::vr::RayQueryRef query = randRayQueryScene( rnd, &colliders );
+	std::vector<ci::Ray> rays = randInputRays( rnd, 3 );
+	std::vector<ci::vr::RayQuery::Hit> hits( rays.size() );
+	while( state.keepRunning() ) {
+		for( size_t i = 1; i < colliders.size(); i += 20 ) {
+			const ci::vec3 center = ci::vec3( rnd.randFloat( -20.0f, 20.0f ), rnd.randFloat( 0.0f, 4.0f ), rnd.randFloat( -20.0f, 20.0f ) );
+			query->setSphere( colliders[i], ci::Sphere( center, 0.25f ) );
+		}
+		query->queryNearest( rays.data(), rays.size(), hits.data() );
+		benchmark::doNotOptimize( hits[0] );
+	}
+	state.setItemsProcessed( state.getIterations() * rays.size() );
+}
+BENCHMARK( BM_RayQueryBvhRefit );
+
+// -------------------------------------------------------------------------------------------------
+// Input sample ring
+// -------------------------------------------------------------------------------------------------
+// About one 90 Hz frame of 1000 Hz polling for two hands, pushed and drained on one thread to
+// measure the ring's cost without scheduling noise
+static const uint32_t kInputSamplesPerFrame = 24;
+
+static void BM_InputRingFrame( benchmark::State& state )
+{
+	ci::vr::SpscRing<ci::vr::InputSample> ring( 512 );
+	ci::vr::InputSample sample = ci::vr::InputSample();
+	std::vector<ci::vr::InputSample> drained;
+	drained.reserve( kInputSamplesPerFrame );
+
+	while( state.keepRunning() ) {
+		for( uint32_t i = 0; i < kInputSamplesPerFrame; ++i ) {
+			sample.time = static_cast<double>( i ) * 0.001;
+			sample.triggers[0] = static_cast<float>( i ) / static_cast<float>( kInputSamplesPerFrame );
+			ring.push( sample );
+		}
+		drained.clear();
+		while( ring.pop( &sample ) ) {
+			drained.push_back( sample );
+		}
+		benchmark::doNotOptimize( drained.data() );
+	}
+}
+BENCHMARK( BM_InputRingFrame );
+
+// -------------------------------------------------------------------------------------------------
+// PosePipelineApp
+// -------------------------------------------------------------------------------------------------
+class PosePipelineApp : public App {
+public:
+	void setup() override;
+	void update() override;
+	void draw() override;
+
+private:
+	std::string							mFilter;
+	fs::path							mOutputPath;
+	std::vector<benchmark::Result>		mResults;
+	bool								mDone = false;
+};
+
+void PosePipelineApp::setup()
+{
+	// Arguments follow Google Benchmark: --benchmark_filter=<substring> --benchmark_out=<file>
+	mOutputPath = getAppPath() / "PosePipeline.json";
+	for( const auto& arg : getCommandLineArgs() ) {
+		if( 0 == arg.find( "--benchmark_filter=" ) ) {
+			mFilter = arg.substr( std::string( "--benchmark_filter=" ).size() );
+		}
+		else if( 0 == arg.find( "--benchmark_out=" ) ) {
+			mOutputPath = arg.substr( std::string( "--benchmark_out=" ).size() );
+		}
+	}
+
+	try {
+		// Unthrottled so the compositor doesn't sleep on vsync
+		auto options = ci::vr::simulated::DeviceManager::Options().setThrottled( false ).setMotionEnabled( true );
+		ci::vr::registerDevice( ci::vr::API_SIMULATED, new ci::vr::simulated::DeviceManager( nullptr, options ), true );
+		sVrContext = ci::vr::beginSession( ci::vr::SessionOptions(), ci::vr::API_SIMULATED );
+	}
+	catch( const std::exception& e ) {
+		CI_LOG_E( "Session failed: " << e.what() );
+		quit();
+	}
+}
+
+void PosePipelineApp::update()
+{
+	if( mDone || ( nullptr == sVrContext ) ) {
+		return;
+	}
+
+	mResults = benchmark::runBenchmarks( mFilter );
+	for( const auto& result : mResults ) {
+		CI_LOG_I( result.name << ": " << result.nsPerIteration << " ns (" << result.iterations << " iterations)" );
+	}
+
+	std::ofstream os( mOutputPath.string().c_str() );
+	os << benchmark::toJson( mResults );
+	CI_LOG_I( "Results written to " << mOutputPath );
+
+	mDone = true;
+	quit();
+}
+
+void PosePipelineApp::draw()
+{
+	gl::clear( Color( 0.02f, 0.02f, 0.1f ) );
+}
+
+void prepareSettings( App::Settings *settings )
+{
+	settings->setTitle( "Cinder VR Pose Pipeline Benchmark" );
+	settings->setWindowSize( 1920/2, 1080/2 );
+}
+
+CINDER_APP( PosePipelineApp, RendererGl( RendererGl::Options().msaa(0) ), prepareSettings )
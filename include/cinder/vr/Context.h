@@ -39,6 +39,11 @@
 #pragma once
 
 #include "cinder/vr/Controller.h"
+#include "cinder/vr/ControllerEventQueue.h"
+#include "cinder/vr/InputThread.h"
+#include "cinder/vr/PoseStore.h"
+#include "cinder/vr/QualityGovernor.h"
+#include "cinder/vr/Recording.h"
 #include "cinder/vr/SessionOptions.h"
 #include "cinder/Signals.h"
 #include "cinder/Surface.h"
@@ -91,6 +96,9 @@ public:
 
 	ci::gl::Texture2dRef					getControllerIconTexture( ci::vr::Controller::Type type ) const;
 
+	//! Poses of all tracked devices, refreshed once per frame by the backend
+	const ci::vr::PoseStore&				getPoseStore() const { return mPoseStore; }
+
 	ci::vr::SignalControllerConnected&		getSignalControllerConnected() { return mSignalControllerConnected; }
 	ci::vr::SignalControllerDisconnected&	getSignalControllerDisconnected() { return mSignalControllerDisconnected; }
 	ci::vr::SignalControllerInput&			getSignalController() { return mSignalControllerInput; }
@@ -98,6 +106,22 @@ public:
 	ci::vr::SignalControllerButton&			getSignalControllerButtonUp() { return mSignalControllerButtonUp; }
 	ci::vr::SignalControllerTrigger&		getSignalControllerTrigger() { return mSignalControllerTrigger; }
 	ci::vr::SignalControllerAxis&			getSignalControllerAxis() { return mSignalControllerAxis; }
+	//! Null unless SessionOptions::setControllerEventQueue() is set, controller signals are then emitted in one pass per update()
+	ci::vr::ControllerEventQueue*			getControllerEventQueue() const { return mControllerEventQueue.get(); }
+
+	//! Controller input read by the input thread and drained by the last update(), oldest first.
+	//! Empty unless SessionOptions::setInputPollRate() is set and the backend supports polling.
+	const std::vector<ci::vr::InputSample>&	getInputSamples() const { return mInputSamples; }
+	bool									isInputThreadRunning() const { return mInputThread ? true : false; }
+
+	//! Records HMD and controller poses plus controller input once per update() to \a path.
+	void									startRecording( const ci::fs::path& path );
+	void									stopRecording();
+	bool									isRecording() const { return mRecorder ? true : false; }
+	const ci::vr::RecorderRef&				getRecorder() const { return mRecorder; }
+
+	//! App-registered quality knobs, stepped from the compositor's frame stats once per submitted frame
+	ci::vr::QualityGovernor*				getQualityGovernor() const { return mQualityGovernor.get(); }
 
 protected:
 	Context( const ci::vr::SessionOptions& sessionOptions, ci::vr::DeviceManager* deviceManager );
@@ -108,6 +132,17 @@ protected:
 
 	virtual void							update();
 	virtual void							processEvents() = 0;
+	//! Reads the state of every active controller once, called after processEvents at the session's input sample interval
+	virtual void							sampleInput() {}
+	//! Called on the input thread at the session's poll rate, backends read the runtime's controller
+	//! state here and hand it to sampleInput() through a ring. Must not touch mControllers.
+	virtual void							pollInput( double time ) {}
+	//! Backends call these at the end of beginSession() and at the start of endSession(), the thread
+	//! must be stopped before anything pollInput() reads is destroyed
+	void									startInputThread();
+	void									stopInputThread();
+	//! Fills the budget and the GPU time measured by the Hmd, backends with compositor stats override it
+	virtual void							updateFrameStats( ci::vr::QualityGovernor::FrameStats* stats );
 		
 	void									addController( const ci::vr::ControllerRef& controller );
 	void									removeController( const ci::vr::ControllerRef& controller );
@@ -116,6 +151,10 @@ protected:
 	ci::vr::HmdRef							mHmd;
 	std::vector<ci::vr::ControllerRef>		mControllers;
 	double									mPrevControllersScanTime = 0;
+	double									mPrevInputSampleTime = 0;
+	//! Number of controller state publishes, one per update(). Stamped into ControllerState::frame.
+	uint64_t								mPublishSequence = 0;
+	ci::vr::PoseStore						mPoseStore;
 
 	std::map<ci::vr::Controller::Type, ci::gl::Texture2dRef>	mControllerIconTextures;
 	
@@ -126,6 +165,15 @@ protected:
 	ci::vr::SignalControllerButton			mSignalControllerButtonUp;
 	ci::vr::SignalControllerTrigger			mSignalControllerTrigger;
 	ci::vr::SignalControllerAxis			mSignalControllerAxis;
+	ci::vr::ControllerEventQueueRef			mControllerEventQueue;
+	ci::vr::InputThreadRef					mInputThread;
+	std::vector<ci::vr::InputSample>		mInputSamples;
+
+	ci::vr::RecorderRef						mRecorder;
+	double									mRecordingStartTime = 0;
+
+	ci::vr::QualityGovernorRef				mQualityGovernor;
+	uint64_t								mPrevGovernedFrame = 0;
 
 private:
 	ci::vr::DeviceManager*					mDeviceManager = nullptr;
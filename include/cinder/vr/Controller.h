@@ -46,6 +46,9 @@
 namespace cinder { namespace vr {
 
 class Context;
+class ControllerEventQueue;
+class ControllerStateBuffer;
+using ControllerStateBufferRef = std::shared_ptr<ControllerStateBuffer>;
 
 //! \class Controller
 //!
@@ -210,10 +213,16 @@ public:
 	class Axis;
 	class Button;
 	class Trigger;
+	//! Deprecated, inputs are owned by their controller. These don't extend the input's lifetime.
 	using AxisRef = std::shared_ptr<Axis>;
 	using ButtonRef = std::shared_ptr<Button>;
 	using TriggerRef = std::shared_ptr<Trigger>;
 
+	//! Inputs live inline in the controller, one slot per bit of their id
+	static const uint32_t				kMaxButtons = 32;
+	static const uint32_t				kMaxTriggers = 8;
+	static const uint32_t				kMaxAxes = 8;
+
 	// ---------------------------------------------------------------------------------------------
 
 	//! \class ActionState
@@ -236,6 +245,7 @@ public:
 	class Button : public ActionState {
 	public:
 		virtual ~Button() {}
+		//! Deprecated, registers \a id on \a controller like addButton() and returns the controller's input
 		static ButtonRef				create( ci::vr::Controller::ButtonId id, ci::vr::Controller *controller );
 		ci::vr::Controller::ButtonId	getId() const { return mId; }
 		ci::vr::Controller::State		getState() const { return mState; }
@@ -243,9 +253,12 @@ public:
 		bool							isUp() const { return ci::vr::Controller::STATE_UP == mState; }
 		std::string						getInfo() const;
 	private:
+		Button()
+			: ActionState( nullptr ) {}
 		Button( ci::vr::Controller::ButtonId id, ci::vr::Controller *controller ) 
 			: ActionState( controller ), mId( id ) {}
 		friend class Controller;
+		friend class ci::vr::ControllerEventQueue;
 		ci::vr::Controller::ButtonId	mId = ci::vr::Controller::BUTTON_UNKNOWN;
 		ci::vr::Controller::State		mState = ci::vr::Controller::STATE_UNKNOWN;
 		void							setState( ci::vr::Controller::State state );
@@ -257,19 +270,27 @@ public:
 	class Trigger : public ActionState {
 	public:
 		virtual ~Trigger() {}
+		//! Deprecated, registers \a id on \a controller like addTrigger() and returns the controller's input
 		static TriggerRef				create( ci::vr::Controller::TriggerId id, ci::vr::Controller *controller, float minLim = 0.0f, float maxLim = 1.0f );
 		ci::vr::Controller::TriggerId	getId() const { return mId; }
 		float							getValue() const { return mValue; }
 		std::string						getInfo() const;
+		//! Maps a raw value from the trigger's limits to [0, 1]
+		float							normalize( float value ) const;
 	private:
+		Trigger()
+			: ActionState( nullptr ) {}
 		Trigger( ci::vr::Controller::TriggerId id, ci::vr::Controller *controller, float minLim, float maxLim )
 			: ActionState( controller ), mId( id ), mMinLimit( minLim ), mMaxLimit( maxLim ) {}
 		friend class Controller;
+		friend class ci::vr::ControllerEventQueue;
 		ci::vr::Controller::TriggerId	mId = ci::vr::Controller::TRIGGER_UNKNOWN;
 		float							mValue = 0.0f;
 		float							mMinLimit = 0.0f;
 		float							mMaxLimit = 0.0f;
 		void							setValue( float value );
+		//! Stores and emits \a value, already normalized
+		void							setNormalizedValue( float value );
 	};
 
 	//! \class Axis
@@ -278,14 +299,18 @@ public:
 	class Axis : public ActionState {
 	public:
 		virtual ~Axis() {}
+		//! Deprecated, registers \a id on \a controller like addAxis() and returns the controller's input
 		static AxisRef					create( ci::vr::Controller::AxisId id, ci::vr::Controller *controller );
 		ci::vr::Controller::AxisId		getId() const { return mId; }
 		const ci::vec2&					getValue() const { return mValue; }
 		std::string						getInfo() const;
 	private:
+		Axis()
+			: ActionState( nullptr ) {}
 		Axis( ci::vr::Controller::AxisId id, ci::vr::Controller *controller )
 			: ActionState( controller ), mId( id ) {}
 		friend class Controller;
+		friend class ci::vr::ControllerEventQueue;
 		ci::vr::Controller::AxisId		mId = ci::vr::Controller::AXIS_UNKNOWN;
 		ci::vec2						mValue = ci::vec2( 0.0f );
 		void							setValue( const ci::vec2 &value );
@@ -313,22 +338,56 @@ public:
 	virtual ci::vr::Controller::Axis*			getAxis( ci::vr::Controller::AxisId id = ci::vr::Controller::AXIS_ANY );
 	virtual const ci::vr::Controller::Axis*		getAxis( ci::vr::Controller::AxisId id = ci::vr::Controller::AXIS_ANY ) const;
 
+	//! Ids of the inputs this controller has, OR'd together
+	uint32_t							getButtonMask() const { return mButtonMask; }
+	uint32_t							getTriggerMask() const { return mTriggerMask; }
+	uint32_t							getAxisMask() const { return mAxisMask; }
+	//! Ids of the buttons that are down, two controllers hold the same buttons when these compare equal
+	uint32_t							getButtonsDown() const { return mButtonsDown; }
+	//! Ids of the buttons whose state is known, down or up
+	uint32_t							getButtonsKnown() const { return mButtonsKnown; }
+
+	//! Snapshots published once per Context::update(), readable from any thread. See ControllerState.h.
+	const ci::vr::ControllerStateBufferRef&	getStateBuffer() const { return mStateBuffer; }
 
 	const ci::mat4&						getDeviceToTrackingMatrix() const { return mDeviceToTrackingMatrix; }
 	const ci::mat4&						getTrackingToDeviceMatrix() const { return mTrackingToDeviceMatrix; }
 
+	//! Index of this controller's pose in Hmd::getTrackedPose(), UINT32_MAX when the controller isn't tracked
+	uint32_t							getTrackedDeviceIndex() const { return mTrackedDeviceIndex; }
+	//! Pose extrapolated to the HMD's predicted display time
+	ci::mat4							getPredictedDeviceToTrackingMatrix() const;
+	//! Pose extrapolated to \a targetTime, in the time base of Hmd::getTimeInSeconds()
+	ci::mat4							getPredictedDeviceToTrackingMatrix( double targetTime ) const;
+
 	virtual bool						hasInputRay() const { return false; }
 	const ci::Ray&						getInputRay() const { return mInputRay; }
 
 protected:
 	Controller( ci::vr::Controller::Type type, ci::vr::Context *context );
 	
-	std::vector<ButtonRef>				mButtons;
-	std::vector<TriggerRef>				mTriggers;
-	std::vector<AxisRef>				mAxes;
+	// Slot i holds the input with id 1 << i when bit i of the matching mask is set
+	ci::vr::Controller::Button			mButtons[kMaxButtons];
+	ci::vr::Controller::Trigger			mTriggers[kMaxTriggers];
+	ci::vr::Controller::Axis			mAxes[kMaxAxes];
+	uint32_t							mButtonMask = 0;
+	uint32_t							mTriggerMask = 0;
+	uint32_t							mAxisMask = 0;
+	uint32_t							mButtonsDown = 0;
+	uint32_t							mButtonsKnown = 0;
+	// Edges since the last published state
+	uint32_t							mButtonsPressed = 0;
+	uint32_t							mButtonsReleased = 0;
 	ci::mat4							mDeviceToTrackingMatrix;
 	ci::mat4							mTrackingToDeviceMatrix;
 	ci::Ray								mInputRay = ci::Ray( ci::vec3( 0 ), ci::vec3( 0 ) );
+	uint32_t							mTrackedDeviceIndex = UINT32_MAX;
+
+	//! Adds the input to its slot, throws if \a id isn't a single bit within the slot count. Adding an
+	//! id twice returns the existing input.
+	ci::vr::Controller::Button*			addButton( ci::vr::Controller::ButtonId id );
+	ci::vr::Controller::Trigger*		addTrigger( ci::vr::Controller::TriggerId id, float minLim = 0.0f, float maxLim = 1.0f );
+	ci::vr::Controller::Axis*			addAxis( ci::vr::Controller::AxisId id );
 
 	void								setButtonState( ci::vr::Controller::Button *button, ci::vr::Controller::State state );
 	void								setTriggerValue( ci::vr::Controller::Trigger *trigger, float value );
@@ -337,6 +396,10 @@ protected:
 private:
 	ci::vr::Context						*mContext = nullptr;
 	ci::vr::Controller::Type			mType =	ci::vr::Controller::TYPE_UNKNOWN;
+	ci::vr::ControllerStateBufferRef	mStateBuffer;
+
+	friend class ci::vr::Context;
+	void								publishState( uint64_t frame, double time );
 };
 
 }} // namespace cinder::vr
\ No newline at end of file
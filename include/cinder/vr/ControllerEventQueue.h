@@ -0,0 +1,131 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Controller.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace cinder { namespace vr {
+
+class ControllerEventQueue;
+using ControllerEventQueueRef = std::shared_ptr<ControllerEventQueue>;
+
+//! \class ControllerEventQueue
+//!
+//! Defers controller input changes to a single dispatch pass. Backends queue button, trigger and
+//! axis updates while they poll. Repeated updates to a trigger or axis collapse into the latest
+//! value, and button updates that don't change the state are dropped. Button transitions are
+//! kept in order, so a tap shorter than a frame still emits down and then up. At dispatch each
+//! trigger and axis value goes through its Policy. Unlike immediate mode, a trigger held at a
+//! constant value doesn't signal every frame. Enabled with SessionOptions::setControllerEventQueue(),
+//! the Context then dispatches once per update() right after input is sampled.
+//!
+class ControllerEventQueue {
+public:
+
+	//! Normalized units, trigger values or axis lengths
+	struct Policy {
+		//! Values below the dead zone are delivered as 0
+		float	deadZone = 0.0f;
+		//! Smallest change from the last delivered value that's delivered. Returns to 0, and
+		//! triggers reaching 1, are always delivered.
+		float	threshold = 0.0f;
+
+		Policy() {}
+		Policy( float aDeadZone, float aThreshold )
+			: deadZone( aDeadZone ), threshold( aThreshold ) {}
+	};
+
+	virtual ~ControllerEventQueue();
+
+	static ControllerEventQueueRef		create();
+
+	const Policy&						getDefaultTriggerPolicy() const { return mDefaultTriggerPolicy; }
+	void								setDefaultTriggerPolicy( const Policy& policy ) { mDefaultTriggerPolicy = policy; }
+	const Policy&						getDefaultAxisPolicy() const { return mDefaultAxisPolicy; }
+	void								setDefaultAxisPolicy( const Policy& policy ) { mDefaultAxisPolicy = policy; }
+	//! Policies are keyed by controller type so they survive reconnects
+	void								setTriggerPolicy( ci::vr::Controller::Type type, ci::vr::Controller::TriggerId id, const Policy& policy );
+	void								setAxisPolicy( ci::vr::Controller::Type type, ci::vr::Controller::AxisId id, const Policy& policy );
+	void								clearPolicies();
+
+	void								pushButton( ci::vr::Controller::Button *button, ci::vr::Controller::State state );
+	//! \a value is the raw value, before the trigger's limits are applied
+	void								pushTrigger( ci::vr::Controller::Trigger *trigger, float value );
+	void								pushAxis( ci::vr::Controller::Axis *axis, const ci::vec2& value );
+
+	//! Applies the pending events and emits their signals, in the order each input was first queued
+	void								dispatch();
+	//! Drops the pending events of \a controller, called when it's removed from the Context
+	void								discard( const ci::vr::Controller *controller );
+	size_t								getNumPending() const { return mEvents.size(); }
+
+private:
+	ControllerEventQueue();
+
+	enum Kind {
+		KIND_BUTTON,
+		KIND_TRIGGER,
+		KIND_AXIS,
+	};
+
+	struct Event {
+		Kind								kind;
+		ci::vr::Controller::ActionState		*input;
+		ci::vr::Controller::State			state;
+		float								value[2];
+	};
+
+	Policy								mDefaultTriggerPolicy;
+	Policy								mDefaultAxisPolicy;
+	std::map<uint64_t, Policy>			mTriggerPolicies;
+	std::map<uint64_t, Policy>			mAxisPolicies;
+	std::vector<Event>					mEvents;
+	// Events taken out of the queue by dispatch(), kept for their capacity
+	std::vector<Event>					mDispatching;
+
+	const Policy&						getPolicy( const std::map<uint64_t, Policy>& policies, const Policy& defaultPolicy, const ci::vr::Controller *controller, uint32_t id ) const;
+	// Index of the latest pending event for \a input, or -1
+	int									findPending( const ci::vr::Controller::ActionState *input ) const;
+};
+
+}} // namespace cinder::vr
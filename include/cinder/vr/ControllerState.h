@@ -0,0 +1,115 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Controller.h"
+
+#include <atomic>
+#include <memory>
+
+namespace cinder { namespace vr {
+
+class ControllerStateBuffer;
+using ControllerStateBufferRef = std::shared_ptr<ControllerStateBuffer>;
+
+//! Snapshot of one controller's input and pose, published once per Context::update(). Plain
+//! data, copy it freely.
+struct ControllerState {
+	//! Context::update() count when the state was published, 0 before the first publish
+	uint64_t	frame;
+	//! Seconds, in the time base of ci::app::getElapsedSeconds()
+	double		time;
+	uint32_t	type;
+	//! Ids of the inputs present on the controller
+	uint32_t	buttonMask;
+	uint32_t	triggerMask;
+	uint32_t	axisMask;
+	uint32_t	buttonsDown;
+	//! Buttons that went down or up since the previous state. A tap shorter than a frame sets
+	//! the button in both masks while leaving it up.
+	uint32_t	buttonsPressed;
+	uint32_t	buttonsReleased;
+	//! Indexed by bit position of TriggerId / AxisId
+	float		triggers[ci::vr::Controller::kMaxTriggers];
+	float		axes[ci::vr::Controller::kMaxAxes][2];
+	ci::mat4	deviceToTracking;
+
+	bool		isDown( ci::vr::Controller::ButtonId id ) const { return 0 != ( buttonsDown & id ); }
+	bool		wasPressed( ci::vr::Controller::ButtonId id ) const { return 0 != ( buttonsPressed & id ); }
+	bool		wasReleased( ci::vr::Controller::ButtonId id ) const { return 0 != ( buttonsReleased & id ); }
+};
+
+static_assert( 0 == ( sizeof( ControllerState ) % sizeof( uint32_t ) ), "ControllerState must be a whole number of words" );
+
+//! \class ControllerStateBuffer
+//!
+//! Latest ControllerState of one controller, published by the main thread and readable from any
+//! thread without locking. Two slots alternate so readers copy the slot the writer isn't
+//! filling and only retry if they're lapped by two publishes. Each Controller owns one, hold on
+//! to the buffer rather than the controller from other threads since controllers come and go
+//! on the main thread.
+//!
+class ControllerStateBuffer {
+public:
+	virtual ~ControllerStateBuffer();
+
+	static ControllerStateBufferRef		create();
+
+	//! Main thread only
+	void								publish( const ci::vr::ControllerState& state );
+	//! Any thread, returns false if nothing has been published yet
+	bool								read( ci::vr::ControllerState *outState ) const;
+	uint64_t							getNumPublished() const { return mNumPublished.load( std::memory_order_acquire ); }
+
+private:
+	ControllerStateBuffer();
+
+	static const uint32_t				kNumWords = sizeof( ControllerState ) / sizeof( uint32_t );
+
+	// Written with a sequence counter: odd while the main thread is filling the slot
+	struct Slot {
+		std::atomic<uint32_t>			mSequence;
+		std::atomic<uint32_t>			mWords[kNumWords];
+	};
+
+	Slot								mSlots[2];
+	std::atomic<uint64_t>				mNumPublished;
+};
+
+}} // namespace cinder::vr
@@ -0,0 +1,80 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Platform.h"
+
+namespace cinder { namespace vr {
+
+class DynamicResolution;
+using DynamicResolutionRef = std::shared_ptr<DynamicResolution>;
+
+//! \class DynamicResolution
+//!
+//! Picks the render scale for the next frame from measured GPU frame times. The scale is
+//! linear, pixel cost goes with its square. Drops quickly when over budget and climbs back
+//! slowly, the GPU timings lag a few frames behind the scale they were measured at.
+//!
+class DynamicResolution {
+public:
+	virtual ~DynamicResolution() {}
+
+	//! \a targetSeconds is the GPU time to aim for
+	static DynamicResolutionRef			create( float minScale, float maxScale, double targetSeconds );
+
+	float								getScale() const { return mScale; }
+	float								getMinScale() const { return mMinScale; }
+	float								getMaxScale() const { return mMaxScale; }
+	double								getTargetSeconds() const { return mTargetSeconds; }
+	void								setTargetSeconds( double seconds ) { mTargetSeconds = seconds; }
+
+	//! Feeds one GPU frame time, returns the new scale
+	float								update( double gpuSeconds );
+	void								reset() { mScale = mMaxScale; }
+
+private:
+	DynamicResolution( float minScale, float maxScale, double targetSeconds );
+
+	float								mMinScale = 1.0f;
+	float								mMaxScale = 1.0f;
+	double								mTargetSeconds = 0.0;
+	float								mScale = 1.0f;
+};
+
+}} // namespace cinder::vr
@@ -76,6 +76,7 @@ private:
 	std::vector<std::pair<ci::vr::ApiFlags, DeviceManagerStoreRef>>	mDeviceManagers;
 		
 	void registerDevice( ci::vr::ApiFlags deviceVendorId, ci::vr::DeviceManager* deviceManager, bool assumeOwnership );
+	bool isRegistered( ci::vr::ApiFlags deviceVendorId ) const;
 
 	// ---------------------------------------------------------------------------------------------
 	// Sessions 
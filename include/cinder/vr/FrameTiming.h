@@ -0,0 +1,158 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Platform.h"
+#include "cinder/Timer.h"
+
+#include <atomic>
+
+namespace cinder { namespace vr {
+
+class FrameTiming;
+using FrameTimingRef = std::shared_ptr<FrameTiming>;
+
+//! \class FrameTiming
+//!
+//! Per-phase CPU timings for the last kMaxFrames frames. Written by the render thread from the
+//! Hmd, readable from any thread without locking. A frame spans bind() through the end of
+//! submitFrame(). Eye phases run from enableEye() to the next enableEye() or unbind() so they
+//! include any drawControllers() call made for that eye. The compositor wait is nested in
+//! the submit phase on backends that block there, so is the CPU's wait on the GPU (see
+//! ci::vr::GpuSync) which can also land in the bind phase. PHASE_GPU_FRAME is GPU time from
+//! bind() to unbind(), it's recorded with the frame it became available in, a few frames late.
+//!
+class FrameTiming {
+public:
+
+	enum Phase {
+		PHASE_BIND = 0,
+		PHASE_EYE_LEFT,
+		PHASE_EYE_RIGHT,
+		PHASE_EYE_HMD,
+		PHASE_DRAW_CONTROLLERS,
+		PHASE_UNBIND,
+		PHASE_SUBMIT_FRAME,
+		PHASE_COMPOSITOR_WAIT,
+		PHASE_GPU_SYNC,
+		PHASE_GPU_FRAME,
+		PHASE_FRAME,
+		PHASE_COUNT
+	};
+
+	static const uint32_t kMaxFrames = 512;
+
+	//! Durations are in milliseconds
+	struct Stats {
+		uint32_t	numFrames = 0;
+		double		min = 0.0;
+		double		mean = 0.0;
+		double		p50 = 0.0;
+		double		p95 = 0.0;
+		double		p99 = 0.0;
+		double		max = 0.0;
+	};
+
+	//! \class ScopedPhase
+	//!
+	//!
+	class ScopedPhase {
+	public:
+		ScopedPhase( ci::vr::FrameTiming *frameTiming, ci::vr::FrameTiming::Phase phase );
+		~ScopedPhase();
+	private:
+		ci::vr::FrameTiming				*mFrameTiming = nullptr;
+		ci::vr::FrameTiming::Phase		mPhase = ci::vr::FrameTiming::PHASE_COUNT;
+	};
+
+	virtual ~FrameTiming();
+
+	static FrameTimingRef				create();
+
+	bool								isEnabled() const { return mEnabled; }
+	void								setEnabled( bool enabled ) { mEnabled = enabled; }
+
+	//! Seconds since the FrameTiming was created
+	double								getTimeInSeconds() const { return mTimer.getSeconds(); }
+
+	void								beginFrame();
+	void								endFrame();
+	void								beginPhase( ci::vr::FrameTiming::Phase phase );
+	void								endPhase( ci::vr::FrameTiming::Phase phase );
+	//! Closes the open eye phase, if any, and opens the one for \a eye
+	void								beginEye( ci::vr::Eye eye );
+	void								endEye();
+	//! Adds an externally measured duration (in seconds) to \a phase for the current frame
+	void								addPhaseDuration( ci::vr::FrameTiming::Phase phase, double seconds );
+
+	//! Total number of frames recorded
+	uint64_t							getNumFrames() const { return mNumFrames.load( std::memory_order_acquire ); }
+	//! Stats over the frames among the last \a numFrames that contain \a phase
+	Stats								getStats( ci::vr::FrameTiming::Phase phase, uint32_t numFrames = kMaxFrames ) const;
+	//! Duration (in milliseconds) of \a phase in the last recorded frame
+	double								getLastDuration( ci::vr::FrameTiming::Phase phase ) const;
+
+	static std::string					getPhaseName( ci::vr::FrameTiming::Phase phase );
+
+private:
+	FrameTiming();
+
+	// Written with a sequence counter: odd while the render thread is filling the slot
+	struct Slot {
+		std::atomic<uint32_t>			mSequence;
+		std::atomic<uint32_t>			mPhaseMask;
+		std::atomic<float>				mDurations[PHASE_COUNT];
+	};
+
+	bool								mEnabled = true;
+	ci::Timer							mTimer;
+
+	bool								mInFrame = false;
+	double								mPhaseStart[PHASE_COUNT];
+	double								mPhaseDuration[PHASE_COUNT];
+	uint32_t							mPhaseMask = 0;
+	ci::vr::FrameTiming::Phase			mEyePhase = PHASE_COUNT;
+
+	std::atomic<uint64_t>				mNumFrames;
+	Slot								mSlots[kMaxFrames];
+
+	bool								readSlot( uint64_t frame, uint32_t *outPhaseMask, float *outDurations ) const;
+};
+
+}} // namespace cinder::vr
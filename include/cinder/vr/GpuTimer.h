@@ -0,0 +1,77 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Platform.h"
+#include "cinder/gl/platform.h"
+
+#include <vector>
+
+namespace cinder { namespace vr {
+
+class GpuTimer;
+using GpuTimerRef = std::shared_ptr<GpuTimer>;
+
+//! \class GpuTimer
+//!
+//! GL_TIME_ELAPSED queries in a ring so reading a result never stalls. Results arrive a few
+//! frames after the work they measure.
+//!
+class GpuTimer {
+public:
+	virtual ~GpuTimer();
+
+	static GpuTimerRef					create( uint32_t numQueries = 4 );
+
+	//! Does nothing while all queries are still in flight
+	void								begin();
+	void								end();
+	//! Returns true and the newest finished duration (in seconds) if one became available since the last poll
+	bool								poll( double *outSeconds );
+
+private:
+	GpuTimer( uint32_t numQueries );
+
+	std::vector<GLuint>					mQueries;
+	uint32_t							mNumBegun = 0;
+	uint32_t							mNumPolled = 0;
+	bool								mActive = false;
+};
+
+}} // namespace cinder::vr
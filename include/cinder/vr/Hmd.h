@@ -39,10 +39,20 @@
 #pragma once
 
 #include "cinder/vr/Camera.h"
+#include "cinder/vr/DynamicResolution.h"
+#include "cinder/vr/FrameTiming.h"
+#include "cinder/vr/GpuTimer.h"
+#include "cinder/vr/MultiviewTarget.h"
+#include "cinder/vr/PoseStore.h"
+#include "cinder/vr/StereoFrustum.h"
+#include "cinder/gl/Batch.h"
+#include "cinder/gl/Fbo.h"
+#include "cinder/gl/Ubo.h"
 #include "cinder/Area.h"
 #include "cinder/Color.h"
 #include "cinder/Rect.h"
 
+#include <functional>
 #include <vector>
 
 namespace cinder { namespace vr {
@@ -91,16 +101,75 @@ public:
 
 	uint32_t							getElapsedFrames() const { return mElapsedFrames; }
 
+	//! Per-phase CPU timings of recent frames
+	ci::vr::FrameTiming*				getFrameTiming() const { return mFrameTiming.get(); }
+
+	//! Clock used for pose sample times and prediction targets
+	virtual double						getTimeInSeconds() const;
+	//! Time at which the frame currently being rendered is expected to reach the display
+	virtual double						getPredictedDisplayTime() const;
+
+	const ci::vr::PoseStore&			getPoseStore() const;
+	ci::vr::TrackedPose					getTrackedPose( uint32_t deviceIndex ) const;
+	//! Pose of \a deviceIndex extrapolated to getPredictedDisplayTime()
+	ci::mat4							getPredictedDeviceToTrackingMatrix( uint32_t deviceIndex ) const;
+	//! Pose of \a deviceIndex extrapolated to \a targetTime, in the time base of getTimeInSeconds()
+	ci::mat4							getPredictedDeviceToTrackingMatrix( uint32_t deviceIndex, double targetTime ) const;
+
 	virtual ci::ivec2					getRenderTargetSize() const { return mRenderTargetSize; }
 
+	//! Current render scale relative to the nominal render target size, see SessionOptions::setDynamicResolution()
+	float								getResolutionScale() const;
+	//! nullptr unless dynamic resolution is enabled and the backend supports it
+	ci::vr::DynamicResolution*			getDynamicResolution() const { return mDynamicResolution.get(); }
+
+	//! EYE_LEFT and EYE_RIGHT, or just EYE_STEREO with the single pass stereo modes
 	const std::vector<ci::vr::Eye>&		getEyes() const { return mEyes; }
+	//! EYE_STEREO is the same as enableStereo()
 	virtual	void						enableEye( ci::vr::Eye eye, ci::vr::CoordSys eyeMatrixMode = ci::vr::COORD_SYS_WORLD ) = 0;
 
+	//! Stereo mode in use, the requested one may have fallen back
+	ci::vr::StereoMode					getStereoMode() const { return mStereoMode; }
+	bool								isInstancedStereo() const { return ci::vr::STEREO_MODE_INSTANCED == mStereoMode; }
+	bool								isMultiviewStereo() const { return ci::vr::STEREO_MODE_MULTIVIEW == mStereoMode; }
+	//! Single pass stereo only. Binds both eyes, the side by side render target or all layers
+	//! of the multiview target, sets the regular matrices to the left eye's and fills the
+	//! ciVrStereo uniform block with both eyes' matrices. Shaders use getStereoShaderSource()
+	//! and are drawn with drawStereo().
+	void								enableStereo( ci::vr::CoordSys eyeMatrixMode = ci::vr::COORD_SYS_WORLD );
+	//! Draws \a instanceCount instances of \a batch for both eyes, ciVrStereoInstance() is the app's instance
+	void								drawStereo( const ci::gl::BatchRef& batch, GLsizei instanceCount = 1 );
+	//! GLSL for the current stereo mode to insert after the #version line of a vertex shader drawn
+	//! with drawStereo(). Write gl_Position = ciVrStereoPosition( ciModelMatrix * ciPosition ).
+	const std::string&					getStereoShaderSource() const;
+
+	//! Depth mask over the pixels the lenses hide, written after each eye is cleared. See SessionOptions::setHiddenAreaMask().
+	bool								hasHiddenAreaMask() const;
+	void								enableHiddenAreaMask( bool enabled = true ) { mHiddenAreaMask = enabled; }
+
+	//! Fixed foveation, set up from SessionOptions. Only applies to STEREO_MODE_MULTI_PASS.
+	bool								isFoveated() const;
+	void								enableFoveation( bool enabled = true ) { mFoveation = enabled; }
+	float								getFoveationRadius() const { return mFoveationRadius; }
+	float								getFoveationPeripheryScale() const { return mFoveationPeripheryScale; }
+	//! See SessionOptions::setFoveationRadius() and SessionOptions::setFoveationPeripheryScale()
+	void								setFoveation( float radius, float peripheryScale );
+	//! Full resolution centre of \a eye's viewport, around the point straight ahead of the eye
+	ci::Area							getFoveaViewport( ci::vr::Eye eye ) const;
+	//! Call after enableEye( \a eye ). Draws the whole eye into the periphery target at reduced
+	//! resolution, upsamples it into the eye's viewport, then draws the centre at full resolution
+	//! with the projection matrix narrowed to it. \a drawFn is called once per region, or once
+	//! with FOVEA_REGION_FULL when foveation is off. Shaders must use the current gl matrices.
+	void								drawFoveated( ci::vr::Eye eye, const std::function<void( ci::vr::FoveaRegion )>& drawFn );
+
 	const ci::vr::CameraEye&			getEyeCamera( ci::vr::Eye eye ) const;
 	ci::mat4							getEyeViewMatrix( ci::vr::Eye eye ) const;
 	ci::mat4							getEyeProjectionMatrix( ci::vr::Eye eye ) const;
 	ci::mat4							getEyeViewProjectionMatrix( ci::vr::Eye eye ) const;
 	virtual ci::Area					getEyeViewport( ci::vr::Eye eye ) const = 0;
+	//! Both eyes' frustums and one containing both, for the current eye matrices. Planes are in
+	//! the space \a coordSys, the same one passed to enableEye() or enableStereo().
+	ci::vr::StereoFrustum				getStereoFrustum( ci::vr::CoordSys coordSys = ci::vr::COORD_SYS_WORLD ) const;
 
 	////! Sets the look at position and target. Parameters are in world coordinate.
 	//virtual void						setLookAt( const ci::vec3 &position, const ci::vec3 &target, const ci::vec3& worldUp = ci::vec3( 0, 1, 0 ) );
@@ -134,6 +203,7 @@ protected:
 
 	uint32_t							mFirstValidPoseFrame = UINT32_MAX;
 	uint32_t							mElapsedFrames = 0;
+	ci::vr::FrameTimingRef				mFrameTiming;
 
 	ci::vec3							mOriginPosition = ci::vec3( 0, 0, 1 );
 	ci::vec3							mOriginViewDirection = ci::vec3( 0, 0, -1 );
@@ -160,6 +230,58 @@ protected:
 
 	ci::ColorA							mClearColor = ci::ColorA( 0, 0, 0, 0 );
 
+	// std140 layout of the ciVrStereo uniform block
+	struct StereoUniforms {
+		ci::mat4						viewProjection[ci::vr::EYE_COUNT];
+		ci::mat4						view[ci::vr::EYE_COUNT];
+		ci::mat4						projection[ci::vr::EYE_COUNT];
+	};
+	ci::gl::UboRef						mStereoUbo;
+	ci::vr::StereoMode					mStereoMode = ci::vr::STEREO_MODE_MULTI_PASS;
+	ci::vr::MultiviewTargetRef			mMultiviewTarget;
+
+	bool								mHiddenAreaMask = true;
+	ci::gl::GlslProgRef					mHiddenAreaShader;
+	ci::gl::BatchRef					mHiddenAreaBatch[ci::vr::EYE_COUNT];
+
+	bool								mFoveation = false;
+	float								mFoveationRadius = 0.5f;
+	float								mFoveationPeripheryScale = 0.5f;
+	ci::gl::FboRef						mFoveaPeripheryTarget;
+
+	ci::vr::GpuTimerRef					mGpuTimer;
+	ci::vr::DynamicResolutionRef		mDynamicResolution;
+
+	//! Times the GPU work between beginGpuFrame() and endGpuFrame()
+	void								setupGpuTiming();
+	//! Backends that can render to a sub-rectangle call this before allocating their render targets
+	void								setupDynamicResolution();
+	//! Scale to allocate render targets at, relative to the nominal size
+	float								getMaxResolutionScale() const;
+	//! Call from bind(), applies the latest GPU timing to the resolution scale
+	void								beginGpuFrame();
+	//! Call from unbind()
+	void								endGpuFrame();
+	//! Area of \a eye in a target of \a targetSize at the current resolution scale. Side by side
+	//! targets hold both eyes, the scaled eyes are packed from the left edge.
+	ci::Area							calcEyeViewport( ci::vr::Eye eye, const ci::ivec2& targetSize, bool sideBySide ) const;
+	//! Area drawn to in each multiview layer
+	ci::Area							getMultiviewViewport() const;
+
+	//! Backends call this once per eye from their render target setup, \a triangles are in the eye's NDC
+	void								setupHiddenAreaMask( ci::vr::Eye eye, const std::vector<ci::vec2>& triangles );
+	//! Writes \a eye's mask at the near plane into \a area of the bound framebuffer
+	void								drawHiddenAreaMask( ci::vr::Eye eye, const ci::Area& area );
+	//! Both eyes' masks into their halves or multiview layers, call after the single pass targets are cleared
+	void								drawStereoHiddenAreaMasks();
+
+	//! Backends call this from their render target setup with STEREO_MODE_MULTIVIEW
+	void								setupMultiviewTarget( const ci::ivec2& eyeSize, uint32_t samples );
+	//! Handles EYE_STEREO, and per eye drawing into the multiview layers. Returns false if \a eye is left to the backend.
+	bool								enableStereoEye( ci::vr::Eye eye, ci::vr::CoordSys eyeMatrixMode );
+	//! Calls \a drawFn with each eye's half or layer bound, then binds both eyes again
+	void								forEachStereoEye( const std::function<void( ci::vr::Eye )>& drawFn );
+
 	void								updateElapsedFrames();
 
 	virtual void						onClipValueChange( float nearClip, float farClip ) = 0;
@@ -0,0 +1,165 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Controller.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder { namespace vr {
+
+class InputThread;
+using InputThreadRef = std::shared_ptr<InputThread>;
+
+//! One reading of a controller's input taken by the input thread. Plain data, copy it freely.
+struct InputSample {
+	//! Seconds, in the time base of ci::app::getElapsedSeconds(), when the runtime was polled
+	double		time;
+	uint32_t	type;
+	uint32_t	buttonsDown;
+	//! Indexed by bit position of TriggerId / AxisId, triggers normalized like Trigger::getValue()
+	float		triggers[ci::vr::Controller::kMaxTriggers];
+	float		axes[ci::vr::Controller::kMaxAxes][2];
+
+	bool		isDown( ci::vr::Controller::ButtonId id ) const { return 0 != ( buttonsDown & id ); }
+};
+
+//! \class SpscRing
+//!
+//! Fixed size ring for one producer thread and one consumer thread, neither ever blocks. A push
+//! into a full ring is dropped and counted, the consumer is expected to drain every frame.
+//! T is copied in and out so keep it plain data.
+//!
+template <typename T>
+class SpscRing {
+public:
+	//! \a capacity is rounded up to a power of two
+	explicit SpscRing( size_t capacity )
+		: mHead( 0 ), mTail( 0 ), mNumDropped( 0 )
+	{
+		size_t n = 1;
+		while( n < capacity ) {
+			n <<= 1;
+		}
+		mSlots.resize( n );
+		mMask = n - 1;
+	}
+
+	//! Producer thread only, returns false if the ring is full
+	bool			push( const T& value ) {
+		const size_t head = mHead.load( std::memory_order_relaxed );
+		if( ( head - mTail.load( std::memory_order_acquire ) ) > mMask ) {
+			mNumDropped.fetch_add( 1, std::memory_order_relaxed );
+			return false;
+		}
+		mSlots[head & mMask] = value;
+		mHead.store( head + 1, std::memory_order_release );
+		return true;
+	}
+
+	//! Consumer thread only, returns false if the ring is empty
+	bool			pop( T *outValue ) {
+		const size_t tail = mTail.load( std::memory_order_relaxed );
+		if( tail == mHead.load( std::memory_order_acquire ) ) {
+			return false;
+		}
+		*outValue = mSlots[tail & mMask];
+		mTail.store( tail + 1, std::memory_order_release );
+		return true;
+	}
+
+	size_t			getCapacity() const { return mSlots.size(); }
+	//! Approximate when read while the other thread is active
+	size_t			getSize() const { return mHead.load( std::memory_order_acquire ) - mTail.load( std::memory_order_acquire ); }
+	uint64_t		getNumDropped() const { return mNumDropped.load( std::memory_order_relaxed ); }
+
+private:
+	SpscRing( const SpscRing& );
+	SpscRing& operator=( const SpscRing& );
+
+	std::vector<T>				mSlots;
+	size_t						mMask = 0;
+	// Head and tail on separate cache lines so the two threads don't share one
+	std::atomic<size_t>			mHead;
+	char						mPadHead[64 - sizeof( std::atomic<size_t> )];
+	std::atomic<size_t>			mTail;
+	char						mPadTail[64 - sizeof( std::atomic<size_t> )];
+	std::atomic<uint64_t>		mNumDropped;
+};
+
+//! \class InputThread
+//!
+//! Calls a poll function at a fixed rate on its own thread so that controller state is read
+//! from the runtime off the render thread. Ticks missed while the poll function ran long are
+//! skipped rather than run back to back. Stops and joins on destruction.
+//!
+class InputThread {
+public:
+	//! Called on the input thread with the tick's time in the base of ci::app::getElapsedSeconds()
+	using PollFn = std::function<void(double)>;
+
+	virtual ~InputThread();
+
+	//! Throws if \a hz isn't positive
+	static InputThreadRef		create( double hz, const PollFn& pollFn );
+
+	double						getRate() const { return mRate; }
+	uint64_t					getNumPolls() const { return mNumPolls.load( std::memory_order_relaxed ); }
+
+private:
+	InputThread( double hz, const PollFn& pollFn );
+
+	double						mRate = 0.0;
+	PollFn						mPollFn;
+	std::atomic<uint64_t>		mNumPolls;
+
+	std::thread					mThread;
+	std::mutex					mMutex;
+	std::condition_variable		mCondition;
+	bool						mRunning = true;
+	void						threadProc();
+};
+
+}} // namespace cinder::vr
@@ -0,0 +1,103 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Platform.h"
+#include "cinder/gl/Fbo.h"
+#include "cinder/Area.h"
+
+namespace cinder { namespace vr {
+
+class MultiviewTarget;
+using MultiviewTargetRef = std::shared_ptr<MultiviewTarget>;
+
+//! \class MultiviewTarget
+//!
+//! Color and depth as 2-layer texture arrays, layer 0 is the left eye. The whole target is
+//! drawn to with GL_OVR_multiview2, or with layered rendering where the vertex shader picks
+//! gl_Layer. Each layer is also bindable on its own for per eye drawing. The runtimes take
+//! 2D textures, so resolve() copies a layer into the submitted target.
+//!
+class MultiviewTarget {
+public:
+
+	enum Method {
+		METHOD_NONE = 0,
+		// GL_OVR_multiview2, one draw covers both views
+		METHOD_MULTIVIEW,
+		// Instanced draws that write gl_Layer from the vertex shader
+		METHOD_LAYERED
+	};
+
+	virtual ~MultiviewTarget();
+
+	//! Best method the current GL context supports
+	static MultiviewTarget::Method		getSupportedMethod();
+
+	//! \a eyeSize is the size of each layer
+	static MultiviewTargetRef			create( const ci::ivec2& eyeSize, uint32_t samples );
+
+	MultiviewTarget::Method				getMethod() const { return mMethod; }
+	const ci::ivec2&					getSize() const { return mSize; }
+	uint32_t							getSamples() const { return mSamples; }
+	//! GL_TEXTURE_2D_ARRAY, or GL_TEXTURE_2D_MULTISAMPLE_ARRAY if multisampled
+	GLenum								getTextureTarget() const;
+	GLuint								getColorTextureId() const { return mColorTexture; }
+
+	//! Binds both layers
+	void								bind();
+	//! Binds the layer for \a eye only
+	void								bindLayer( ci::vr::Eye eye );
+	//! Copies (and resolves) the bottom left \a dstArea sized corner of the layer for \a eye into \a dstArea of \a dst
+	void								resolve( ci::vr::Eye eye, const ci::gl::FboRef& dst, const ci::Area& dstArea );
+
+private:
+	MultiviewTarget( const ci::ivec2& eyeSize, uint32_t samples );
+
+	MultiviewTarget::Method				mMethod = METHOD_NONE;
+	ci::ivec2							mSize = ci::ivec2( 0 );
+	uint32_t							mSamples = 0;
+
+	GLuint								mColorTexture = 0;
+	GLuint								mDepthTexture = 0;
+	GLuint								mFramebuffer = 0;
+	GLuint								mLayerFramebuffers[ci::vr::EYE_COUNT];
+};
+
+}} // namespace cinder::vr
@@ -44,8 +44,15 @@
 #include "cinder/Quaternion.h"
 #include "cinder/Vector.h"
 
-#define CINDER_VR_ENABLE_OCULUS
-#define CINDER_VR_ENABLE_OPENVR
+#if defined( CINDER_MSW )
+	#define CINDER_VR_ENABLE_OCULUS
+	#define CINDER_VR_ENABLE_OPENVR
+#endif
+#define CINDER_VR_ENABLE_SIMULATED
+
+#if defined( _MSC_VER )
+	#include <intrin.h>
+#endif
 
 namespace cinder { namespace vr {
 
@@ -57,6 +64,9 @@ enum Api {
 	// Starting point for custom device API id's
 	API_CUSTOM	= 0x40000000,
 
+	// Headless simulated device, see ci::vr::simulated. Must be requested explicitly.
+	API_SIMULATED	= API_CUSTOM,
+
 	API_MAX		= 0x7FFFFFFF,
 	API_ANY		= API_MAX,
 	API_UNKNOWN	= 0xFFFFFFFF
@@ -127,10 +137,52 @@ enum Eye {
 	EYE_LEFT	= 0,
 	EYE_RIGHT	= 1,
 	EYE_COUNT	= 2,
+	// Both eyes in a single pass, see ci::vr::StereoMode
+	EYE_STEREO	= 0x7FFFFFFE,
 	EYE_HMD     = 0x7FFFFFFF,
 	EYE_UNKNOWN	= 0xFFFFFFFF
 };
 
+enum StereoMode {
+	// The app draws the scene once per eye, see Hmd::enableEye().
+	STEREO_MODE_MULTI_PASS = 0,
+
+	// Both eyes share one side by side render target and each batch is drawn once with 2x
+	// instancing, see Hmd::enableStereo(). Per eye drawing with Hmd::enableEye() still works.
+	STEREO_MODE_INSTANCED = 1,
+
+	// Both eyes are layers of one texture array drawn once with GL_OVR_multiview2, or with
+	// instanced layered rendering if that's missing. Falls back to STEREO_MODE_INSTANCED
+	// if neither is supported. See ci::vr::MultiviewTarget.
+	STEREO_MODE_MULTIVIEW = 2,
+};
+
+enum FoveaRegion {
+	// The whole eye at full resolution, foveation is off.
+	FOVEA_REGION_FULL = 0,
+
+	// The whole eye's field of view into the low resolution periphery target.
+	FOVEA_REGION_PERIPHERY = 1,
+
+	// The centre of the eye at full resolution, drawn over the upsampled periphery. See Hmd::drawFoveated().
+	FOVEA_REGION_CENTER = 2,
+};
+
+enum GpuSync {
+	// No CPU/GPU synchronization after submitting a frame.
+	GPU_SYNC_NONE = 0,
+
+	// Fence after submitting a frame and wait on it right away, up to the sync timeout.
+	GPU_SYNC_FENCE_SUBMIT = 1,
+
+	// Fence after submitting a frame and wait on it at the start of the next frame, up to the
+	// sync timeout. The CPU work in between overlaps the GPU work for the submitted frame.
+	GPU_SYNC_FENCE_NEXT_FRAME = 2,
+
+	// glFinish() after submitting a frame, drains the whole pipeline.
+	GPU_SYNC_FINISH = 3,
+};
+
 //! \class Exception
 //!
 //!
@@ -141,4 +193,34 @@ public:
 	virtual ~Exception() {}
 };
 
+//! Index of the lowest set bit in \a mask, which must not be zero.
+inline uint32_t countTrailingZeros( uint64_t mask )
+{
+#if defined( _MSC_VER )
+	unsigned long result = 0;
+	#if defined( _WIN64 )
+		::_BitScanForward64( &result, mask );
+	#else
+		if( ! ::_BitScanForward( &result, static_cast<unsigned long>( mask ) ) ) {
+			::_BitScanForward( &result, static_cast<unsigned long>( mask >> 32 ) );
+			result += 32;
+		}
+	#endif
+	return static_cast<uint32_t>( result );
+#else
+	return static_cast<uint32_t>( __builtin_ctzll( mask ) );
+#endif
+}
+
+//! 64-bit FNV-1a hash of \a size bytes, pass a previous result as \a hash to continue it. Used to key on-disk caches.
+inline uint64_t hashFnv1a( const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL )
+{
+	const uint8_t *bytes = static_cast<const uint8_t*>( data );
+	for( size_t i = 0; i < size; ++i ) {
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
 }} // namespace cinder::vr
\ No newline at end of file
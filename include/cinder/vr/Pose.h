@@ -0,0 +1,91 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Platform.h"
+#include "cinder/Matrix.h"
+#include "cinder/Vector.h"
+
+namespace cinder { namespace vr {
+
+//! Predictions further out than this are clamped, velocities are too noisy beyond it.
+const double kMaxPredictionInterval = 0.1; // Seconds
+
+inline double clampPredictionInterval( double dt )
+{
+	return ( dt < -kMaxPredictionInterval ) ? -kMaxPredictionInterval : ( ( dt > kMaxPredictionInterval ) ? kMaxPredictionInterval : dt );
+}
+
+//! Extrapolates a rigid device to tracking transform by \a dt seconds. Velocities are in
+//! tracking space: meters per second and radians per second about the axis of \a angularVelocity.
+ci::mat4 extrapolatePose( const ci::mat4& deviceToTracking, const ci::vec3& linearVelocity, const ci::vec3& angularVelocity, float dt );
+
+//! Estimates tracking space velocities from two poses sampled \a dt seconds apart.
+void calculateVelocities( const ci::mat4& prevDeviceToTracking, const ci::mat4& deviceToTracking, float dt, ci::vec3 *outLinearVelocity, ci::vec3 *outAngularVelocity );
+
+//! \class TrackedPose
+//!
+//! Pose and velocities of a tracked device, sampled at a point in the owning Hmd's time base.
+//!
+class TrackedPose {
+public:
+	TrackedPose() {}
+	virtual ~TrackedPose() {}
+
+	bool								isValid() const { return mValid; }
+	const ci::mat4&						getDeviceToTrackingMatrix() const { return mDeviceToTrackingMatrix; }
+	const ci::vec3&						getLinearVelocity() const { return mLinearVelocity; }
+	const ci::vec3&						getAngularVelocity() const { return mAngularVelocity; }
+	double								getSampleTime() const { return mSampleTime; }
+
+	void								set( const ci::mat4& deviceToTracking, const ci::vec3& linearVelocity, const ci::vec3& angularVelocity, double sampleTime );
+	void								invalidate() { mValid = false; }
+
+	//! Pose at \a targetTime. Invalid poses are returned unchanged.
+	ci::mat4							extrapolate( double targetTime ) const;
+
+private:
+	bool								mValid = false;
+	ci::mat4							mDeviceToTrackingMatrix;
+	ci::vec3							mLinearVelocity = ci::vec3( 0 );
+	ci::vec3							mAngularVelocity = ci::vec3( 0 );
+	double								mSampleTime = 0;
+};
+
+}} // namespace cinder::vr
@@ -0,0 +1,64 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Platform.h"
+#include "cinder/Matrix.h"
+
+//! SSE2 is part of the x64 baseline, 32-bit builds need /arch:SSE2 or -msse2.
+#if ! defined( CINDER_VR_DISABLE_SIMD ) && ( defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) ) || defined( __SSE2__ ) )
+	#define CINDER_VR_ENABLE_SSE2
+#endif
+
+namespace cinder { namespace vr {
+
+//! Batch kernels for the rigid transforms on the pose path. Sources are read through a byte stride
+//! so that SDK pose arrays can be converted in place without repacking. Results are identical to
+//! the equivalent glm expressions, up to floating point rounding. \a dst may alias \a src.
+
+//! Converts \a count row major 3x4 matrices, e.g. ::vr::HmdMatrix34_t, to column major ci::mat4.
+void convertRowMajor3x4( const void *src, size_t srcStride, ci::mat4 *dst, size_t count );
+//! Converts \a count poses laid out as quaternion (x, y, z, w) followed by position (x, y, z), e.g. ::ovrPosef.
+void convertQuatPosition( const void *src, size_t srcStride, ci::mat4 *dst, size_t count );
+//! Inverts \a count transforms that contain only rotation and translation.
+void invertRigid( const ci::mat4 *src, ci::mat4 *dst, size_t count );
+//! Computes \a lhs * \a src[i] for \a count transforms.
+void multiplyTransforms( const ci::mat4& lhs, const ci::mat4 *src, ci::mat4 *dst, size_t count );
+
+}} // namespace cinder::vr
@@ -0,0 +1,118 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Pose.h"
+
+namespace cinder { namespace vr {
+
+const uint32_t kPoseStoreMaxDevices = 64;
+
+//! \class PoseStore
+//!
+//! Poses of all tracked devices of a session, stored as parallel arrays. Derived matrices are
+//! only recalculated for devices whose pose changed, static devices like base stations cost
+//! a compare per update. Backends wrap each refresh in beginUpdate() / endUpdate().
+//!
+class PoseStore {
+public:
+	PoseStore();
+	virtual ~PoseStore() {}
+
+	//! Clears the changed mask and advances the generation
+	void								beginUpdate();
+	//! Recalculates the tracking to device matrices of devices that changed during the update
+	void								endUpdate();
+
+	void								setPose( uint32_t deviceIndex, const ci::mat4& deviceToTracking, const ci::vec3& linearVelocity, const ci::vec3& angularVelocity, double sampleTime );
+	void								setPose( uint32_t deviceIndex, const ci::vec3& position, const ci::quat& rotation, const ci::vec3& linearVelocity, const ci::vec3& angularVelocity, double sampleTime );
+	void								invalidate( uint32_t deviceIndex );
+
+	//! Incremented by every beginUpdate()
+	uint64_t							getGeneration() const { return mGeneration; }
+	//! Bit N is set if device N has a valid pose
+	uint64_t							getValidMask() const { return mValidMask; }
+	//! Bit N is set if device N moved, appeared or was lost during the last update
+	uint64_t							getChangedMask() const { return mChangedMask; }
+
+	bool								isValid( uint32_t deviceIndex ) const { return ( deviceIndex < kPoseStoreMaxDevices ) && ( 0 != ( mValidMask & ( 1ULL << deviceIndex ) ) ); }
+	bool								hasChanged( uint32_t deviceIndex ) const { return ( deviceIndex < kPoseStoreMaxDevices ) && ( 0 != ( mChangedMask & ( 1ULL << deviceIndex ) ) ); }
+	//! Generation of the last update that changed \a deviceIndex
+	uint64_t							getDeviceGeneration( uint32_t deviceIndex ) const { return mDeviceGenerations[deviceIndex]; }
+
+	const ci::vec3&						getPosition( uint32_t deviceIndex ) const { return mPositions[deviceIndex]; }
+	const ci::quat&						getRotation( uint32_t deviceIndex ) const { return mRotations[deviceIndex]; }
+	const ci::vec3&						getLinearVelocity( uint32_t deviceIndex ) const { return mLinearVelocities[deviceIndex]; }
+	const ci::vec3&						getAngularVelocity( uint32_t deviceIndex ) const { return mAngularVelocities[deviceIndex]; }
+	double								getSampleTime( uint32_t deviceIndex ) const { return mSampleTimes[deviceIndex]; }
+	const ci::mat4&						getDeviceToTrackingMatrix( uint32_t deviceIndex ) const { return mDeviceToTrackingMatrices[deviceIndex]; }
+	const ci::mat4&						getTrackingToDeviceMatrix( uint32_t deviceIndex ) const { return mTrackingToDeviceMatrices[deviceIndex]; }
+
+	//! Pose of \a deviceIndex at \a targetTime. Invalid devices return their last known pose.
+	ci::mat4							extrapolate( uint32_t deviceIndex, double targetTime ) const;
+	ci::vr::TrackedPose					getTrackedPose( uint32_t deviceIndex ) const;
+
+	//! Calls \a fn( deviceIndex ) for every bit set in \a mask, lowest index first
+	template <typename FnT>
+	static void							forEachDevice( uint64_t mask, FnT fn ) {
+		while( 0 != mask ) {
+			fn( ci::vr::countTrailingZeros( mask ) );
+			mask &= ( mask - 1 );
+		}
+	}
+
+private:
+	uint64_t							mGeneration = 0;
+	uint64_t							mValidMask = 0;
+	uint64_t							mChangedMask = 0;
+
+	ci::vec3							mPositions[kPoseStoreMaxDevices];
+	ci::quat							mRotations[kPoseStoreMaxDevices];
+	ci::vec3							mLinearVelocities[kPoseStoreMaxDevices];
+	ci::vec3							mAngularVelocities[kPoseStoreMaxDevices];
+	double								mSampleTimes[kPoseStoreMaxDevices];
+	uint64_t							mDeviceGenerations[kPoseStoreMaxDevices];
+
+	ci::mat4							mDeviceToTrackingMatrices[kPoseStoreMaxDevices];
+	ci::mat4							mTrackingToDeviceMatrices[kPoseStoreMaxDevices];
+
+	void								markChanged( uint32_t deviceIndex );
+};
+
+}} // namespace cinder::vr
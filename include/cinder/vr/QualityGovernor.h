@@ -0,0 +1,164 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Platform.h"
+#include "cinder/Signals.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cinder { namespace vr {
+
+class QualityGovernor;
+using QualityGovernorRef = std::shared_ptr<QualityGovernor>;
+
+//! \class QualityGovernor
+//!
+//! Steps app-defined quality knobs (MSAA level, LOD bias, particle budget...) down when the
+//! compositor reports missed frames or the GPU runs out of headroom, and back up after a long
+//! run of frames with spare headroom. Lowers the most expensive knob first and raises the
+//! cheapest first. A raise that gets undone shortly after doubles the wait before the next one.
+//!
+class QualityGovernor {
+public:
+
+	//! Compositor view of one frame, filled in by the Context
+	struct FrameStats {
+		double		budgetSeconds = 0.0;
+		//! 0 when the backend can't measure it
+		double		gpuSeconds = 0.0;
+		//! Since the previous FrameStats
+		uint32_t	numDroppedFrames = 0;
+		uint32_t	numReprojectedFrames = 0;
+
+		bool		hasGpuTime() const { return gpuSeconds > 0.0; }
+		//! Fraction of the budget left over, negative when over budget
+		double		getHeadroom() const { return ( budgetSeconds > 0.0 ) ? ( 1.0 - gpuSeconds / budgetSeconds ) : 0.0; }
+	};
+
+	using SignalFrameStats = ci::signals::Signal<void(const ci::vr::QualityGovernor::FrameStats&)>;
+
+	//! \class Knob
+	//!
+	//!
+	class Knob {
+	public:
+		using Callback = std::function<void(int32_t level)>;
+
+		const std::string&				getName() const { return mName; }
+		int32_t							getLevel() const { return mLevel; }
+		int32_t							getMinLevel() const { return mMinLevel; }
+		int32_t							getMaxLevel() const { return mMaxLevel; }
+		float							getCost() const { return mCost; }
+
+		//! Sets the level without calling the callback
+		void							setLevel( int32_t level );
+		//! Locked knobs keep their level
+		bool							isLocked() const { return mLocked; }
+		void							setLocked( bool locked = true ) { mLocked = locked; }
+
+	private:
+		Knob( const std::string& name, int32_t minLevel, int32_t maxLevel, int32_t level, float cost, const Callback& callback );
+		friend class QualityGovernor;
+
+		std::string						mName;
+		int32_t							mMinLevel = 0;
+		int32_t							mMaxLevel = 0;
+		int32_t							mLevel = 0;
+		float							mCost = 1.0f;
+		bool							mLocked = false;
+		Callback						mCallback;
+	};
+
+	virtual ~QualityGovernor();
+
+	static QualityGovernorRef			create();
+
+	//! \a cost is the relative GPU cost of one level step, only compared between knobs. \a callback is called from the update thread with the new level.
+	Knob*								addKnob( const std::string& name, int32_t minLevel, int32_t maxLevel, int32_t level, float cost, const Knob::Callback& callback );
+	void								removeKnob( const std::string& name );
+	Knob*								getKnob( const std::string& name ) const;
+	size_t								getNumKnobs() const { return mKnobs.size(); }
+	//! True when there are knobs to step or slots on the frame stats signal, Context skips update() otherwise
+	bool								hasListeners() const { return ( ! mKnobs.empty() ) || ( mSignalFrameStats.getNumSlots() > 0 ); }
+
+	//! Lowers below \a lower, raises above \a raise. The gap between the two is the hysteresis band.
+	void								setHeadroomThresholds( double lower, double raise ) { mLowerHeadroom = lower; mRaiseHeadroom = raise; }
+	double								getLowerHeadroom() const { return mLowerHeadroom; }
+	double								getRaiseHeadroom() const { return mRaiseHeadroom; }
+	//! Consecutive frames needed before lowering or raising a knob. Each missed frame counts as one over budget frame.
+	void								setFrameWindows( uint32_t lowerFrames, uint32_t raiseFrames ) { mLowerFrames = lowerFrames; mRaiseFrames = raiseFrames; }
+	//! Frames ignored after any change while its effect shows up in the timings
+	void								setCooldownFrames( uint32_t frames ) { mCooldownFrames = frames; }
+
+	void								update( const ci::vr::QualityGovernor::FrameStats& stats );
+	const ci::vr::QualityGovernor::FrameStats&	getLastFrameStats() const { return mLastFrameStats; }
+
+	//! Emitted for every update(), which Context calls once per submitted frame. Connecting a slot is
+	//! enough, no knobs need to be registered.
+	SignalFrameStats&					getSignalFrameStats() { return mSignalFrameStats; }
+
+private:
+	QualityGovernor();
+
+	std::vector<std::unique_ptr<Knob>>	mKnobs;
+
+	double								mLowerHeadroom = 0.05;
+	double								mRaiseHeadroom = 0.25;
+	uint32_t							mLowerFrames = 3;
+	uint32_t							mRaiseFrames = 90;
+	uint32_t							mCooldownFrames = 30;
+
+	uint64_t							mFrameIndex = 0;
+	uint32_t							mOverFrames = 0;
+	uint32_t							mUnderFrames = 0;
+	uint32_t							mCooldown = 0;
+	uint32_t							mRaiseBackoff = 1;
+	uint64_t							mLastRaiseFrame = 0;
+	bool								mRaisePending = false;
+	ci::vr::QualityGovernor::FrameStats	mLastFrameStats;
+	SignalFrameStats					mSignalFrameStats;
+
+	bool								lower();
+	bool								raise();
+};
+
+}} // namespace cinder::vr
@@ -0,0 +1,212 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/AxisAlignedBox.h"
+#include "cinder/Ray.h"
+#include "cinder/Sphere.h"
+#include "cinder/TriMesh.h"
+
+#include <cfloat>
+#include <memory>
+#include <vector>
+
+namespace cinder { namespace vr {
+
+class Context;
+class Controller;
+
+class RayQuery;
+using RayQueryRef = std::shared_ptr<RayQuery>;
+
+//! \class RayQuery
+//!
+//! Nearest-hit ray queries against boxes, spheres and triangle meshes. Colliders live in a
+//! bounding volume hierarchy that is refit in place when colliders move and only rebuilt when
+//! colliders are added or removed, or when refits have loosened it too much. Each triangle mesh
+//! keeps its own hierarchy in mesh space, so moving a mesh only moves its bounds. Not thread
+//! safe, large batches of rays are split across worker threads internally.
+//!
+class RayQuery {
+public:
+
+	using ColliderId = uint32_t;
+	static const ColliderId kInvalidCollider = 0xFFFFFFFF;
+
+	enum Shape {
+		SHAPE_BOX,
+		SHAPE_SPHERE,
+		SHAPE_MESH,
+	};
+
+	struct Hit {
+		ColliderId	collider = kInvalidCollider;
+		//! Ray parameter of the hit, in units of the ray direction's length like ci::Ray::calcPosition()
+		float		distance = FLT_MAX;
+		ci::vec3	position = ci::vec3( 0 );
+		//! Index of the hit triangle for mesh colliders
+		uint32_t	triangle = 0xFFFFFFFF;
+		void*		userData = nullptr;
+
+		bool		isValid() const { return kInvalidCollider != collider; }
+	};
+
+	//! Nearest hit for one active input ray, \a controller is null for the Hmd's gaze ray
+	struct InputHit {
+		const ci::vr::Controller*	controller = nullptr;
+		ci::Ray						ray;
+		Hit							hit;
+	};
+
+	virtual ~RayQuery();
+
+	static RayQueryRef		create();
+
+	//! Origins inside a box or sphere hit at distance 0. Triangles are double-sided.
+	ColliderId				addBox( const ci::AxisAlignedBox& box, void* userData = nullptr );
+	ColliderId				addSphere( const ci::Sphere& sphere, void* userData = nullptr );
+	ColliderId				addMesh( const std::vector<ci::vec3>& positions, const std::vector<uint32_t>& indices, const ci::mat4& transform = ci::mat4(), void* userData = nullptr );
+	ColliderId				addMesh( const ci::TriMesh& mesh, const ci::mat4& transform = ci::mat4(), void* userData = nullptr );
+	void					remove( ColliderId collider );
+	void					clear();
+
+	//! Moving colliders refits the hierarchy on the next update()
+	void					setBox( ColliderId collider, const ci::AxisAlignedBox& box );
+	void					setSphere( ColliderId collider, const ci::Sphere& sphere );
+	void					setTransform( ColliderId collider, const ci::mat4& transform );
+	//! Disabled colliders stay in the hierarchy but are skipped by queries
+	void					setEnabled( ColliderId collider, bool enabled );
+	bool					isEnabled( ColliderId collider ) const;
+	void*					getUserData( ColliderId collider ) const;
+	Shape					getShape( ColliderId collider ) const;
+	size_t					getNumColliders() const { return mNumColliders; }
+
+	//! Number of rays in a batch before it's split across threads, default is 256
+	void					setParallelThreshold( size_t numRays ) { mParallelThreshold = numRays; }
+	size_t					getParallelThreshold() const { return mParallelThreshold; }
+
+	//! Applies pending adds, removes and moves, the query functions call it first
+	void					update();
+
+	//! Hits past \a maxDistance are ignored
+	Hit						queryNearest( const ci::Ray& ray, float maxDistance = FLT_MAX );
+	//! Writes the nearest hit per ray to \a outHits, invalid hits for rays that miss
+	void					queryNearest( const ci::Ray *rays, size_t count, Hit *outHits, float maxDistance = FLT_MAX );
+	//! Queries the Hmd's input ray and the input ray of every controller that has one
+	std::vector<InputHit>	queryInputRays( const ci::vr::Context *context, float maxDistance = FLT_MAX );
+	void					queryInputRays( const ci::vr::Context *context, std::vector<InputHit> *outHits, float maxDistance = FLT_MAX );
+
+	//! Reference query that tests every enabled collider, for validation and benchmarks
+	Hit						queryNearestLinear( const ci::Ray& ray, float maxDistance = FLT_MAX ) const;
+
+private:
+	RayQuery();
+
+	struct Bounds {
+		ci::vec3	min = ci::vec3( FLT_MAX );
+		ci::vec3	max = ci::vec3( -FLT_MAX );
+
+		void		include( const ci::vec3& p );
+		void		include( const Bounds& b );
+		ci::vec3	getCenter() const { return 0.5f * ( min + max ); }
+		float		getArea() const;
+	};
+
+	// Inner nodes keep their left child at the next index and their right child at \a first,
+	// leaves keep \a count items starting at \a first. Children always follow their parent.
+	struct Node {
+		Bounds		bounds;
+		uint32_t	first = 0;
+		uint32_t	count = 0;
+	};
+
+	struct Mesh {
+		std::vector<ci::vec3>	positions;
+		std::vector<uint32_t>	indices;
+		// Triangle indices in leaf order
+		std::vector<uint32_t>	order;
+		std::vector<Node>		nodes;
+	};
+
+	struct Collider {
+		Shape					shape = SHAPE_BOX;
+		bool					alive = false;
+		bool					enabled = true;
+		void*					userData = nullptr;
+		// Box min and max, or sphere center and radius in min.xyz and max.x
+		ci::vec3				min = ci::vec3( 0 );
+		ci::vec3				max = ci::vec3( 0 );
+		std::shared_ptr<Mesh>	mesh;
+		ci::mat4				transform;
+		ci::mat4				invTransform;
+		Bounds					bounds;
+	};
+
+	struct RayData;
+
+	// Sorts the item indices in \a order into leaves, returns the summed surface area of the nodes
+	static float			build( const std::vector<Bounds>& itemBounds, std::vector<uint32_t> *order, std::vector<Node> *outNodes );
+	static uint32_t			buildRecursive( const std::vector<Bounds>& itemBounds, uint32_t *order, uint32_t first, uint32_t count, std::vector<Node> *nodes );
+
+	ColliderId				allocate( Shape shape, void* userData );
+	Collider&				getCollider( ColliderId collider );
+	const Collider&			getCollider( ColliderId collider ) const;
+	void					updateBounds( Collider& collider );
+	void					rebuild();
+	void					refit();
+
+	bool					intersect( const Collider& collider, const RayData& ray, float maxDistance, float *outDistance, uint32_t *outTriangle ) const;
+	Hit						makeHit( ColliderId collider, const ci::Ray& ray, float distance, uint32_t triangle ) const;
+	Hit						queryOne( const ci::Ray& ray, float maxDistance ) const;
+	void					queryRange( const ci::Ray *rays, size_t begin, size_t end, Hit *outHits, float maxDistance ) const;
+
+	std::vector<Collider>	mColliders;
+	std::vector<ColliderId>	mFreeColliders;
+	size_t					mNumColliders = 0;
+
+	std::vector<uint32_t>	mOrder;
+	std::vector<Node>		mNodes;
+	float					mBuiltArea = 0;
+	bool					mNeedsRebuild = false;
+	bool					mNeedsRefit = false;
+
+	size_t					mParallelThreshold = 256;
+};
+
+}} // namespace cinder::vr
@@ -0,0 +1,183 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Controller.h"
+#include "cinder/vr/MappedFile.h"
+#include "cinder/vr/PoseStore.h"
+#include "cinder/Filesystem.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace cinder { namespace vr {
+
+class Hmd;
+class Recorder;
+class Recording;
+using RecorderRef = std::shared_ptr<Recorder>;
+using RecordingRef = std::shared_ptr<Recording>;
+
+const uint32_t kRecordingVersion			= 2;
+const uint32_t kRecordingMaxControllers		= 4;
+const uint32_t kRecordingMaxDevices			= ci::vr::kPoseStoreMaxDevices;
+const uint32_t kRecordingMaxTriggers		= 8;
+const uint32_t kRecordingMaxAxes			= 8;
+
+//! Recording file layout: one RecordingHeader followed by fixed-size RecordedFrame records.
+//! Frames are only ever appended, so a truncated file still replays up to its last whole frame.
+struct RecordingHeader {
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	headerSize;
+	uint32_t	frameSize;
+	uint32_t	api;
+	uint32_t	maxControllers;
+	uint32_t	maxDevices;
+	uint32_t	reserved[8];
+};
+
+//! Matrices are stored as the upper 3 rows of a rigid transform, column major.
+struct RecordedController {
+	uint32_t	type;
+	//! Index of the controller's pose in RecordedFrame::devices, UINT32_MAX when it wasn't tracked
+	uint32_t	trackedDeviceIndex;
+	uint32_t	buttonsDown;
+	//! Buttons whose state was known (down or up) when the frame was recorded
+	uint32_t	buttonsKnown;
+	//! Triggers and axes present on the recorded controller, by bit position
+	uint16_t	triggersKnown;
+	uint16_t	axesKnown;
+	float		deviceToTracking[12];
+	//! Indexed by bit position of TriggerId / AxisId
+	float		triggers[kRecordingMaxTriggers];
+	float		axes[kRecordingMaxAxes][2];
+	uint32_t	reserved;
+};
+
+//! One device of the PoseStore. Rotation is stored as x, y, z, w.
+struct RecordedDevicePose {
+	float		position[3];
+	float		rotation[4];
+	float		linearVelocity[3];
+	float		angularVelocity[3];
+	float		reserved;
+	//! Seconds relative to RecordedFrame::displayTime
+	double		sampleTime;
+};
+
+struct RecordedFrame {
+	//! Seconds since recording started
+	double				time;
+	uint32_t			frameIndex;
+	uint32_t			numControllers;
+	float				hmdDeviceToTracking[12];
+	RecordedController	controllers[kRecordingMaxControllers];
+	//! Hmd::getPredictedDisplayTime() when the frame was recorded, in the runtime's time base
+	double				displayTime;
+	//! PoseStore masks, devices[i] is only meaningful when bit i of validMask is set
+	uint64_t			validMask;
+	uint64_t			changedMask;
+	RecordedDevicePose	devices[kRecordingMaxDevices];
+};
+
+static_assert( 64 == sizeof( RecordingHeader ), "RecordingHeader size changed, bump kRecordingVersion" );
+static_assert( 168 == sizeof( RecordedController ), "RecordedController size changed, bump kRecordingVersion" );
+static_assert( 64 == sizeof( RecordedDevicePose ), "RecordedDevicePose size changed, bump kRecordingVersion" );
+static_assert( 4856 == sizeof( RecordedFrame ), "RecordedFrame size changed, bump kRecordingVersion" );
+
+void		toRecorded( const ci::mat4& m, float *out );
+ci::mat4	fromRecorded( const float *m );
+
+//! \class Recorder
+//!
+//! Appends one RecordedFrame per Context::update() while a recording is active. Every valid
+//! device of the PoseStore is recorded, about 4.7 KB per frame.
+//!
+class Recorder {
+public:
+	virtual ~Recorder();
+
+	static RecorderRef					create( const ci::fs::path& path, ci::vr::Api api );
+
+	const ci::fs::path&					getPath() const { return mPath; }
+	uint32_t							getNumFrames() const { return mNumFrames; }
+
+	void								record( double time, const ci::vr::Hmd *hmd, const ci::vr::PoseStore& poseStore, const std::vector<ci::vr::ControllerRef>& controllers );
+	void								close();
+
+private:
+	Recorder( const ci::fs::path& path, ci::vr::Api api );
+
+	ci::fs::path						mPath;
+	std::FILE							*mFile = nullptr;
+	uint32_t							mNumFrames = 0;
+	RecordedFrame						mFrame;
+};
+
+//! \class Recording
+//!
+//! Read-only, memory mapped view of a recording file.
+//!
+class Recording {
+public:
+	virtual ~Recording();
+
+	static RecordingRef					create( const ci::fs::path& path );
+
+	const ci::fs::path&					getPath() const { return mPath; }
+	const RecordingHeader&				getHeader() const { return *mHeader; }
+
+	uint32_t							getNumFrames() const { return mNumFrames; }
+	const RecordedFrame&				getFrame( uint32_t index ) const { return mFrames[index]; }
+	double								getDuration() const;
+	//! Index of the last frame recorded at or before \a time. Searches forward from \a hint.
+	uint32_t							findFrame( double time, uint32_t hint = 0 ) const;
+
+private:
+	Recording( const ci::fs::path& path );
+
+	ci::fs::path						mPath;
+	ci::vr::MappedFileRef				mFile;
+	const RecordingHeader				*mHeader = nullptr;
+	const RecordedFrame					*mFrames = nullptr;
+	uint32_t							mNumFrames = 0;
+};
+
+}} // namespace cinder::vr
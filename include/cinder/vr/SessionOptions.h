@@ -82,12 +82,63 @@ public:
 	float								getFarClip() const { return mFarClip; }
 	SessionOptions&						setFarClip( float value ) { mFarClip = value; return *this; }
 
+	//! Vertices per side of each eye's lens distortion grid, used by the mirror.
+	uint32_t							getDistortionGridSize() const { return mDistortionGridSize; }
+	SessionOptions&						setDistortionGridSize( uint32_t value ) { mDistortionGridSize = value; return *this; }
+
+	//! Scales the eye viewports every frame to keep the GPU frame time within budget. Render targets are allocated at the max scale.
+	bool								isDynamicResolutionEnabled() const { return mDynamicResolution; }
+	SessionOptions&						setDynamicResolution( bool enabled ) { mDynamicResolution = enabled; return *this; }
+	//! Scale range relative to the backend's nominal render target size
+	std::pair<float, float>				getDynamicResolutionRange() const { return std::make_pair( mDynamicResolutionMinScale, mDynamicResolutionMaxScale ); }
+	SessionOptions&						setDynamicResolutionRange( float minScale, float maxScale ) { mDynamicResolutionMinScale = std::max( minScale, 0.1f ); mDynamicResolutionMaxScale = std::max( maxScale, mDynamicResolutionMinScale ); return *this; }
+	//! Fraction of the frame period (1 / frame rate) the GPU should take
+	float								getDynamicResolutionBudget() const { return mDynamicResolutionBudget; }
+	SessionOptions&						setDynamicResolutionBudget( float value ) { mDynamicResolutionBudget = value; return *this; }
+
+	//! Masks the pixels hidden by the lenses in depth at the start of each eye, where the backend knows them
+	bool								isHiddenAreaMaskEnabled() const { return mHiddenAreaMask; }
+	SessionOptions&						setHiddenAreaMask( bool enabled ) { mHiddenAreaMask = enabled; return *this; }
+
+	//! Fixed foveated rendering with Hmd::drawFoveated(), multi-pass stereo only. Adjustable at runtime on the Hmd.
+	bool								isFoveationEnabled() const { return mFoveation; }
+	SessionOptions&						setFoveation( bool enabled ) { mFoveation = enabled; return *this; }
+	//! Half-size of the full resolution centre relative to the eye viewport's half-size
+	float								getFoveationRadius() const { return mFoveationRadius; }
+	SessionOptions&						setFoveationRadius( float value ) { mFoveationRadius = std::min( std::max( value, 0.05f ), 1.0f ); return *this; }
+	//! Resolution of the periphery relative to the eye viewport
+	float								getFoveationPeripheryScale() const { return mFoveationPeripheryScale; }
+	SessionOptions&						setFoveationPeripheryScale( float value ) { mFoveationPeripheryScale = std::min( std::max( value, 0.1f ), 1.0f ); return *this; }
+
+	ci::vr::StereoMode					getStereoMode() const { return mStereoMode; }
+	SessionOptions&						setStereoMode( ci::vr::StereoMode value ) { mStereoMode = value; return *this; }
+
+	//! How the CPU waits on the GPU after a frame is submitted. Backends without an explicit wait ignore it.
+	ci::vr::GpuSync						getGpuSync() const { return mGpuSync; }
+	SessionOptions&						setGpuSync( ci::vr::GpuSync value ) { mGpuSync = value; return *this; }
+	//! Longest wait, in seconds, on a GPU_SYNC_FENCE_* fence
+	double								getGpuSyncTimeout() const { return mGpuSyncTimeout; }
+	SessionOptions&						setGpuSyncTimeout( double value ) { mGpuSyncTimeout = std::max( value, 0.0 ); return *this; }
+
 	std::pair<float, float>				getClip() const { return std::make_pair( mNearClip, mFarClip ); }
 	SessionOptions&						setClip( float nearClip, float farClip ) { mNearClip = nearClip; mFarClip = farClip; return *this; }
 
 	double								getControllersScanInterval() const { return mControllersScanInterval; }
 	SessionOptions&						setControllersScanInterval( double value ) { mControllersScanInterval = std::max( value, 0.0 ); return *this; }
 
+	//! Seconds between controller input samples, 0 samples once per frame.
+	double								getInputSampleInterval() const { return mInputSampleInterval; }
+	SessionOptions&						setInputSampleInterval( double value ) { mInputSampleInterval = std::max( value, 0.0 ); return *this; }
+
+	//! Polls controller input on a dedicated thread at \a hz, 0 polls on the main thread. Samples
+	//! are drained every update(), see Context::getInputSamples(). 500-1000 Hz is typical.
+	double								getInputPollRate() const { return mInputPollRate; }
+	SessionOptions&						setInputPollRate( double hz ) { mInputPollRate = std::min( std::max( hz, 0.0 ), 2000.0 ); return *this; }
+
+	//! Queues controller input while polling and emits the signals in one pass per update(), see ci::vr::ControllerEventQueue
+	bool								isControllerEventQueueEnabled() const { return mControllerEventQueue; }
+	SessionOptions&						setControllerEventQueue( bool enabled ) { mControllerEventQueue = enabled; return *this; }
+
 	std::function<void(const ci::vr::Controller*)>	getControllerConnected() const { return mControllerConnected; }
 	SessionOptions&									setControllerConnected( std::function<void(const ci::vr::Controller*)> value ) {  mControllerConnected = value; return *this; }
 	std::function<void(const ci::vr::Controller*)>	getControllerDisconnected() const { return mControllerDisconnected; }
@@ -107,8 +158,32 @@ private:
 	float								mNearClip = 0.1f;
 	float								mFarClip = 100.0f;
 
+	uint32_t							mDistortionGridSize = 43;
+
+	ci::vr::StereoMode					mStereoMode = ci::vr::STEREO_MODE_MULTI_PASS;
+
+	bool								mDynamicResolution = false;
+	float								mDynamicResolutionMinScale = 0.6f;
+	float								mDynamicResolutionMaxScale = 1.0f;
+	float								mDynamicResolutionBudget = 0.9f;
+
+	bool								mHiddenAreaMask = true;
+
+	bool								mFoveation = false;
+	float								mFoveationRadius = 0.5f;
+	float								mFoveationPeripheryScale = 0.5f;
+
+	// Default: glFinish() after submit, the OpenVR sample's jitter workaround
+	ci::vr::GpuSync						mGpuSync = ci::vr::GPU_SYNC_FINISH;
+	double								mGpuSyncTimeout = 0.011;
+
 	// Default: 0 sec - no scans after initial scan at startup
 	double											mControllersScanInterval = 0.0f;
+	// Default: 0 sec - sample every frame
+	double											mInputSampleInterval = 0.0;
+	// Default: 0 Hz - no input thread
+	double											mInputPollRate = 0.0;
+	bool											mControllerEventQueue = false;
 	std::function<void(const ci::vr::Controller*)>	mControllerConnected;
 	std::function<void(const ci::vr::Controller*)>	mControllerDisconnected;
 };
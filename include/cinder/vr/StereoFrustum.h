@@ -0,0 +1,97 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/PoseMath.h"
+
+namespace cinder { namespace vr {
+
+//! \class StereoFrustum
+//!
+//! Culling planes for both eyes plus one convex frustum that contains both, in the space of the
+//! view projection matrices it was built from. A plain value, copies can cull on worker threads
+//! while the render thread moves on. The batch functions process four objects at a time with
+//! SSE2 where it's enabled, see PoseMath.h.
+//!
+class StereoFrustum {
+public:
+
+	enum Visibility {
+		VISIBLE_NONE		= 0,
+		VISIBLE_LEFT		= 1 << ci::vr::EYE_LEFT,
+		VISIBLE_RIGHT		= 1 << ci::vr::EYE_RIGHT,
+		// Inside the combined frustum, for drawing once for both eyes
+		VISIBLE_COMBINED	= 1 << ci::vr::EYE_COUNT,
+	};
+
+	enum Plane {
+		PLANE_LEFT = 0,
+		PLANE_RIGHT,
+		PLANE_BOTTOM,
+		PLANE_TOP,
+		PLANE_NEAR,
+		PLANE_FAR,
+		PLANE_COUNT
+	};
+
+	StereoFrustum() {}
+	StereoFrustum( const ci::mat4& leftViewProjection, const ci::mat4& rightViewProjection );
+
+	void								set( const ci::mat4& leftViewProjection, const ci::mat4& rightViewProjection );
+
+	//! Planes are ( normal, distance ) with the normal pointing inward, p is inside when dot( normal, p ) + distance >= 0
+	const ci::vec4&						getEyePlane( ci::vr::Eye eye, StereoFrustum::Plane plane ) const { return mPlanes[( 1 + eye ) * PLANE_COUNT + plane]; }
+	const ci::vec4&						getCombinedPlane( StereoFrustum::Plane plane ) const { return mPlanes[plane]; }
+
+	//! Returns a mask of StereoFrustum::Visibility
+	uint32_t							cullSphere( const ci::vec3& center, float radius ) const;
+	uint32_t							cullBox( const ci::vec3& boxMin, const ci::vec3& boxMax ) const;
+
+	//! Sources are read through a byte stride. Each sphere starts with its center ( x, y, z ) and radius,
+	//! e.g. a ci::vec4. Writes a mask of StereoFrustum::Visibility per sphere to \a outVisibility.
+	void								cullSpheres( const void *src, size_t srcStride, size_t count, uint8_t *outVisibility ) const;
+	//! Each box starts with its min ( x, y, z ) followed by its max ( x, y, z ), e.g. a pair of ci::vec3.
+	void								cullBoxes( const void *src, size_t srcStride, size_t count, uint8_t *outVisibility ) const;
+
+private:
+	// Combined, left eye, right eye
+	ci::vec4							mPlanes[3 * PLANE_COUNT];
+};
+
+}} // namespace cinder::vr
@@ -44,9 +44,12 @@
 
 #include <OVR_CAPI.h>
 
+#include <atomic>
+
 namespace cinder { namespace vr { namespace oculus  {
 
 class DeviceManager;
+class Hmd;
 
 class Context;
 using ContextRef = std::shared_ptr<Context>;
@@ -71,17 +74,37 @@ public:
 protected:
 	Context( const ci::vr::SessionOptions& sessionOptions, ci::vr::oculus::DeviceManager* deviceManager );
 	friend class ci::vr::Environment;
+	friend class ci::vr::oculus::Hmd;
 
 	virtual void						beginSession() override;
 	virtual void						endSession() override;
 
 	virtual void						processEvents() override;
+	virtual void						sampleInput() override;
+	virtual void						pollInput( double time ) override;
+
+	//! Publishes head and hand poses of \a trackingState to the pose store
+	void								updatePoseData( const ::ovrTrackingState& trackingState );
 
 private:
 	ci::vr::oculus::DeviceManager		*mDeviceManager = nullptr;
 
 	::ovrSession						mSession = nullptr;
 	::ovrHmdDesc						mHmdDesc;
+
+	// Controller state read by the input thread, converted on the main thread in sampleInput()
+	struct PolledInput {
+		double							time;
+		::ovrControllerType				type;
+		::ovrInputState					state;
+	};
+
+	std::unique_ptr<ci::vr::SpscRing<PolledInput>>	mPolledInputs;
+	//! Internal types of the connected controllers, written by drainPolledInput() for pollInput()
+	std::atomic<uint32_t>				mPollTypes;
+	//! Input thread only, runtime update time of the last state pushed per controller type bit
+	double								mPolledStateTimes[8];
+	void								drainPolledInput();
 };
 
 }}} // namespace cinder::vr::oculus
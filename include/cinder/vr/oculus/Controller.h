@@ -39,6 +39,7 @@
 #pragma once
 
 #include "cinder/vr/Controller.h"
+#include "cinder/vr/InputThread.h"
 
 #if defined( CINDER_VR_ENABLE_OCULUS )
 
@@ -74,6 +75,12 @@ protected:
 	virtual void							processButtons( const ::ovrInputState& state );
 	virtual void							processTriggers( const ::ovrInputState& state );
 	virtual void							processAxes( const ::ovrInputState& state );
+
+	//! Unnormalized value of input \a id in \a state
+	float									getRawTriggerValue( ci::vr::Controller::TriggerId id, const ::ovrInputState& state ) const;
+	ci::vec2								getRawAxisValue( ci::vr::Controller::AxisId id, const ::ovrInputState& state ) const;
+	//! Converts \a state read by the input thread at \a time without touching the controller's inputs
+	ci::vr::InputSample						toInputSample( double time, const ::ovrInputState& state ) const;
 };
 
 //! \class ControllerRemote
@@ -79,6 +79,9 @@ public:
 
 	virtual float						getFullFov() const;
 
+	virtual double						getTimeInSeconds() const override;
+	virtual double						getPredictedDisplayTime() const override;
+
 	virtual ci::Area					getEyeViewport( ci::vr::Eye eye ) const override;
 	
 	virtual	void						enableEye( ci::vr::Eye eye, ci::vr::CoordSys eyeMatrixMode = ci::vr::COORD_SYS_WORLD ) override;
@@ -48,6 +48,11 @@
 
 namespace cinder { namespace vr { namespace oculus  {
 
+//! Indices of the poses published through ci::vr::Hmd::getTrackedPose()
+const uint32_t kTrackedDeviceIndexHmd			= 0;
+const uint32_t kTrackedDeviceIndexLeftHand		= 1;
+const uint32_t kTrackedDeviceIndexRightHand		= 2;
+
 class Exception : public ci::vr::Exception {
 public:
 	Exception() {}
@@ -43,6 +43,8 @@
 #if defined( CINDER_VR_ENABLE_OPENVR )
 
 #include <openvr.h>
+
+#include <atomic>
  
 namespace cinder { namespace vr { namespace openvr  {
 
@@ -72,8 +74,18 @@ public:
 
 	void											updatePoseData();
 	const ::vr::TrackedDevicePose_t&				getPose( ::vr::TrackedDeviceIndex_t deviceIndex ) const { return mPoses[deviceIndex]; }
-	const ci::mat4&									getDeviceToTrackingMatrix( ::vr::TrackedDeviceIndex_t deviceIndex ) const { return mDeviceToTrackingMatrices[deviceIndex]; }
-	const ci::mat4&									getTrackingToDeviceMatrix( ::vr::TrackedDeviceIndex_t deviceIndex ) const { return mTrackingToDeviceMatrices[deviceIndex]; }
+	const ci::mat4&									getDeviceToTrackingMatrix( ::vr::TrackedDeviceIndex_t deviceIndex ) const { return mPoseStore.getDeviceToTrackingMatrix( deviceIndex ); }
+	const ci::mat4&									getTrackingToDeviceMatrix( ::vr::TrackedDeviceIndex_t deviceIndex ) const { return mPoseStore.getTrackingToDeviceMatrix( deviceIndex ); }
+
+	//! Time at which the poses returned by the last WaitGetPoses are expected to reach the display
+	double											getPredictedDisplayTime() const;
+
+	//! Device topology, cached and only refreshed by device activation and role events
+	::vr::ETrackedDeviceClass						getTrackedDeviceClass( ::vr::TrackedDeviceIndex_t deviceIndex ) const;
+	//! TYPE_LEFT or TYPE_RIGHT for hand controllers, TYPE_UNKNOWN otherwise
+	ci::vr::Controller::Type						getControllerType( ::vr::TrackedDeviceIndex_t deviceIndex ) const;
+	//! Bit per connected device of class TrackedDeviceClass_Controller, iterate with ci::vr::PoseStore::forEachDevice
+	uint64_t										getControllerMask() const { return mControllerMask; }
 
 protected:
 	Context( const ci::vr::SessionOptions& sessionOptions, ci::vr::openvr::DeviceManager* deviceManager );
@@ -83,6 +95,9 @@ protected:
 	virtual void						endSession() override;
 
 	virtual void						processEvents() override;
+	virtual void						sampleInput() override;
+	virtual void						pollInput( double time ) override;
+	virtual void						updateFrameStats( ci::vr::QualityGovernor::FrameStats* stats ) override;
 	virtual void						processTrackedDeviceEvents( const ::vr::VREvent_t &event );
 
 private:
@@ -90,14 +105,37 @@ private:
 	::vr::IVRSystem						*mVrSystem = nullptr;
 	
 	std::vector<::vr::TrackedDevicePose_t>	mPoses;
-	std::vector<ci::mat4>					mDeviceToTrackingMatrices;
-	std::vector<ci::mat4>					mTrackingToDeviceMatrices;
+	std::vector<ci::mat4>					mPoseMatrices;
+	double									mFrameDuration = 1.0 / 90.0;
+	double									mVsyncToPhotons = 0.0;
+	uint32_t								mPrevNumDroppedFrames = 0;
+	uint32_t								mPrevNumReprojectedFrames = 0;
+
+	std::vector<::vr::ETrackedDeviceClass>	mDeviceClasses;
+	std::vector<ci::vr::Controller::Type>	mControllerTypes;
+	uint64_t								mControllerMask = 0;
 
 	//// Don't rename it this to mControllers - mControllers already exists in the base class.
 	//ci::vr::openvr::ControllerRef		mViveControllers[ci::vr::Controller::HAND_COUNT];
 	std::map<ci::vr::Controller::Type, ci::vr::openvr::ControllerRef>	mViveControllers;
 
+	// Controller state read by the input thread, converted on the main thread in sampleInput()
+	struct PolledInput {
+		double								time;
+		::vr::TrackedDeviceIndex_t			deviceIndex;
+		::vr::VRControllerState_t			state;
+	};
+
+	std::unique_ptr<ci::vr::SpscRing<PolledInput>>	mPolledInputs;
+	//! Devices of the enabled hand controllers, written by drainPolledInput() for pollInput()
+	std::atomic<uint64_t>					mPollDevices;
+	//! Input thread only, packet number of the last state pushed per device
+	std::vector<uint32_t>					mPolledPacketNums;
+	void									drainPolledInput();
+
 	void								updateControllerConnections();
+	void								updateTrackedDevice( ::vr::TrackedDeviceIndex_t deviceIndex );
+	void								updateTrackedDevices();
 };
 
 }}} // namespace cinder::vr::vive
@@ -39,6 +39,7 @@
 #pragma once
 
 #include "cinder/vr/Controller.h"
+#include "cinder/vr/InputThread.h"
 
 #if defined( CINDER_VR_ENABLE_OPENVR )
 
@@ -73,8 +74,6 @@ public:
 
 	virtual bool							hasInputRay() const override { return mEventsEnabled ? true : false; }
 
-	::vr::TrackedDeviceIndex_t				getTrackedDeviceIndex() const { return mTrackedDeviceIndex; }
-
 	virtual ::vr::EVRButtonId				toOpenVr( ci::vr::Controller::ButtonId value ) const;
 	virtual ci::vr::Controller::ButtonId	fromOpenVr( ::vr::EVRButtonId value ) const;
 
@@ -86,6 +85,8 @@ protected:
 	virtual void							processButtons( const ::vr::VRControllerState_t& state );
 	virtual void							processTriggers( const ::vr::VRControllerState_t& state );
 	virtual void							processAxes( const ::vr::VRControllerState_t& state );
+	//! Converts \a state read by the input thread at \a time without touching the controller's inputs
+	ci::vr::InputSample						toInputSample( double time, const ::vr::VRControllerState_t& state ) const;
 	virtual void							processControllerPose( const ci::mat4& inverseLookMatrix, const ci::mat4& inverseOriginMatrix, const ci::mat4& deviceToTrackingMatrix, const ci::mat4& trackingToDeviceMatrix );
 
 	bool									mEventsEnabled = false;
@@ -93,7 +94,6 @@ protected:
 	void									setEventsEnabled( bool value = true ) { mEventsEnabled = value; }
 	void									clearInputRay() { mInputRay = ci::Ray( ci::vec3( 0 ), ci::vec3(0 ) ); }
 
-	::vr::TrackedDeviceIndex_t				mTrackedDeviceIndex = UINT32_MAX;
 	//ci::vr::Controller::HandId				mHandId = ci::vr::Controller::HAND_UNKNOWN;
 
 	uint32_t								mPacketNum = UINT32_MAX;
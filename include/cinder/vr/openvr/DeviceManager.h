@@ -39,6 +39,8 @@
 #pragma once
 
 #include "cinder/vr/DeviceManager.h"
+#include "cinder/vr/openvr/DistortionMesh.h"
+#include "cinder/vr/openvr/RenderModelLoader.h"
 
 #if defined( CINDER_VR_ENABLE_OPENVR )
 
@@ -48,9 +50,6 @@
 
 namespace cinder { namespace vr { namespace openvr  {
 
-class RenderModelData;
-using RenderModelDataRef = std::shared_ptr<RenderModelData>;
-
 class DeviceManager;
 using DeviceManagerRef = std::shared_ptr<DeviceManager>;
 
@@ -63,7 +62,11 @@ public:
 	virtual ~DeviceManager();
 
 	::vr::IVRSystem*					getVrSystem() const { return mVrSystem; }
+	//! Never blocks, returns nullptr and queues \a renderModelName for loading if it isn't ready yet
 	ci::vr::openvr::RenderModelDataRef	getRenderModelData( const std::string& renderModelName ) const;
+	ci::vr::openvr::RenderModelLoader*	getRenderModelLoader() const { return mRenderModelLoader.get(); }
+	//! Built or loaded once per grid size and shared by every context
+	ci::vr::openvr::DistortionMeshRef	getDistortionMesh( uint32_t gridSize );
 
 	virtual void						initialize();
 	virtual void						destroy();
@@ -75,7 +78,8 @@ private:
 	std::string							mDriverName;
 	std::string							mDisplayName;
 
-	mutable std::map<std::string, RenderModelDataRef>	mRenderModelData;
+	ci::vr::openvr::RenderModelLoaderRef	mRenderModelLoader;
+	std::map<uint32_t, ci::vr::openvr::DistortionMeshRef>	mDistortionMeshes;
 };
 
 }}} // namespace cinder::vr::vive
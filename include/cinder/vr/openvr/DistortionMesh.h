@@ -0,0 +1,103 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/openvr/OpenVr.h"
+#include "cinder/Filesystem.h"
+
+#if defined( CINDER_VR_ENABLE_OPENVR )
+
+namespace cinder { namespace vr { namespace openvr  {
+
+class DistortionMesh;
+using DistortionMeshRef = std::shared_ptr<DistortionMesh>;
+
+const uint32_t kDistortionMeshVersion		= 1;
+const uint32_t kDistortionMeshMinGridSize	= 2;
+//! Both eyes have to fit 16-bit indices
+const uint32_t kDistortionMeshMaxGridSize	= 128;
+
+//! \class DistortionMesh
+//!
+//! Lens distortion grid for both eyes, used to draw the mirror. Built from
+//! IVRSystem::ComputeDistortion on worker threads, or read back from a cache file keyed by
+//! the HMD serial number, driver version and grid size.
+//!
+class DistortionMesh {
+public:
+	struct Vertex {
+		ci::vec2	position;
+		ci::vec2	texCoordRed;
+		ci::vec2	texCoordGreen;
+		ci::vec2	texCoordBlue;
+	};
+
+	virtual ~DistortionMesh() {}
+
+	//! \a gridSize is the number of vertices per side for each eye. Caching is off if \a cacheDirectory is empty.
+	static DistortionMeshRef			create( ::vr::IVRSystem *vrSystem, uint32_t gridSize, const ci::fs::path& cacheDirectory = ci::fs::path() );
+
+	uint32_t							getGridSize() const { return mGridSize; }
+	bool								isFromCache() const { return mFromCache; }
+	const std::vector<Vertex>&			getVertices() const { return mVertices; }
+	const std::vector<uint16_t>&		getIndices() const { return mIndices; }
+	//! Indices per eye, the left eye's come first
+	uint32_t							getEyeIndexCount() const { return static_cast<uint32_t>( mIndices.size() / 2 ); }
+
+	//! Created on first use, needs the GL context
+	const ci::gl::VboMeshRef&			getVboMesh();
+
+private:
+	DistortionMesh( ::vr::IVRSystem *vrSystem, uint32_t gridSize, const ci::fs::path& cacheDirectory );
+
+	uint32_t							mGridSize = 0;
+	bool								mFromCache = false;
+	std::vector<Vertex>					mVertices;
+	std::vector<uint16_t>				mIndices;
+	ci::gl::VboMeshRef					mVboMesh;
+
+	void								computeVertices( ::vr::IVRSystem *vrSystem );
+	void								computeIndices();
+	bool								load( const ci::fs::path& path, uint64_t key );
+	void								store( const ci::fs::path& path, uint64_t key ) const;
+};
+
+}}} // namespace cinder::vr::vive
+
+#endif // defined( CINDER_VR_ENABLE_OPENVR )
@@ -79,6 +79,8 @@ public:
 
 	virtual float						getFullFov() const;
 
+	virtual double						getPredictedDisplayTime() const override;
+
 	virtual ci::Area					getEyeViewport( ci::vr::Eye eye ) const override;
 
 	virtual	void						enableEye( ci::vr::Eye eye, ci::vr::CoordSys eyeMatrixMode = ci::vr::COORD_SYS_WORLD ) override;
@@ -125,11 +127,14 @@ private:
 
 	ci::gl::FboRef						mRenderTargetLeft;
 	ci::gl::FboRef						mRenderTargetRight;
+	// Both eyes side by side, replaces the per eye targets with ci::vr::STEREO_MODE_INSTANCED
+	ci::gl::FboRef						mRenderTargetStereo;
 
 	uint32_t							mDistortionIndexCount = 0;
 	ci::gl::BatchRef					mDistortionBatch;
 
 	std::vector<RenderModelRef>			mRenderModels;
+	std::vector<std::string>			mRenderModelNames;
 	std::map<ci::vr::Controller::Type, ci::gl::BatchRef> mControllerIconBatch;
 
 	uint32_t							mControllerCount = 0;
@@ -137,6 +142,10 @@ private:
 	ci::gl::VboRef						mControllerVbo;
 	ci::gl::BatchRef					mControllerBatch;
 
+	ci::vr::GpuSync						mGpuSync = ci::vr::GPU_SYNC_FINISH;
+	GLuint64							mGpuSyncTimeoutNs = 0;
+	GLsync								mGpuFence = nullptr;
+
 	void								setupShaders();
 	void								setupMatrices();
 	void								setupStereoRenderTargets();
@@ -144,8 +153,15 @@ private:
 	void								setupRenderModels();
 	void								setupCompositor();
 
+	//! Resolved color texture holding \a eye and the area it covers
+	ci::gl::Texture2dRef				getEyeTexture( ci::vr::Eye eye, ci::Area *outArea ) const;
+
 	void								updatePoseData();
 	void								updateControllerGeometry();
+	void								updateRenderModels();
+
+	void								syncGpu();
+	void								waitGpuFence();
 };
 
 }}} // namespace cinder::vr::vive
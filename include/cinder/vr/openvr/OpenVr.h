@@ -71,12 +71,12 @@ public:
 class RenderModelData {
 public:
 	virtual ~RenderModelData() {}
-	static RenderModelDataRef			create( const std::string& name, ::vr::RenderModel_t* model, ::vr::RenderModel_TextureMap_t* texture );
+	static RenderModelDataRef			create( const std::string& name, const ci::gl::VboMeshRef& vboMesh, const ci::gl::Texture2dRef& texture );
 	const std::string&					getName() const { return mName; }
 	const ci::gl::VboMeshRef			getVboMesh() const { return mVboMesh; }
 	const ci::gl::Texture2dRef&			getTexture() const { return mTexture; }
 private:
-	RenderModelData( const std::string& name, ::vr::RenderModel_t* model, ::vr::RenderModel_TextureMap_t* texture );
+	RenderModelData( const std::string& name, const ci::gl::VboMeshRef& vboMesh, const ci::gl::Texture2dRef& texture );
 	std::string							mName;
 	ci::gl::VboMeshRef					mVboMesh;
 	ci::gl::Texture2dRef				mTexture;
@@ -119,6 +119,11 @@ inline ci::mat4 fromOpenVr( const ::vr::HmdMatrix44_t& m )
 	);
 }
 
+inline ci::vec3 fromOpenVr( const ::vr::HmdVector3_t& v )
+{
+	return ci::vec3( v.v[0], v.v[1], v.v[2] );
+}
+
 inline ci::vec3 getTranslate( const ::vr::HmdMatrix34_t& m )
 {
 	return ci::vec3( m.m[0][3], m.m[1][3], m.m[2][3] );
@@ -0,0 +1,120 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/MappedFile.h"
+#include "cinder/vr/openvr/OpenVr.h"
+
+#if defined( CINDER_VR_ENABLE_OPENVR )
+
+namespace cinder { namespace vr { namespace openvr  {
+
+class RenderModelCache;
+using RenderModelCacheRef = std::shared_ptr<RenderModelCache>;
+
+const uint32_t kRenderModelCacheVersion = 1;
+
+//! Cache file layout: one RenderModelCacheHeader followed by the vertex, index and texture data
+//! at the recorded offsets. Textures are stored as DXT5 blocks.
+struct RenderModelCacheHeader {
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	headerSize;
+	//! Hash of the render model name and the runtime version the entry was built with
+	uint64_t	key;
+	uint32_t	numVertices;
+	uint32_t	numIndices;
+	uint32_t	textureWidth;
+	uint32_t	textureHeight;
+	uint32_t	vertexOffset;
+	uint32_t	indexOffset;
+	uint32_t	textureOffset;
+	uint32_t	textureSize;
+	uint32_t	reserved[2];
+};
+
+//! Vertex, index and DXT5 texture data of a render model. Doesn't own the memory it points to.
+struct RenderModelBuffers {
+	const ::vr::RenderModel_Vertex_t	*vertices = nullptr;
+	uint32_t							numVertices = 0;
+	const uint16_t						*indices = nullptr;
+	uint32_t							numIndices = 0;
+	const uint8_t						*texture = nullptr;
+	uint32_t							textureSize = 0;
+	uint32_t							textureWidth = 0;
+	uint32_t							textureHeight = 0;
+};
+
+//! \class RenderModelCache
+//!
+//! Directory of memory mappable render model files, one per model. Entries written by a
+//! different runtime version are treated as misses and replaced on the next store().
+//!
+class RenderModelCache {
+public:
+	virtual ~RenderModelCache() {}
+
+	//! Throws ci::vr::openvr::Exception if \a directory can't be created.
+	static RenderModelCacheRef			create( const ci::fs::path& directory, const std::string& runtimeVersion );
+
+	const ci::fs::path&					getDirectory() const { return mDirectory; }
+
+	//! Maps the entry for \a renderModelName and points \a outBuffers into the mapping. Returns nullptr on a miss.
+	ci::vr::MappedFileRef				load( const std::string& renderModelName, RenderModelBuffers *outBuffers ) const;
+	//! Writes \a buffers as the entry for \a renderModelName. Returns false if the file couldn't be written.
+	bool								store( const std::string& renderModelName, const RenderModelBuffers& buffers ) const;
+
+private:
+	RenderModelCache( const ci::fs::path& directory, const std::string& runtimeVersion );
+
+	ci::fs::path						mDirectory;
+	std::string							mRuntimeVersion;
+
+	ci::fs::path						getEntryPath( const std::string& renderModelName ) const;
+	uint64_t							getKey( const std::string& renderModelName ) const;
+};
+
+//! Bytes needed for the DXT5 blocks of a \a width x \a height image
+size_t	getDxt5Size( uint32_t width, uint32_t height );
+//! Compresses \a width x \a height RGBA8 pixels into \a out, which must hold getDxt5Size() bytes.
+void	compressDxt5( const uint8_t *rgba, uint32_t width, uint32_t height, uint8_t *out );
+
+}}} // namespace cinder::vr::vive
+
+#endif // defined( CINDER_VR_ENABLE_OPENVR )
@@ -0,0 +1,110 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/openvr/RenderModelCache.h"
+
+#if defined( CINDER_VR_ENABLE_OPENVR )
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace cinder { namespace vr { namespace openvr  {
+
+class RenderModelLoader;
+using RenderModelLoaderRef = std::shared_ptr<RenderModelLoader>;
+
+//! \class RenderModelLoader
+//!
+//! Loads render models without blocking the calling thread. A worker thread polls the
+//! runtime's async loaders and copies the finished geometry and texture. update() then
+//! uploads them to GL in small steps on the GL thread. Everything but the worker runs on
+//! the GL thread. With a cache, models are mapped from disk instead of loaded from the
+//! runtime, and textures are uploaded DXT5 compressed either way.
+//!
+class RenderModelLoader {
+public:
+	virtual ~RenderModelLoader();
+
+	//! \a cache can be null to always load from the runtime
+	static RenderModelLoaderRef			create( const ci::vr::openvr::RenderModelCacheRef& cache = ci::vr::openvr::RenderModelCacheRef() );
+
+	const ci::vr::openvr::RenderModelCacheRef&	getCache() const { return mCache; }
+
+	//! Queues \a renderModelName for loading. Names that are loading or already loaded are ignored.
+	void								request( const std::string& renderModelName );
+	//! Returns nullptr until \a renderModelName has been uploaded, or if it failed to load.
+	ci::vr::openvr::RenderModelDataRef	getRenderModelData( const std::string& renderModelName ) const;
+	bool								isLoading( const std::string& renderModelName ) const;
+
+	//! Uploads loaded models until \a budgetSeconds has been used, always makes at least one step of progress.
+	void								update( double budgetSeconds );
+
+private:
+	RenderModelLoader( const ci::vr::openvr::RenderModelCacheRef& cache );
+
+	struct Source;
+	struct Upload;
+	using SourceRef = std::shared_ptr<Source>;
+
+	ci::vr::openvr::RenderModelCacheRef	mCache;
+	std::thread							mThread;
+	std::mutex							mMutex;
+	std::condition_variable				mCondition;
+	bool								mRunning = true;
+	std::deque<std::string>				mRequests;
+	std::deque<SourceRef>				mLoaded;
+
+	std::set<std::string>								mLoading;
+	std::map<std::string, RenderModelDataRef>			mRenderModelData;
+	std::shared_ptr<Upload>								mUpload;
+
+	void								threadProc();
+	bool								pollSource( Source *source );
+	void								releaseSource( Source *source );
+	void								uploadStep();
+};
+
+}}} // namespace cinder::vr::vive
+
+#endif // defined( CINDER_VR_ENABLE_OPENVR )
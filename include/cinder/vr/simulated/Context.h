@@ -0,0 +1,100 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Context.h"
+#include "cinder/vr/simulated/Simulated.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+namespace cinder { namespace vr { namespace simulated  {
+
+class DeviceManager;
+class Hmd;
+
+class Context;
+class Controller;
+using ContextRef = std::shared_ptr<Context>;
+using ControllerRef = std::shared_ptr<Controller>;
+
+//! \class Context
+//!
+//!
+class Context : public ci::vr::Context {
+public:
+
+	virtual ~Context();
+
+	static ContextRef					create( const ci::vr::SessionOptions& sessionOptions, ci::vr::simulated::DeviceManager* deviceManager );
+
+	ci::vr::simulated::DeviceManager	*getDeviceManager() const { return mDeviceManager; }
+	const ci::vr::simulated::CompositorRef&	getCompositor() const { return mCompositor; }
+
+	virtual void						scanForControllers() override;
+
+	const ci::mat4&						getDeviceToTrackingMatrix( uint32_t deviceIndex ) const { return mPoseStore.getDeviceToTrackingMatrix( deviceIndex ); }
+	const ci::mat4&						getTrackingToDeviceMatrix( uint32_t deviceIndex ) const { return mPoseStore.getTrackingToDeviceMatrix( deviceIndex ); }
+
+protected:
+	Context( const ci::vr::SessionOptions& sessionOptions, ci::vr::simulated::DeviceManager* deviceManager );
+	friend class ci::vr::Environment;
+	friend class ci::vr::simulated::Hmd;
+
+	virtual void						beginSession() override;
+	virtual void						endSession() override;
+
+	virtual void						processEvents() override;
+	virtual void						updateFrameStats( ci::vr::QualityGovernor::FrameStats* stats ) override;
+
+	//! Refreshes the pose store for the compositor's predicted display time and poses the controllers
+	virtual void						updatePoseData();
+	//! Fills the pose store for \a sampleTime, from calculateDevicePose() by default
+	virtual void						updatePoseStore( double sampleTime );
+	virtual ci::mat4					calculateDevicePose( uint32_t deviceIndex, double t ) const;
+
+	ci::vr::simulated::CompositorRef	mCompositor;
+	uint64_t							mPrevNumDroppedFrames = 0;
+
+private:
+	ci::vr::simulated::DeviceManager	*mDeviceManager = nullptr;
+};
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
@@ -0,0 +1,88 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Controller.h"
+#include "cinder/vr/Recording.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+namespace cinder { namespace vr { namespace simulated  {
+
+class Context;
+class ReplayContext;
+
+class Controller;
+using ControllerRef = std::shared_ptr<Controller>;
+
+//! \class Controller
+//!
+//! Synthetic hand controller with a Vive-like layout: four buttons, one trigger and one axis.
+//!
+class Controller : public vr::Controller {
+public:
+
+	virtual ~Controller();
+
+	static ci::vr::simulated::ControllerRef	create( ci::vr::Controller::Type type, ci::vr::Context *context );
+
+	virtual std::string						getName() const override;
+
+	virtual std::string						getButtonName( ci::vr::Controller::ButtonId id ) const override;
+	virtual std::string						getTriggerName( ci::vr::Controller::TriggerId id ) const override;
+	virtual std::string						getAxisName( ci::vr::Controller::AxisId id ) const override;
+
+	virtual bool							hasInputRay() const override { return true; }
+
+protected:
+	Controller( ci::vr::Controller::Type type, ci::vr::Context *context );
+	friend class ci::vr::simulated::Context;
+	friend class ci::vr::simulated::ReplayContext;
+
+	//! Sets the pose and recalculates the input ray against the HMD's origin and look matrices.
+	virtual void							processControllerPose( const ci::mat4& deviceToTrackingMatrix, const ci::mat4& coordSysMatrix );
+	//! Drives buttons, trigger and axis from a deterministic pattern at simulated time \a t.
+	virtual void							processSyntheticInput( double t );
+	//! Applies the input state of one recorded frame. Inputs missing from this layout are added on first use.
+	virtual void							processRecordedInput( const ci::vr::RecordedController& recorded );
+};
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
@@ -0,0 +1,123 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/DeviceManager.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+namespace cinder { namespace vr { namespace simulated  {
+
+class DeviceManager;
+using DeviceManagerRef = std::shared_ptr<DeviceManager>;
+
+//! \class DeviceManager
+//!
+//! Headless device that needs no hardware or vendor runtime. Register it explicitly:
+//!
+//!   ci::vr::registerDevice( ci::vr::API_SIMULATED, new ci::vr::simulated::DeviceManager( nullptr ), true );
+//!   auto vrContext = ci::vr::beginSession( ci::vr::SessionOptions(), ci::vr::API_SIMULATED );
+//!
+class DeviceManager : public ci::vr::DeviceManager {
+public:
+
+	//! \class Options
+	//!
+	//!
+	class Options {
+	public:
+		Options() {}
+		virtual ~Options() {}
+
+		//! Simulated display refresh rate, typically 90, 120 or 144 Hz.
+		float							getRefreshRate() const { return mRefreshRate; }
+		Options&						setRefreshRate( float value ) { mRefreshRate = value; return *this; }
+
+		//! Throttled compositors block in submitFrame until the next simulated vsync. Unthrottled
+		//! compositors return immediately and advance simulated time by one frame per submit.
+		bool							getThrottled() const { return mThrottled; }
+		Options&						setThrottled( bool value ) { mThrottled = value; return *this; }
+
+		//! Size of the side by side render target for both eyes.
+		const ci::ivec2&				getRenderTargetSize() const { return mRenderTargetSize; }
+		Options&						setRenderTargetSize( const ci::ivec2& value ) { mRenderTargetSize = value; return *this; }
+
+		//! Full field of view (in degrees)
+		float							getFov() const { return mFov; }
+		Options&						setFov( float value ) { mFov = value; return *this; }
+
+		float							getIpd() const { return mIpd; }
+		Options&						setIpd( float value ) { mIpd = value; return *this; }
+
+		bool							getControllersEnabled() const { return mControllersEnabled; }
+		Options&						setControllersEnabled( bool value ) { mControllersEnabled = value; return *this; }
+
+		//! Synthetic head and controller motion and input. Poses stay at rest when disabled.
+		bool							getMotionEnabled() const { return mMotionEnabled; }
+		Options&						setMotionEnabled( bool value ) { mMotionEnabled = value; return *this; }
+
+	private:
+		float							mRefreshRate = 90.0f;
+		bool							mThrottled = true;
+		ci::ivec2						mRenderTargetSize = ci::ivec2( 2160, 1200 );
+		float							mFov = 110.0f;
+		float							mIpd = 0.064f;
+		bool							mControllersEnabled = true;
+		bool							mMotionEnabled = true;
+	};
+
+	DeviceManager( ci::vr::Environment *env, const Options& options = Options() );
+	virtual ~DeviceManager();
+
+	const Options&						getOptions() const { return mOptions; }
+
+	virtual void						initialize();
+	virtual void						destroy();
+	virtual uint32_t					numDevices() const;
+	virtual ci::vr::ContextRef			createContext( const ci::vr::SessionOptions& sessionOptions, uint32_t deviceIndex );
+
+protected:
+	DeviceManager( ci::vr::Api api, const std::string& deviceVendorName, ci::vr::Environment *env, const Options& options );
+
+	Options								mOptions;
+};
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
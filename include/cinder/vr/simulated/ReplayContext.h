@@ -0,0 +1,102 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/simulated/Context.h"
+#include "cinder/vr/Recording.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+namespace cinder { namespace vr { namespace simulated  {
+
+class ReplayDeviceManager;
+
+class ReplayContext;
+using ReplayContextRef = std::shared_ptr<ReplayContext>;
+
+//! \class ReplayContext
+//!
+//! Plays back a ci::vr::Recording through the simulated compositor. The pose store is restored
+//! with every recorded device, input is replayed for the left and right hand controllers.
+//!
+class ReplayContext : public ci::vr::simulated::Context {
+public:
+
+	virtual ~ReplayContext();
+
+	static ReplayContextRef				create( const ci::vr::SessionOptions& sessionOptions, ci::vr::simulated::ReplayDeviceManager* deviceManager );
+
+	ci::vr::simulated::ReplayDeviceManager	*getReplayDeviceManager() const { return mReplayDeviceManager; }
+
+	virtual void						scanForControllers() override;
+
+	//! Index of the recorded frame currently being shown
+	uint32_t							getFrameIndex() const { return mFrameIndex; }
+	//! True once a non-looping replay has reached its last frame
+	bool								isFinished() const { return mFinished; }
+
+protected:
+	ReplayContext( const ci::vr::SessionOptions& sessionOptions, ci::vr::simulated::ReplayDeviceManager* deviceManager );
+	friend class ci::vr::Environment;
+
+	virtual void						beginSession() override;
+
+	virtual void						processEvents() override;
+
+	virtual void						updatePoseData() override;
+	//! Restores the pose store of the current frame, sample times are moved to \a sampleTime's base
+	virtual void						updatePoseStore( double sampleTime ) override;
+	//! Returns the pose stored in the current frame, \a t is ignored.
+	virtual ci::mat4					calculateDevicePose( uint32_t deviceIndex, double t ) const override;
+
+	const ci::vr::RecordedController*	findRecordedController( ci::vr::Controller::Type type ) const;
+
+private:
+	ci::vr::simulated::ReplayDeviceManager	*mReplayDeviceManager = nullptr;
+	ci::vr::RecordingRef				mRecording;
+
+	uint32_t							mFrameIndex = 0;
+	bool								mFinished = false;
+	uint64_t							mNumUpdates = 0;
+	double								mStartTime = 0;
+};
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
@@ -0,0 +1,108 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/simulated/DeviceManager.h"
+#include "cinder/vr/Recording.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+namespace cinder { namespace vr { namespace simulated  {
+
+class ReplayDeviceManager;
+using ReplayDeviceManagerRef = std::shared_ptr<ReplayDeviceManager>;
+
+//! \class ReplayDeviceManager
+//!
+//! Simulated device driven by a file written with ci::vr::Context::startRecording(). Replays
+//! the recorded HMD and hand controller poses along with their buttons, triggers and axes:
+//!
+//!   ci::vr::registerDevice( ci::vr::API_SIMULATED, new ci::vr::simulated::ReplayDeviceManager( nullptr, "session.vrrec" ), true );
+//!   auto vrContext = ci::vr::beginSession( ci::vr::SessionOptions(), ci::vr::API_SIMULATED );
+//!
+class ReplayDeviceManager : public ci::vr::simulated::DeviceManager {
+public:
+
+	//! \class ReplayOptions
+	//!
+	//!
+	class ReplayOptions {
+	public:
+		ReplayOptions() {}
+		virtual ~ReplayOptions() {}
+
+		//! Playback rate relative to the recording. Ignored when frame locked.
+		float							getSpeed() const { return mSpeed; }
+		ReplayOptions&					setSpeed( float value ) { mSpeed = value; return *this; }
+
+		//! Frame locked playback advances exactly one recorded frame per submitted frame,
+		//! independent of timing. Use it for repeatable test and benchmark runs.
+		bool							getFrameLocked() const { return mFrameLocked; }
+		ReplayOptions&					setFrameLocked( bool value ) { mFrameLocked = value; return *this; }
+
+		//! Restart from the first frame after the last one. Otherwise the last frame is held.
+		bool							getLooping() const { return mLooping; }
+		ReplayOptions&					setLooping( bool value ) { mLooping = value; return *this; }
+
+	private:
+		float							mSpeed = 1.0f;
+		bool							mFrameLocked = false;
+		bool							mLooping = false;
+	};
+
+	ReplayDeviceManager( ci::vr::Environment *env, const ci::fs::path& path, const ReplayOptions& replayOptions = ReplayOptions(), const Options& options = Options() );
+	virtual ~ReplayDeviceManager();
+
+	const ci::fs::path&					getPath() const { return mPath; }
+	const ReplayOptions&				getReplayOptions() const { return mReplayOptions; }
+	const ci::vr::RecordingRef&			getRecording() const { return mRecording; }
+
+	virtual void						initialize() override;
+	virtual void						destroy() override;
+	virtual ci::vr::ContextRef			createContext( const ci::vr::SessionOptions& sessionOptions, uint32_t deviceIndex ) override;
+
+private:
+	ci::fs::path						mPath;
+	ReplayOptions						mReplayOptions;
+	ci::vr::RecordingRef				mRecording;
+};
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
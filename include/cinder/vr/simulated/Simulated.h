@@ -0,0 +1,118 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/vr/Platform.h"
+#include "cinder/gl/Fbo.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+#include <chrono>
+
+namespace cinder { namespace vr { namespace simulated  {
+
+class Compositor;
+using CompositorRef = std::shared_ptr<Compositor>;
+
+const uint32_t kTrackedDeviceIndexHmd			= 0;
+const uint32_t kTrackedDeviceIndexLeftHand		= 1;
+const uint32_t kTrackedDeviceIndexRightHand		= 2;
+const uint32_t kMaxTrackedDeviceCount			= 3;
+
+//! \class Exception
+//!
+//!
+class Exception : public ci::vr::Exception {
+public:
+	Exception() {}
+	Exception( const std::string& msg ) : ci::vr::Exception( msg ) {}
+	virtual ~Exception() {}
+};
+
+//! \class Compositor
+//!
+//! Stand-in for a vendor compositor. Consumes the submitted eye render target by blitting it
+//! into its own buffer and paces frames against a simulated vsync at the configured refresh rate.
+//!
+class Compositor {
+public:
+	virtual ~Compositor() {}
+
+	static CompositorRef				create( float refreshRate, bool throttled );
+
+	float								getRefreshRate() const { return mRefreshRate; }
+	double								getFrameDuration() const { return mFrameDuration; }
+	bool								isThrottled() const { return mThrottled; }
+
+	//! Copies \a renderTarget into the compositor's buffer.
+	void								submit( const ci::gl::FboRef& renderTarget );
+	//! Blocks until the next vsync if throttled. Returns the predicted display time of the next frame.
+	double								waitGetPoses();
+
+	//! Simulated time in seconds since the compositor started.
+	double								getTimeInSeconds() const;
+	double								getPredictedDisplayTime() const { return mPredictedDisplayTime; }
+
+	uint64_t							getFrameIndex() const { return mFrameIndex; }
+	uint64_t							getNumFramePresents() const { return mNumFramePresents; }
+	uint64_t							getNumDroppedFrames() const { return mNumDroppedFrames; }
+
+	const ci::gl::FboRef&				getOutput() const { return mOutput; }
+
+private:
+	Compositor( float refreshRate, bool throttled );
+
+	using Clock = std::chrono::steady_clock;
+
+	float								mRefreshRate = 90.0f;
+	double								mFrameDuration = 1.0 / 90.0;
+	bool								mThrottled = true;
+
+	Clock::time_point					mStartTime;
+	uint64_t							mFrameIndex = 0;
+	uint64_t							mNumFramePresents = 0;
+	uint64_t							mNumDroppedFrames = 0;
+	double								mPredictedDisplayTime = 0;
+
+	ci::gl::FboRef						mOutput;
+};
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
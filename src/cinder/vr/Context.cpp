@@ -39,6 +39,7 @@
 #include "cinder/vr/Context.h"
 #include "cinder/vr/Controller.h"
 #include "cinder/vr/DeviceManager.h"
+#include "cinder/vr/Hmd.h"
 #include "cinder/app/App.h"
 #include "cinder/gl/Texture.h"
 #include "cinder/ImageIo.h"
@@ -49,6 +50,9 @@
 
 namespace cinder { namespace vr {
 
+// Frames the GPU time is averaged over for the quality governor
+const uint32_t kGovernorGpuFrames = 4;
+
 Context::Context( const ci::vr::SessionOptions& sessionOptions, ci::vr::DeviceManager* deviceManager )
 	: mSessionOptions( sessionOptions ), mDeviceManager( deviceManager )
 {
@@ -63,11 +67,19 @@ Context::Context( const ci::vr::SessionOptions& sessionOptions, ci::vr::DeviceMa
 		mSignalControllerDisconnected.connect( mSessionOptions.getControllerDisconnected() );
 	}
 
+	mQualityGovernor = ci::vr::QualityGovernor::create();
+
+	if( mSessionOptions.isControllerEventQueueEnabled() ) {
+		mControllerEventQueue = ci::vr::ControllerEventQueue::create();
+	}
+
 	ci::app::App::get()->getSignalUpdate().connect( std::bind( &Context::update, this ) );
 }
 
 Context::~Context()
 {
+	// Backends stop it in endSession(), this only catches a backend that forgot
+	stopInputThread();
 }
 
 ci::vr::Api Context::getApi() const
@@ -132,6 +144,87 @@ void Context::update()
 	}
 
 	processEvents();
+
+	// Sample controller input, independent of how many events were processed. With the input
+	// thread running this drains its samples, so it runs every update.
+	mInputSamples.clear();
+	{
+		double dt = currentTime - mPrevInputSampleTime;
+		double interval = mSessionOptions.getInputSampleInterval();
+		if( mInputThread || ( interval <= 0.0 ) || ( dt >= interval ) ) {
+			sampleInput();
+			mPrevInputSampleTime = currentTime;
+		}
+	}
+
+	// Deliver the input queued while polling
+	if( mControllerEventQueue ) {
+		mControllerEventQueue->dispatch();
+	}
+
+	// Publish input snapshots for other threads
+	++mPublishSequence;
+	for( auto& controller : mControllers ) {
+		controller->publishState( mPublishSequence, currentTime );
+	}
+
+	if( mRecorder ) {
+		mRecorder->record( currentTime - mRecordingStartTime, mHmd.get(), mPoseStore, mControllers );
+	}
+
+	// Step the quality knobs and emit the frame stats once per submitted frame
+	if( mHmd && mQualityGovernor->hasListeners() ) {
+		uint64_t numFrames = mHmd->getFrameTiming()->getNumFrames();
+		if( numFrames != mPrevGovernedFrame ) {
+			ci::vr::QualityGovernor::FrameStats stats;
+			updateFrameStats( &stats );
+			mQualityGovernor->update( stats );
+			mPrevGovernedFrame = numFrames;
+		}
+	}
+}
+
+void Context::updateFrameStats( ci::vr::QualityGovernor::FrameStats* stats )
+{
+	float frameRate = mSessionOptions.getFrameRate();
+	stats->budgetSeconds = ( frameRate > 0.0f ) ? ( 1.0 / static_cast<double>( frameRate ) ) : 0.0;
+
+	auto gpu = mHmd->getFrameTiming()->getStats( ci::vr::FrameTiming::PHASE_GPU_FRAME, kGovernorGpuFrames );
+	if( gpu.numFrames > 0 ) {
+		stats->gpuSeconds = gpu.mean / 1000.0;
+	}
+}
+
+void Context::startInputThread()
+{
+	double rate = mSessionOptions.getInputPollRate();
+	if( mInputThread || ( rate <= 0.0 ) ) {
+		return;
+	}
+
+	mInputThread = ci::vr::InputThread::create( rate, std::bind( &Context::pollInput, this, std::placeholders::_1 ) );
+}
+
+void Context::stopInputThread()
+{
+	// Joins the thread
+	mInputThread.reset();
+}
+
+void Context::startRecording( const ci::fs::path& path )
+{
+	stopRecording();
+
+	mRecorder = ci::vr::Recorder::create( path, getApi() );
+	mRecordingStartTime = ci::app::getElapsedSeconds();
+}
+
+void Context::stopRecording()
+{
+	if( mRecorder ) {
+		mRecorder->close();
+		mRecorder.reset();
+	}
 }
 
 void Context::addController( const ci::vr::ControllerRef& controller )
@@ -160,6 +253,10 @@ void Context::removeController( const ci::vr::ControllerRef& controller )
 		return;
 	}
 
+	if( mControllerEventQueue ) {
+		mControllerEventQueue->discard( controller.get() );
+	}
+
 	mControllers.erase(
 		std::remove_if( std::begin( mControllers ), std::end( mControllers ),
 			[controller]( const ci::vr::ControllerRef& elem ) -> bool {
@@ -37,14 +37,55 @@
  */
 
 #include "cinder/vr/Controller.h"
+#include "cinder/vr/ControllerEventQueue.h"
+#include "cinder/vr/ControllerState.h"
 #include "cinder/vr/Context.h"
+#include "cinder/vr/Hmd.h"
 #include "cinder/Signals.h"
 
 #include <algorithm>
 #include <sstream>
+#include <string>
 
 namespace cinder { namespace vr {
 
+namespace {
+
+inline uint32_t lowestBit( uint32_t mask )
+{
+	return mask & ( ~mask + 1 );
+}
+
+//! True when \a id is a single bit that's set in \a mask
+inline bool isInputSlot( uint32_t id, uint32_t mask )
+{
+	return ( 0 != ( id & mask ) ) && ( id == lowestBit( id ) );
+}
+
+uint32_t inputSlot( uint32_t id, uint32_t numSlots, const char *kind )
+{
+	if( ( 0 == id ) || ( id != lowestBit( id ) ) || ( ci::vr::countTrailingZeros( id ) >= numSlots ) ) {
+		throw ci::vr::Exception( std::string( "Invalid controller " ) + kind + " id: " + std::to_string( id ) );
+	}
+	return ci::vr::countTrailingZeros( id );
+}
+
+//! Shared pointer to an input that lives in its controller, for the deprecated create() wrappers
+template <typename T>
+std::shared_ptr<T> inputRef( T *input )
+{
+	return std::shared_ptr<T>( input, []( T* ) {} );
+}
+
+void checkInputController( const ci::vr::Controller *controller )
+{
+	if( nullptr == controller ) {
+		throw ci::vr::Exception( "Controller inputs must be created on a controller" );
+	}
+}
+
+} // anonymous namespace
+
 // -------------------------------------------------------------------------------------------------
 // Controller::ActionState
 // -------------------------------------------------------------------------------------------------
@@ -54,21 +95,30 @@ namespace cinder { namespace vr {
 // -------------------------------------------------------------------------------------------------
 ci::vr::Controller::ButtonRef Controller::Button::create( ci::vr::Controller::ButtonId id, ci::vr::Controller *controller )
 {
-	ci::vr::Controller::ButtonRef result = ci::vr::Controller::ButtonRef( new ci::vr::Controller::Button( id, controller ) );
+	checkInputController( controller );
+	ci::vr::Controller::ButtonRef result = inputRef( controller->addButton( id ) );
 	return result;
 }
 
 void Controller::Button::setState( ci::vr::Controller::State state )
 {
 	if( state != mState ) {
+		// Masks change before the signals so handlers see the new state
+		const uint32_t buttonMask = static_cast<uint32_t>( mId );
 		mState = state;
 		if( ci::vr::Controller::STATE_DOWN == mState ) {
+			mController->mButtonsDown |= buttonMask;
+			mController->mButtonsKnown |= buttonMask;
+			mController->mButtonsPressed |= buttonMask;
 			mController->getContext()->getSignalControllerButtonDown().emit( this );
-	}
+		}
 		else if( ci::vr::Controller::STATE_UP == mState ) {
+			mController->mButtonsDown &= ~buttonMask;
+			mController->mButtonsKnown |= buttonMask;
+			mController->mButtonsReleased |= buttonMask;
 			mController->getContext()->getSignalControllerButtonUp().emit( this );
 		}
-	}	
+	}
 }
 
 std::string Controller::Button::getInfo() const
@@ -84,22 +134,34 @@ std::string Controller::Button::getInfo() const
 // -------------------------------------------------------------------------------------------------
 ci::vr::Controller::TriggerRef Controller::Trigger::create( ci::vr::Controller::TriggerId id, ci::vr::Controller *controller, float minLim, float maxLim )
 {
-	ci::vr::Controller::TriggerRef result = ci::vr::Controller::TriggerRef( new ci::vr::Controller::Trigger( id, controller, minLim, maxLim ) );
+	checkInputController( controller );
+	ci::vr::Controller::TriggerRef result = inputRef( controller->addTrigger( id, minLim, maxLim ) );
 	return result;
 }
 
-void Controller::Trigger::setValue( float value )
+float Controller::Trigger::normalize( float value ) const
 {
 	value = std::max( mMinLimit, std::min( mMaxLimit, value ) );
 	value = ( value - mMinLimit ) / ( mMaxLimit - mMinLimit );
+	return value;
+}
+
+void Controller::Trigger::setValue( float value )
+{
+	value = normalize( value );
 
 	float delta = fabs( mValue - value );
 	if( ( delta > 0.0f ) || ( value > 0.0f ) ) {
-		mValue = value;
-		mController->getContext()->getSignalControllerTrigger().emit( this );
+		setNormalizedValue( value );
 	}
 }
 
+void Controller::Trigger::setNormalizedValue( float value )
+{
+	mValue = value;
+	mController->getContext()->getSignalControllerTrigger().emit( this );
+}
+
 std::string Controller::Trigger::getInfo() const
 {
 	std::stringstream ss; 
@@ -113,7 +175,8 @@ std::string Controller::Trigger::getInfo() const
 // -------------------------------------------------------------------------------------------------
 ci::vr::Controller::AxisRef Controller::Axis::create( ci::vr::Controller::AxisId id, ci::vr::Controller *controller )
 {
-	ci::vr::Controller::AxisRef result = ci::vr::Controller::AxisRef( new ci::vr::Controller::Axis( id, controller ) );
+	checkInputController( controller );
+	ci::vr::Controller::AxisRef result = inputRef( controller->addAxis( id ) );
 	return result;
 }
 
@@ -140,6 +203,7 @@ std::string Controller::Axis::getInfo() const
 Controller::Controller( ci::vr::Controller::Type type, ci::vr::Context *context )
 	: mContext( context ), mType( type )
 {
+	mStateBuffer = ci::vr::ControllerStateBuffer::create();
 }
 
 Controller::~Controller()
@@ -151,131 +215,157 @@ ci::vr::Api Controller::getApi() const
 	return mContext->getApi();
 }
 
-ci::vr::Controller::Button* Controller::getButton( ci::vr::Controller::ButtonId id )
+ci::mat4 Controller::getPredictedDeviceToTrackingMatrix() const
 {
-	ci::vr::Controller::Button* result = nullptr;
-	auto it = std::find_if( std::begin( mButtons ), std::end( mButtons ),
-		[id]( const ci::vr::Controller::ButtonRef& elem ) -> bool {
-			return id == elem->getId();
-		}
-	);
-	if( std::end( mButtons ) != it ) {
-		result = it->get();
+	ci::vr::Hmd *hmd = mContext->getHmd();
+	if( nullptr == hmd ) {
+		return mDeviceToTrackingMatrix;
 	}
+
+	ci::mat4 result = getPredictedDeviceToTrackingMatrix( hmd->getPredictedDisplayTime() );
 	return result;
 }
 
-const ci::vr::Controller::Button* Controller::getButton( ci::vr::Controller::ButtonId id ) const
+ci::mat4 Controller::getPredictedDeviceToTrackingMatrix( double targetTime ) const
 {
-	const ci::vr::Controller::Button* result = nullptr;
-	auto it = std::find_if( std::begin( mButtons ), std::end( mButtons ),
-		[id]( const ci::vr::Controller::ButtonRef& elem ) -> bool {
-			return id == elem->getId();
-		}
-	);
-	if( std::end( mButtons ) != it ) {
-		result = it->get();
+	ci::vr::Hmd *hmd = mContext->getHmd();
+	if( ( nullptr == hmd ) || ( ! hmd->getPoseStore().isValid( mTrackedDeviceIndex ) ) ) {
+		return mDeviceToTrackingMatrix;
 	}
+
+	ci::mat4 result = hmd->getPredictedDeviceToTrackingMatrix( mTrackedDeviceIndex, targetTime );
+	return result;
+}
+
+ci::vr::Controller::Button* Controller::getButton( ci::vr::Controller::ButtonId id )
+{
+	ci::vr::Controller::Button* result = isInputSlot( id, mButtonMask ) ? &mButtons[ci::vr::countTrailingZeros( id )] : nullptr;
+	return result;
+}
+
+const ci::vr::Controller::Button* Controller::getButton( ci::vr::Controller::ButtonId id ) const
+{
+	const ci::vr::Controller::Button* result = isInputSlot( id, mButtonMask ) ? &mButtons[ci::vr::countTrailingZeros( id )] : nullptr;
 	return result;
 }
 
 ci::vr::Controller::Trigger* Controller::getTrigger( ci::vr::Controller::TriggerId id )
 {
-	ci::vr::Controller::Trigger* result = nullptr;
-	if( ci::vr::Controller::TRIGGER_ANY == id ) {
-		if( ! mTriggers.empty() ) {
-			result = mTriggers[0].get();
-		}
-	}
-	else {
-		auto it = std::find_if( std::begin( mTriggers ), std::end( mTriggers ),
-			[id]( const ci::vr::Controller::TriggerRef& elem ) -> bool {
-				return id == elem->getId();
-			}
-		);
-		if( std::end( mTriggers ) != it ) {
-			result = it->get();
-		}
-	}
+	id = ( ci::vr::Controller::TRIGGER_ANY == id ) ? static_cast<ci::vr::Controller::TriggerId>( lowestBit( mTriggerMask ) ) : id;
+	ci::vr::Controller::Trigger* result = isInputSlot( id, mTriggerMask ) ? &mTriggers[ci::vr::countTrailingZeros( id )] : nullptr;
 	return result;
 }
 
 const ci::vr::Controller::Trigger* Controller::getTrigger( ci::vr::Controller::TriggerId id ) const
 {
-	const ci::vr::Controller::Trigger* result = nullptr;
-	if( ci::vr::Controller::TRIGGER_ANY == id ) {
-		if( ! mTriggers.empty() ) {
-			result = mTriggers[0].get();
-		}
-	}
-	else {
-		auto it = std::find_if( std::begin( mTriggers ), std::end( mTriggers ),
-			[id]( const ci::vr::Controller::TriggerRef& elem ) -> bool {
-				return id == elem->getId();
-			}
-		);
-		if( std::end( mTriggers ) != it ) {
-			result = it->get();
-		}
-	}
+	id = ( ci::vr::Controller::TRIGGER_ANY == id ) ? static_cast<ci::vr::Controller::TriggerId>( lowestBit( mTriggerMask ) ) : id;
+	const ci::vr::Controller::Trigger* result = isInputSlot( id, mTriggerMask ) ? &mTriggers[ci::vr::countTrailingZeros( id )] : nullptr;
 	return result;
 }
 
 ci::vr::Controller::Axis* Controller::getAxis( ci::vr::Controller::AxisId id )
 {
-	ci::vr::Controller::Axis* result = nullptr;
-	if( ci::vr::Controller::AXIS_ANY == id ) {
-		if( ! mAxes.empty() ) {
-			result = mAxes[0].get();
-		}
-	}
-	else {
-		auto it = std::find_if( std::begin( mAxes ), std::end( mAxes ),
-			[id]( const ci::vr::Controller::AxisRef& elem ) -> bool {
-				return id == elem->getId();
-			}
-		);
-		if( std::end( mAxes ) != it ) {
-			result = it->get();
-		}
-	}
+	id = ( ci::vr::Controller::AXIS_ANY == id ) ? static_cast<ci::vr::Controller::AxisId>( lowestBit( mAxisMask ) ) : id;
+	ci::vr::Controller::Axis* result = isInputSlot( id, mAxisMask ) ? &mAxes[ci::vr::countTrailingZeros( id )] : nullptr;
 	return result;
 }
 
 const ci::vr::Controller::Axis* Controller::getAxis( ci::vr::Controller::AxisId id ) const
 {
-	const ci::vr::Controller::Axis* result = nullptr;
-	if( ci::vr::Controller::AXIS_ANY == id ) {
-		if( ! mAxes.empty() ) {
-			result = mAxes[0].get();
-		}
+	id = ( ci::vr::Controller::AXIS_ANY == id ) ? static_cast<ci::vr::Controller::AxisId>( lowestBit( mAxisMask ) ) : id;
+	const ci::vr::Controller::Axis* result = isInputSlot( id, mAxisMask ) ? &mAxes[ci::vr::countTrailingZeros( id )] : nullptr;
+	return result;
+}
+
+ci::vr::Controller::Button* Controller::addButton( ci::vr::Controller::ButtonId id )
+{
+	const uint32_t index = inputSlot( id, kMaxButtons, "button" );
+	if( 0 == ( mButtonMask & id ) ) {
+		mButtons[index] = ci::vr::Controller::Button( id, this );
+		mButtonMask |= id;
 	}
-	else {
-		auto it = std::find_if( std::begin( mAxes ), std::end( mAxes ),
-			[id]( const ci::vr::Controller::AxisRef& elem ) -> bool {
-				return id == elem->getId();
-			}
-		);
-		if( std::end( mAxes ) != it ) {
-			result = it->get();
-		}
+	return &mButtons[index];
+}
+
+ci::vr::Controller::Trigger* Controller::addTrigger( ci::vr::Controller::TriggerId id, float minLim, float maxLim )
+{
+	const uint32_t index = inputSlot( id, kMaxTriggers, "trigger" );
+	if( 0 == ( mTriggerMask & id ) ) {
+		mTriggers[index] = ci::vr::Controller::Trigger( id, this, minLim, maxLim );
+		mTriggerMask |= id;
 	}
-	return result;
+	return &mTriggers[index];
+}
+
+ci::vr::Controller::Axis* Controller::addAxis( ci::vr::Controller::AxisId id )
+{
+	const uint32_t index = inputSlot( id, kMaxAxes, "axis" );
+	if( 0 == ( mAxisMask & id ) ) {
+		mAxes[index] = ci::vr::Controller::Axis( id, this );
+		mAxisMask |= id;
+	}
+	return &mAxes[index];
+}
+
+void Controller::publishState( uint64_t frame, double time )
+{
+	ci::vr::ControllerState state = ci::vr::ControllerState();
+	state.frame = frame;
+	state.time = time;
+	state.type = static_cast<uint32_t>( mType );
+	state.buttonMask = mButtonMask;
+	state.triggerMask = mTriggerMask;
+	state.axisMask = mAxisMask;
+	state.buttonsDown = mButtonsDown;
+	state.buttonsPressed = mButtonsPressed;
+	state.buttonsReleased = mButtonsReleased;
+	for( uint32_t bits = mTriggerMask; 0 != bits; bits &= ( bits - 1 ) ) {
+		const uint32_t i = ci::vr::countTrailingZeros( bits );
+		state.triggers[i] = mTriggers[i].getValue();
+	}
+	for( uint32_t bits = mAxisMask; 0 != bits; bits &= ( bits - 1 ) ) {
+		const uint32_t i = ci::vr::countTrailingZeros( bits );
+		state.axes[i][0] = mAxes[i].getValue().x;
+		state.axes[i][1] = mAxes[i].getValue().y;
+	}
+	state.deviceToTracking = mDeviceToTrackingMatrix;
+
+	mStateBuffer->publish( state );
+	mButtonsPressed = 0;
+	mButtonsReleased = 0;
 }
 
 void Controller::setButtonState( ci::vr::Controller::Button *button, ci::vr::Controller::State state )
 {
-	button->setState( state );
+	ci::vr::ControllerEventQueue *queue = mContext ? mContext->getControllerEventQueue() : nullptr;
+	if( queue ) {
+		queue->pushButton( button, state );
+	}
+	else {
+		button->setState( state );
+	}
 }
 
 void Controller::setTriggerValue( ci::vr::Controller::Trigger *trigger, float value )
 {
-	trigger->setValue( value );
+	ci::vr::ControllerEventQueue *queue = mContext ? mContext->getControllerEventQueue() : nullptr;
+	if( queue ) {
+		queue->pushTrigger( trigger, value );
+	}
+	else {
+		trigger->setValue( value );
+	}
 }
 
 void Controller::setAxisValue( ci::vr::Controller::Axis *axis, const ci::vec2 &value )
 {
-	axis->setValue( value );
+	ci::vr::ControllerEventQueue *queue = mContext ? mContext->getControllerEventQueue() : nullptr;
+	if( queue ) {
+		queue->pushAxis( axis, value );
+	}
+	else {
+		axis->setValue( value );
+	}
 }
 
 }} // namespace cinder::vr
\ No newline at end of file
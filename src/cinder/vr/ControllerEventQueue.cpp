@@ -0,0 +1,219 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/ControllerEventQueue.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cinder { namespace vr {
+
+namespace {
+
+inline uint64_t policyKey( ci::vr::Controller::Type type, uint32_t id )
+{
+	return ( static_cast<uint64_t>( type ) << 32 ) | static_cast<uint64_t>( id );
+}
+
+} // anonymous namespace
+
+// -------------------------------------------------------------------------------------------------
+// ControllerEventQueue
+// -------------------------------------------------------------------------------------------------
+ControllerEventQueue::ControllerEventQueue()
+{
+}
+
+ControllerEventQueue::~ControllerEventQueue()
+{
+}
+
+ControllerEventQueueRef ControllerEventQueue::create()
+{
+	ControllerEventQueueRef result = ControllerEventQueueRef( new ControllerEventQueue() );
+	return result;
+}
+
+void ControllerEventQueue::setTriggerPolicy( ci::vr::Controller::Type type, ci::vr::Controller::TriggerId id, const Policy& policy )
+{
+	mTriggerPolicies[policyKey( type, id )] = policy;
+}
+
+void ControllerEventQueue::setAxisPolicy( ci::vr::Controller::Type type, ci::vr::Controller::AxisId id, const Policy& policy )
+{
+	mAxisPolicies[policyKey( type, id )] = policy;
+}
+
+void ControllerEventQueue::clearPolicies()
+{
+	mTriggerPolicies.clear();
+	mAxisPolicies.clear();
+}
+
+const ControllerEventQueue::Policy& ControllerEventQueue::getPolicy( const std::map<uint64_t, Policy>& policies, const Policy& defaultPolicy, const ci::vr::Controller *controller, uint32_t id ) const
+{
+	if( policies.empty() ) {
+		return defaultPolicy;
+	}
+
+	auto it = policies.find( policyKey( controller->getType(), id ) );
+	return ( policies.end() != it ) ? it->second : defaultPolicy;
+}
+
+int ControllerEventQueue::findPending( const ci::vr::Controller::ActionState *input ) const
+{
+	for( int i = static_cast<int>( mEvents.size() ) - 1; i >= 0; --i ) {
+		if( input == mEvents[i].input ) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void ControllerEventQueue::pushButton( ci::vr::Controller::Button *button, ci::vr::Controller::State state )
+{
+	// Drop updates that match the state the button will have once the queue is dispatched
+	int index = findPending( button );
+	ci::vr::Controller::State pendingState = ( index >= 0 ) ? mEvents[index].state : button->getState();
+	if( state == pendingState ) {
+		return;
+	}
+
+	Event event;
+	event.kind = KIND_BUTTON;
+	event.input = button;
+	event.state = state;
+	event.value[0] = 0.0f;
+	event.value[1] = 0.0f;
+	mEvents.push_back( event );
+}
+
+void ControllerEventQueue::pushTrigger( ci::vr::Controller::Trigger *trigger, float value )
+{
+	int index = findPending( trigger );
+	if( index >= 0 ) {
+		mEvents[index].value[0] = value;
+		return;
+	}
+
+	Event event;
+	event.kind = KIND_TRIGGER;
+	event.input = trigger;
+	event.state = ci::vr::Controller::STATE_UNKNOWN;
+	event.value[0] = value;
+	event.value[1] = 0.0f;
+	mEvents.push_back( event );
+}
+
+void ControllerEventQueue::pushAxis( ci::vr::Controller::Axis *axis, const ci::vec2& value )
+{
+	int index = findPending( axis );
+	if( index >= 0 ) {
+		mEvents[index].value[0] = value.x;
+		mEvents[index].value[1] = value.y;
+		return;
+	}
+
+	Event event;
+	event.kind = KIND_AXIS;
+	event.input = axis;
+	event.state = ci::vr::Controller::STATE_UNKNOWN;
+	event.value[0] = value.x;
+	event.value[1] = value.y;
+	mEvents.push_back( event );
+}
+
+void ControllerEventQueue::dispatch()
+{
+	// Signal handlers may queue more events, those go to the next dispatch
+	std::swap( mEvents, mDispatching );
+
+	for( const auto& event : mDispatching ) {
+		switch( event.kind ) {
+			case KIND_BUTTON: {
+				auto button = static_cast<ci::vr::Controller::Button*>( event.input );
+				button->setState( event.state );
+			}
+			break;
+
+			case KIND_TRIGGER: {
+				auto trigger = static_cast<ci::vr::Controller::Trigger*>( event.input );
+				const Policy& policy = getPolicy( mTriggerPolicies, mDefaultTriggerPolicy, trigger->getController(), trigger->getId() );
+				float value = trigger->normalize( event.value[0] );
+				value = ( value < policy.deadZone ) ? 0.0f : value;
+
+				const float delta = std::fabs( value - trigger->getValue() );
+				const bool atEnd = ( 0.0f == value ) || ( 1.0f == value );
+				if( ( delta > 0.0f ) && ( ( delta >= policy.threshold ) || atEnd ) ) {
+					trigger->setNormalizedValue( value );
+				}
+			}
+			break;
+
+			case KIND_AXIS: {
+				auto axis = static_cast<ci::vr::Controller::Axis*>( event.input );
+				const Policy& policy = getPolicy( mAxisPolicies, mDefaultAxisPolicy, axis->getController(), axis->getId() );
+				ci::vec2 value = ci::vec2( event.value[0], event.value[1] );
+				value = ( ci::length( value ) < policy.deadZone ) ? ci::vec2( 0.0f ) : value;
+
+				const float delta = ci::length( value - axis->getValue() );
+				const bool atRest = ( ci::vec2( 0.0f ) == value );
+				if( ( delta > 0.0f ) && ( ( delta >= policy.threshold ) || atRest ) ) {
+					axis->setValue( value );
+				}
+			}
+			break;
+		}
+	}
+
+	mDispatching.clear();
+}
+
+void ControllerEventQueue::discard( const ci::vr::Controller *controller )
+{
+	mEvents.erase(
+		std::remove_if( std::begin( mEvents ), std::end( mEvents ),
+			[controller]( const Event& event ) -> bool {
+				return controller == event.input->getController();
+			}
+		),
+		std::end( mEvents )
+	);
+}
+
+}} // namespace cinder::vr
@@ -0,0 +1,120 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/ControllerState.h"
+
+#include <cstring>
+
+namespace cinder { namespace vr {
+
+// -------------------------------------------------------------------------------------------------
+// ControllerStateBuffer
+// -------------------------------------------------------------------------------------------------
+ControllerStateBuffer::ControllerStateBuffer()
+{
+	mNumPublished.store( 0 );
+	for( auto& slot : mSlots ) {
+		slot.mSequence.store( 0 );
+		for( auto& word : slot.mWords ) {
+			word.store( 0 );
+		}
+	}
+}
+
+ControllerStateBuffer::~ControllerStateBuffer()
+{
+}
+
+ControllerStateBufferRef ControllerStateBuffer::create()
+{
+	ControllerStateBufferRef result = ControllerStateBufferRef( new ControllerStateBuffer() );
+	return result;
+}
+
+void ControllerStateBuffer::publish( const ci::vr::ControllerState& state )
+{
+	uint32_t words[kNumWords];
+	std::memcpy( words, &state, sizeof( state ) );
+
+	// Fill the slot readers of the latest state aren't looking at
+	uint64_t numPublished = mNumPublished.load( std::memory_order_relaxed );
+	Slot& slot = mSlots[numPublished & 1];
+
+	uint32_t seq = slot.mSequence.load( std::memory_order_relaxed );
+	slot.mSequence.store( seq + 1, std::memory_order_relaxed );
+	std::atomic_thread_fence( std::memory_order_release );
+	for( uint32_t i = 0; i < kNumWords; ++i ) {
+		slot.mWords[i].store( words[i], std::memory_order_relaxed );
+	}
+	slot.mSequence.store( seq + 2, std::memory_order_release );
+
+	mNumPublished.store( numPublished + 1, std::memory_order_release );
+}
+
+bool ControllerStateBuffer::read( ci::vr::ControllerState *outState ) const
+{
+	uint32_t words[kNumWords];
+	for( ;; ) {
+		uint64_t numPublished = mNumPublished.load( std::memory_order_acquire );
+		if( 0 == numPublished ) {
+			return false;
+		}
+
+		// The writer only reaches this slot again after another publish, retry if it did
+		const Slot& slot = mSlots[( numPublished - 1 ) & 1];
+		uint32_t seq0 = slot.mSequence.load( std::memory_order_acquire );
+		if( 0 != ( seq0 & 1 ) ) {
+			continue;
+		}
+
+		for( uint32_t i = 0; i < kNumWords; ++i ) {
+			words[i] = slot.mWords[i].load( std::memory_order_relaxed );
+		}
+
+		std::atomic_thread_fence( std::memory_order_acquire );
+		uint32_t seq1 = slot.mSequence.load( std::memory_order_relaxed );
+		if( seq0 == seq1 ) {
+			break;
+		}
+	}
+
+	std::memcpy( outState, words, sizeof( *outState ) );
+	return true;
+}
+
+}} // namespace cinder::vr
@@ -0,0 +1,87 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/DynamicResolution.h"
+#include "cinder/CinderMath.h"
+
+#include <cmath>
+
+namespace cinder { namespace vr {
+
+// Fraction of the way to the ideal scale covered per update
+const float kScaleDecreaseRate = 0.5f;
+const float kScaleIncreaseRate = 0.05f;
+// No change while the GPU time is within this fraction of the target
+const double kScaleDeadband = 0.05;
+
+// -------------------------------------------------------------------------------------------------
+// DynamicResolution
+// -------------------------------------------------------------------------------------------------
+DynamicResolution::DynamicResolution( float minScale, float maxScale, double targetSeconds )
+	: mMinScale( minScale ), mMaxScale( maxScale ), mTargetSeconds( targetSeconds ), mScale( maxScale )
+{
+	if( mMinScale > mMaxScale ) {
+		mMinScale = mMaxScale;
+	}
+}
+
+DynamicResolutionRef DynamicResolution::create( float minScale, float maxScale, double targetSeconds )
+{
+	DynamicResolutionRef result = DynamicResolutionRef( new DynamicResolution( minScale, maxScale, targetSeconds ) );
+	return result;
+}
+
+float DynamicResolution::update( double gpuSeconds )
+{
+	if( ( gpuSeconds <= 0.0 ) || ( mTargetSeconds <= 0.0 ) ) {
+		return mScale;
+	}
+
+	double ratio = mTargetSeconds / gpuSeconds;
+	if( std::fabs( ratio - 1.0 ) < kScaleDeadband ) {
+		return mScale;
+	}
+
+	// Area, and roughly GPU time, goes with the square of the scale
+	float ideal = mScale * static_cast<float>( std::sqrt( ratio ) );
+	float rate = ( ideal < mScale ) ? kScaleDecreaseRate : kScaleIncreaseRate;
+	mScale = ci::clamp( mScale + rate * ( ideal - mScale ), mMinScale, mMaxScale );
+	return mScale;
+}
+
+}} // namespace cinder::vr
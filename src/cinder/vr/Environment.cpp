@@ -40,6 +40,7 @@
 #include "cinder/vr/Context.h"
 #include "cinder/vr/oculus/DeviceManager.h"
 #include "cinder/vr/openvr/DeviceManager.h"
+#include "cinder/vr/simulated/DeviceManager.h"
 #include "cinder/Log.h"
 
 #include <algorithm>
@@ -98,6 +99,18 @@ void Environment::registerDevice( ci::vr::ApiFlags deviceVendorId, ci::vr::Devic
 	mDeviceManagers.push_back( std::make_pair( deviceVendorId, dsm ) );
 }
 
+bool Environment::isRegistered( ci::vr::ApiFlags deviceVendorId ) const
+{
+	auto it = std::find_if( std::begin( mDeviceManagers ), std::end( mDeviceManagers ),
+		[deviceVendorId]( const std::pair<ci::vr::ApiFlags, DeviceManagerStoreRef>& elem ) -> bool {
+			return elem.first == deviceVendorId;
+		}
+	);
+
+	bool result = ( std::end( mDeviceManagers ) != it );
+	return result;
+}
+
 ci::vr::Context* Environment::beginSession( const ci::vr::SessionOptions& options, ci::vr::ApiFlags apiFlags, uint32_t deviceIndex )
 {
 	if( mDeviceManagers.empty() ) {
@@ -163,50 +176,62 @@ void registerDevice( ci::vr::ApiFlags deviceVendorId, ci::vr::DeviceManager* dev
 {
 	if( ! sEnvironment ) {
 		sEnvironment.reset( new ci::vr::Environment() );
-		sEnvironment->registerDevice( deviceVendorId, deviceFactory, assumeOwnership );
 	}
+
+	sEnvironment->registerDevice( deviceVendorId, deviceFactory, assumeOwnership );
 }
 
 void initialize( ci::vr::ApiFlags apiFlags )
 {
+	// Devices registered before initialize() already created the environment
 	if( ! sEnvironment ) {
 		sEnvironment.reset( new ci::vr::Environment() );
+	}
 
-		// NOTE: If Oculus is present, then don't start OpenVR. OpenVR will attempt
-		//       to launch SteamVR, which assumes control of the VR environment.
-		//
-		bool isOculusPresent = false;
+	// NOTE: If Oculus is present, then don't start OpenVR. OpenVR will attempt
+	//       to launch SteamVR, which assumes control of the VR environment.
+	//
+	bool isOculusPresent = sEnvironment->isRegistered( ci::vr::API_OCULUS );
 
 #if defined( CINDER_VR_ENABLE_OCULUS )
-		if( ci::vr::API_OCULUS == ( apiFlags & ci::vr::API_OCULUS ) ) {
-			try {
-				ci::vr::oculus::DeviceManager* deviceManager = new ci::vr::oculus::DeviceManager( sEnvironment.get() );
-				deviceManager->initialize();
+	if( ( ! isOculusPresent ) && ( ci::vr::API_OCULUS == ( apiFlags & ci::vr::API_OCULUS ) ) ) {
+		try {
+			ci::vr::oculus::DeviceManager* deviceManager = new ci::vr::oculus::DeviceManager( sEnvironment.get() );
+			deviceManager->initialize();
 
-				sEnvironment->registerDevice( ci::vr::API_OCULUS, deviceManager, true );
+			sEnvironment->registerDevice( ci::vr::API_OCULUS, deviceManager, true );
 
-				isOculusPresent = true;
-			}
-			catch( const std::exception& e ) {
-				CI_LOG_W( "Oculus Rift device manager registration failed: " << e.what() );
-			}
+			isOculusPresent = true;
+		}
+		catch( const std::exception& e ) {
+			CI_LOG_W( "Oculus Rift device manager registration failed: " << e.what() );
 		}
+	}
 #endif
 
 #if defined( CINDER_VR_ENABLE_OPENVR )
-		if( ( ! isOculusPresent ) && ( ci::vr::API_OPENVR == ( apiFlags & ci::vr::API_OPENVR ) ) ) {
-			try {
-				ci::vr::openvr::DeviceManager* deviceManager = new ci::vr::openvr::DeviceManager( sEnvironment.get() );
-				deviceManager->initialize();
+	if( ( ! isOculusPresent ) && ( ! sEnvironment->isRegistered( ci::vr::API_OPENVR ) ) && ( ci::vr::API_OPENVR == ( apiFlags & ci::vr::API_OPENVR ) ) ) {
+		try {
+			ci::vr::openvr::DeviceManager* deviceManager = new ci::vr::openvr::DeviceManager( sEnvironment.get() );
+			deviceManager->initialize();
 
-				sEnvironment->registerDevice( ci::vr::API_OPENVR, deviceManager, true );
-			}
-			catch( const std::exception& e ) {
-				CI_LOG_W( "HTC Vive device manager registration failed: " << e.what() );
-			}
+			sEnvironment->registerDevice( ci::vr::API_OPENVR, deviceManager, true );
 		}
+		catch( const std::exception& e ) {
+			CI_LOG_W( "HTC Vive device manager registration failed: " << e.what() );
+		}
+	}
 #endif
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+	// Custom range device, so only when asked for by name and not already registered with custom options
+	if( ( ci::vr::API_SIMULATED == apiFlags ) && ( ! sEnvironment->isRegistered( ci::vr::API_SIMULATED ) ) ) {
+		ci::vr::simulated::DeviceManager* deviceManager = new ci::vr::simulated::DeviceManager( sEnvironment.get() );
+		deviceManager->initialize();
+
+		sEnvironment->registerDevice( ci::vr::API_SIMULATED, deviceManager, true );
 	}
+#endif
 }
 
 void destroy()
@@ -0,0 +1,307 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/FrameTiming.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace cinder { namespace vr {
+
+// -------------------------------------------------------------------------------------------------
+// FrameTiming::ScopedPhase
+// -------------------------------------------------------------------------------------------------
+FrameTiming::ScopedPhase::ScopedPhase( ci::vr::FrameTiming *frameTiming, ci::vr::FrameTiming::Phase phase )
+	: mFrameTiming( frameTiming ), mPhase( phase )
+{
+	if( mFrameTiming ) {
+		mFrameTiming->beginPhase( mPhase );
+	}
+}
+
+FrameTiming::ScopedPhase::~ScopedPhase()
+{
+	if( mFrameTiming ) {
+		mFrameTiming->endPhase( mPhase );
+	}
+}
+
+// -------------------------------------------------------------------------------------------------
+// FrameTiming
+// -------------------------------------------------------------------------------------------------
+FrameTiming::FrameTiming()
+{
+	for( uint32_t i = 0; i < PHASE_COUNT; ++i ) {
+		mPhaseStart[i] = -1.0;
+		mPhaseDuration[i] = 0.0;
+	}
+
+	mNumFrames.store( 0 );
+	for( auto& slot : mSlots ) {
+		slot.mSequence.store( 0 );
+		slot.mPhaseMask.store( 0 );
+		for( auto& duration : slot.mDurations ) {
+			duration.store( 0.0f );
+		}
+	}
+
+	mTimer.start();
+}
+
+FrameTiming::~FrameTiming()
+{
+}
+
+FrameTimingRef FrameTiming::create()
+{
+	FrameTimingRef result = FrameTimingRef( new FrameTiming() );
+	return result;
+}
+
+void FrameTiming::beginFrame()
+{
+	if( ! mEnabled ) {
+		return;
+	}
+
+	// A frame that never reached submitFrame() is discarded
+	for( uint32_t i = 0; i < PHASE_COUNT; ++i ) {
+		mPhaseStart[i] = -1.0;
+		mPhaseDuration[i] = 0.0;
+	}
+	mPhaseMask = 0;
+	mEyePhase = PHASE_COUNT;
+	mInFrame = true;
+
+	mPhaseStart[PHASE_FRAME] = getTimeInSeconds();
+}
+
+void FrameTiming::endFrame()
+{
+	if( ( ! mEnabled ) || ( ! mInFrame ) ) {
+		return;
+	}
+
+	endEye();
+
+	double now = getTimeInSeconds();
+	for( uint32_t i = 0; i < PHASE_COUNT; ++i ) {
+		if( mPhaseStart[i] >= 0.0 ) {
+			mPhaseDuration[i] += now - mPhaseStart[i];
+			mPhaseMask |= ( 1u << i );
+			mPhaseStart[i] = -1.0;
+		}
+	}
+	mInFrame = false;
+
+	uint64_t frame = mNumFrames.load( std::memory_order_relaxed );
+	Slot& slot = mSlots[frame % kMaxFrames];
+
+	uint32_t seq = slot.mSequence.load( std::memory_order_relaxed );
+	slot.mSequence.store( seq + 1, std::memory_order_relaxed );
+	std::atomic_thread_fence( std::memory_order_release );
+	slot.mPhaseMask.store( mPhaseMask, std::memory_order_relaxed );
+	for( uint32_t i = 0; i < PHASE_COUNT; ++i ) {
+		slot.mDurations[i].store( static_cast<float>( 1000.0 * mPhaseDuration[i] ), std::memory_order_relaxed );
+	}
+	slot.mSequence.store( seq + 2, std::memory_order_release );
+
+	mNumFrames.store( frame + 1, std::memory_order_release );
+}
+
+void FrameTiming::beginPhase( ci::vr::FrameTiming::Phase phase )
+{
+	if( ( ! mEnabled ) || ( ! mInFrame ) ) {
+		return;
+	}
+
+	mPhaseStart[phase] = getTimeInSeconds();
+}
+
+void FrameTiming::endPhase( ci::vr::FrameTiming::Phase phase )
+{
+	if( ( ! mEnabled ) || ( ! mInFrame ) || ( mPhaseStart[phase] < 0.0 ) ) {
+		return;
+	}
+
+	// Phases that run more than once per frame accumulate
+	mPhaseDuration[phase] += getTimeInSeconds() - mPhaseStart[phase];
+	mPhaseMask |= ( 1u << phase );
+	mPhaseStart[phase] = -1.0;
+}
+
+void FrameTiming::beginEye( ci::vr::Eye eye )
+{
+	endEye();
+
+	switch( eye ) {
+		case ci::vr::EYE_LEFT  : mEyePhase = PHASE_EYE_LEFT; break;
+		case ci::vr::EYE_RIGHT : mEyePhase = PHASE_EYE_RIGHT; break;
+		case ci::vr::EYE_HMD   : mEyePhase = PHASE_EYE_HMD; break;
+		default                : mEyePhase = PHASE_COUNT; break;
+	}
+
+	if( PHASE_COUNT != mEyePhase ) {
+		beginPhase( mEyePhase );
+	}
+}
+
+void FrameTiming::endEye()
+{
+	if( PHASE_COUNT != mEyePhase ) {
+		endPhase( mEyePhase );
+		mEyePhase = PHASE_COUNT;
+	}
+}
+
+void FrameTiming::addPhaseDuration( ci::vr::FrameTiming::Phase phase, double seconds )
+{
+	if( ( ! mEnabled ) || ( ! mInFrame ) ) {
+		return;
+	}
+
+	mPhaseDuration[phase] += seconds;
+	mPhaseMask |= ( 1u << phase );
+}
+
+bool FrameTiming::readSlot( uint64_t frame, uint32_t *outPhaseMask, float *outDurations ) const
+{
+	const Slot& slot = mSlots[frame % kMaxFrames];
+
+	uint32_t seq0 = slot.mSequence.load( std::memory_order_acquire );
+	if( 0 != ( seq0 & 1 ) ) {
+		return false;
+	}
+
+	*outPhaseMask = slot.mPhaseMask.load( std::memory_order_relaxed );
+	for( uint32_t i = 0; i < PHASE_COUNT; ++i ) {
+		outDurations[i] = slot.mDurations[i].load( std::memory_order_relaxed );
+	}
+
+	std::atomic_thread_fence( std::memory_order_acquire );
+	uint32_t seq1 = slot.mSequence.load( std::memory_order_relaxed );
+	return seq0 == seq1;
+}
+
+FrameTiming::Stats FrameTiming::getStats( ci::vr::FrameTiming::Phase phase, uint32_t numFrames ) const
+{
+	FrameTiming::Stats result;
+	if( phase >= PHASE_COUNT ) {
+		return result;
+	}
+
+	uint64_t lastFrame = getNumFrames();
+	// Stay one slot behind the writer so the oldest slot isn't overwritten while it's read
+	uint64_t count = std::min<uint64_t>( std::min<uint64_t>( numFrames, kMaxFrames - 1 ), lastFrame );
+
+	std::vector<double> samples;
+	samples.reserve( static_cast<size_t>( count ) );
+	for( uint64_t frame = lastFrame - count; frame < lastFrame; ++frame ) {
+		uint32_t phaseMask = 0;
+		float durations[PHASE_COUNT];
+		if( ! readSlot( frame, &phaseMask, durations ) ) {
+			continue;
+		}
+
+		if( 0 != ( phaseMask & ( 1u << phase ) ) ) {
+			samples.push_back( static_cast<double>( durations[phase] ) );
+		}
+	}
+
+	if( samples.empty() ) {
+		return result;
+	}
+
+	std::sort( std::begin( samples ), std::end( samples ) );
+
+	auto percentile = [&samples]( double p ) -> double {
+		size_t rank = static_cast<size_t>( std::ceil( p * static_cast<double>( samples.size() ) ) );
+		rank = std::max<size_t>( rank, 1 );
+		return samples[rank - 1];
+	};
+
+	double sum = 0.0;
+	for( const auto& sample : samples ) {
+		sum += sample;
+	}
+
+	result.numFrames = static_cast<uint32_t>( samples.size() );
+	result.min = samples.front();
+	result.max = samples.back();
+	result.mean = sum / static_cast<double>( samples.size() );
+	result.p50 = percentile( 0.50 );
+	result.p95 = percentile( 0.95 );
+	result.p99 = percentile( 0.99 );
+	return result;
+}
+
+double FrameTiming::getLastDuration( ci::vr::FrameTiming::Phase phase ) const
+{
+	double result = 0.0;
+	uint64_t lastFrame = getNumFrames();
+	if( ( lastFrame > 0 ) && ( phase < PHASE_COUNT ) ) {
+		uint32_t phaseMask = 0;
+		float durations[PHASE_COUNT];
+		if( readSlot( lastFrame - 1, &phaseMask, durations ) ) {
+			result = static_cast<double>( durations[phase] );
+		}
+	}
+	return result;
+}
+
+std::string FrameTiming::getPhaseName( ci::vr::FrameTiming::Phase phase )
+{
+	std::string result = "PHASE_UNKNOWN";
+	switch( phase ) {
+		case PHASE_BIND             : result = "PHASE_BIND"; break;
+		case PHASE_EYE_LEFT         : result = "PHASE_EYE_LEFT"; break;
+		case PHASE_EYE_RIGHT        : result = "PHASE_EYE_RIGHT"; break;
+		case PHASE_EYE_HMD          : result = "PHASE_EYE_HMD"; break;
+		case PHASE_DRAW_CONTROLLERS : result = "PHASE_DRAW_CONTROLLERS"; break;
+		case PHASE_UNBIND           : result = "PHASE_UNBIND"; break;
+		case PHASE_SUBMIT_FRAME     : result = "PHASE_SUBMIT_FRAME"; break;
+		case PHASE_COMPOSITOR_WAIT  : result = "PHASE_COMPOSITOR_WAIT"; break;
+		case PHASE_GPU_SYNC         : result = "PHASE_GPU_SYNC"; break;
+		case PHASE_GPU_FRAME        : result = "PHASE_GPU_FRAME"; break;
+		case PHASE_FRAME            : result = "PHASE_FRAME"; break;
+	}
+	return result;
+}
+
+}} // namespace cinder::vr
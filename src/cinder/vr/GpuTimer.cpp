@@ -0,0 +1,106 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/GpuTimer.h"
+
+namespace cinder { namespace vr {
+
+// -------------------------------------------------------------------------------------------------
+// GpuTimer
+// -------------------------------------------------------------------------------------------------
+GpuTimer::GpuTimer( uint32_t numQueries )
+{
+	mQueries.resize( ( numQueries > 1 ) ? numQueries : 2 );
+	glGenQueries( static_cast<GLsizei>( mQueries.size() ), mQueries.data() );
+}
+
+GpuTimer::~GpuTimer()
+{
+	glDeleteQueries( static_cast<GLsizei>( mQueries.size() ), mQueries.data() );
+}
+
+GpuTimerRef GpuTimer::create( uint32_t numQueries )
+{
+	GpuTimerRef result = GpuTimerRef( new GpuTimer( numQueries ) );
+	return result;
+}
+
+void GpuTimer::begin()
+{
+	// Every query is waiting on the GPU, skip this frame rather than reuse one
+	if( mActive || ( ( mNumBegun - mNumPolled ) >= mQueries.size() ) ) {
+		return;
+	}
+
+	GLuint query = mQueries[mNumBegun % mQueries.size()];
+	glBeginQuery( GL_TIME_ELAPSED, query );
+	mActive = true;
+}
+
+void GpuTimer::end()
+{
+	if( ! mActive ) {
+		return;
+	}
+
+	glEndQuery( GL_TIME_ELAPSED );
+	mActive = false;
+	++mNumBegun;
+}
+
+bool GpuTimer::poll( double *outSeconds )
+{
+	bool result = false;
+	while( mNumPolled < mNumBegun ) {
+		GLuint query = mQueries[mNumPolled % mQueries.size()];
+		GLint available = 0;
+		glGetQueryObjectiv( query, GL_QUERY_RESULT_AVAILABLE, &available );
+		if( ! available ) {
+			break;
+		}
+
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v( query, GL_QUERY_RESULT, &elapsed );
+		*outSeconds = static_cast<double>( elapsed ) * 1.0e-9;
+		++mNumPolled;
+		result = true;
+	}
+	return result;
+}
+
+}} // namespace cinder::vr
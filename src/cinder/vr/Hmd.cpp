@@ -40,9 +40,73 @@
 #include "cinder/vr/Context.h"
 #include "cinder/app/App.h"
 #include "cinder/gl/gl.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/Log.h"
 
 namespace cinder { namespace vr {
 
+const std::string kStereoUniformBlockName = "ciVrStereo";
+const GLuint kStereoUniformBlockBinding = 8;
+
+const std::string kStereoUniformBlockSource =
+	"layout(std140) uniform ciVrStereo {\n"
+	"	mat4 ciVrViewProjection[2];\n"
+	"	mat4 ciVrView[2];\n"
+	"	mat4 ciVrProjection[2];\n"
+	"};\n";
+
+// Each eye draws into its half of the target, the clip distance keeps
+// geometry outside the eye's frustum from spilling into the other half.
+const std::string kInstancedStereoShaderSource = kStereoUniformBlockSource +
+	"int ciVrStereoEye() { return gl_InstanceID & 1; }\n"
+	"int ciVrStereoInstance() { return gl_InstanceID >> 1; }\n"
+	"vec4 ciVrStereoPosition( vec4 worldPosition )\n"
+	"{\n"
+	"	int eye = ciVrStereoEye();\n"
+	"	float side = float( 2 * eye - 1 );\n"
+	"	vec4 p = ciVrViewProjection[eye] * worldPosition;\n"
+	"	p.x = 0.5 * ( p.x + side * p.w );\n"
+	"	gl_ClipDistance[0] = side * p.x;\n"
+	"	return p;\n"
+	"}\n";
+
+const std::string kMultiviewShaderSource =
+	"#extension GL_OVR_multiview2 : require\n"
+	"layout(num_views = 2) in;\n" + kStereoUniformBlockSource +
+	"int ciVrStereoEye() { return int( gl_ViewID_OVR ); }\n"
+	"int ciVrStereoInstance() { return gl_InstanceID; }\n"
+	"vec4 ciVrStereoPosition( vec4 worldPosition ) { return ciVrViewProjection[ciVrStereoEye()] * worldPosition; }\n";
+
+const std::string kLayeredShaderSource =
+	"#extension GL_ARB_shader_viewport_layer_array : enable\n"
+	"#extension GL_AMD_vertex_shader_layer : enable\n" + kStereoUniformBlockSource +
+	"int ciVrStereoEye() { return gl_InstanceID & 1; }\n"
+	"int ciVrStereoInstance() { return gl_InstanceID >> 1; }\n"
+	"vec4 ciVrStereoPosition( vec4 worldPosition )\n"
+	"{\n"
+	"	int eye = ciVrStereoEye();\n"
+	"	gl_Layer = eye;\n"
+	"	return ciVrViewProjection[eye] * worldPosition;\n"
+	"}\n";
+
+// Hidden area triangles are in eye NDC, written at the near plane so the depth test rejects everything behind them
+const std::string kHiddenAreaShaderVertex =
+	"#version 410 core\n"
+	"in vec2 ciPosition;\n"
+	"void main()\n"
+	"{\n"
+	"	gl_Position = vec4( ciPosition, -1.0, 1.0 );\n"
+	"}\n";
+
+const std::string kHiddenAreaShaderFragment =
+	"#version 410 core\n"
+	"uniform vec4 uColor;\n"
+	"out vec4 oColor;\n"
+	"void main()\n"
+	"{\n"
+	"	oColor = uColor;\n"
+	"}\n";
+
 Hmd::Hmd( ci::vr::Context* context )
 	: mContext( context )
 {
@@ -51,6 +115,28 @@ Hmd::Hmd( ci::vr::Context* context )
 	mEyeCamera[ci::vr::EYE_LEFT] = ci::vr::CameraEye( ci::vr::EYE_LEFT );
 	mEyeCamera[ci::vr::EYE_RIGHT] = ci::vr::CameraEye( ci::vr::EYE_RIGHT );
 	mHmdCamera = ci::vr::CameraEye( ci::vr::EYE_HMD );
+	mFrameTiming = ci::vr::FrameTiming::create();
+
+	mStereoMode = getSessionOptions().getStereoMode();
+	if( ( ci::vr::STEREO_MODE_MULTIVIEW == mStereoMode ) && ( ci::vr::MultiviewTarget::METHOD_NONE == ci::vr::MultiviewTarget::getSupportedMethod() ) ) {
+		CI_LOG_W( "Multiview and layered rendering aren't supported, using instanced stereo" );
+		mStereoMode = ci::vr::STEREO_MODE_INSTANCED;
+	}
+
+	// Apps looping over getEyes() draw once
+	if( ci::vr::STEREO_MODE_MULTI_PASS != mStereoMode ) {
+		mEyes.clear();
+		mEyes.push_back( ci::vr::EYE_STEREO );
+	}
+
+	mHiddenAreaMask = getSessionOptions().isHiddenAreaMaskEnabled();
+
+	mFoveation = getSessionOptions().isFoveationEnabled();
+	mFoveationRadius = getSessionOptions().getFoveationRadius();
+	mFoveationPeripheryScale = getSessionOptions().getFoveationPeripheryScale();
+	if( mFoveation && ( ci::vr::STEREO_MODE_MULTI_PASS != mStereoMode ) ) {
+		CI_LOG_W( "Foveation needs multi-pass stereo, drawing full resolution eyes" );
+	}
 }
 
 Hmd::~Hmd()
@@ -80,6 +166,363 @@ void Hmd::enableMonoscopic(bool enabled)
 	onMonoscopicChange();
 }
 
+float Hmd::getResolutionScale() const
+{
+	return mDynamicResolution ? mDynamicResolution->getScale() : 1.0f;
+}
+
+void Hmd::setupGpuTiming()
+{
+	mGpuTimer = ci::vr::GpuTimer::create();
+}
+
+void Hmd::setupDynamicResolution()
+{
+	const auto& options = getSessionOptions();
+	if( ! options.isDynamicResolutionEnabled() ) {
+		return;
+	}
+
+	// The GPU target is a fraction of the frame time, there's none without a frame rate
+	float frameRate = options.getFrameRate();
+	if( frameRate <= 0.0f ) {
+		CI_LOG_W( "Dynamic resolution disabled, it needs a positive SessionOptions::setFrameRate()" );
+		return;
+	}
+
+	auto range = options.getDynamicResolutionRange();
+	double targetSeconds = options.getDynamicResolutionBudget() / static_cast<double>( frameRate );
+	mDynamicResolution = ci::vr::DynamicResolution::create( range.first, range.second, targetSeconds );
+	CI_LOG_I( "Dynamic resolution scale=[" << range.first << ", " << range.second << "], targetSeconds=" << targetSeconds );
+}
+
+float Hmd::getMaxResolutionScale() const
+{
+	return mDynamicResolution ? mDynamicResolution->getMaxScale() : 1.0f;
+}
+
+void Hmd::beginGpuFrame()
+{
+	if( ! mGpuTimer ) {
+		return;
+	}
+
+	double gpuSeconds = 0.0;
+	if( mGpuTimer->poll( &gpuSeconds ) ) {
+		mFrameTiming->addPhaseDuration( ci::vr::FrameTiming::PHASE_GPU_FRAME, gpuSeconds );
+		if( mDynamicResolution ) {
+			mDynamicResolution->update( gpuSeconds );
+		}
+	}
+
+	mGpuTimer->begin();
+}
+
+void Hmd::endGpuFrame()
+{
+	if( mGpuTimer ) {
+		mGpuTimer->end();
+	}
+}
+
+ci::Area Hmd::calcEyeViewport( ci::vr::Eye eye, const ci::ivec2& targetSize, bool sideBySide ) const
+{
+	ci::ivec2 eyeSize = sideBySide ? ci::ivec2( targetSize.x / 2, targetSize.y ) : targetSize;
+	float fraction = getResolutionScale() / getMaxResolutionScale();
+	ci::ivec2 size = ci::ivec2( ci::vec2( eyeSize ) * fraction + ci::vec2( 0.5f ) );
+	size = ci::ivec2( ci::clamp( size.x, 1, eyeSize.x ), ci::clamp( size.y, 1, eyeSize.y ) );
+	int32_t x = ( sideBySide && ( ci::vr::EYE_RIGHT == eye ) ) ? size.x : 0;
+	return ci::Area( x, 0, x + size.x, size.y );
+}
+
+ci::Area Hmd::getMultiviewViewport() const
+{
+	return calcEyeViewport( ci::vr::EYE_LEFT, mMultiviewTarget->getSize(), false );
+}
+
+void Hmd::setupMultiviewTarget( const ci::ivec2& eyeSize, uint32_t samples )
+{
+	mMultiviewTarget = ci::vr::MultiviewTarget::create( eyeSize, samples );
+	CI_LOG_I( "Multiview method=" << ( ci::vr::MultiviewTarget::METHOD_MULTIVIEW == mMultiviewTarget->getMethod() ? "GL_OVR_multiview2" : "layered" ) );
+}
+
+void Hmd::enableStereo( ci::vr::CoordSys eyeMatrixMode )
+{
+	if( ci::vr::STEREO_MODE_MULTI_PASS == mStereoMode ) {
+		CI_LOG_W( "Single pass stereo isn't enabled, see SessionOptions::setStereoMode()" );
+		return;
+	}
+
+	mFrameTiming->endEye();
+
+	if( mMultiviewTarget ) {
+		mMultiviewTarget->bind();
+		ci::Area area = getMultiviewViewport();
+		ci::gl::viewport( area.getUL(), area.getSize() );
+	}
+	else {
+		ci::Area area = getEyeViewport( ci::vr::EYE_LEFT );
+		area.include( getEyeViewport( ci::vr::EYE_RIGHT ) );
+		ci::gl::viewport( area.getUL(), area.getSize() );
+	}
+
+	// Shaders that aren't stereo aware see the left eye
+	setMatricesEye( ci::vr::EYE_LEFT, eyeMatrixMode );
+
+	StereoUniforms uniforms;
+	for( uint32_t i = 0; i < ci::vr::EYE_COUNT; ++i ) {
+		ci::vr::Eye eye = static_cast<ci::vr::Eye>( i );
+		uniforms.view[i] = getEyeViewMatrix( eye );
+		uniforms.projection[i] = getEyeProjectionMatrix( eye );
+		uniforms.viewProjection[i] = uniforms.projection[i] * uniforms.view[i];
+	}
+
+	if( ! mStereoUbo ) {
+		mStereoUbo = ci::gl::Ubo::create( sizeof( StereoUniforms ), &uniforms, GL_DYNAMIC_DRAW );
+	}
+	else {
+		mStereoUbo->bufferSubData( 0, sizeof( StereoUniforms ), &uniforms );
+	}
+	mStereoUbo->bindBufferBase( kStereoUniformBlockBinding );
+}
+
+bool Hmd::enableStereoEye( ci::vr::Eye eye, ci::vr::CoordSys eyeMatrixMode )
+{
+	if( ci::vr::EYE_STEREO == eye ) {
+		enableStereo( eyeMatrixMode );
+		return true;
+	}
+
+	if( mMultiviewTarget && ( ( ci::vr::EYE_LEFT == eye ) || ( ci::vr::EYE_RIGHT == eye ) ) ) {
+		mFrameTiming->beginEye( eye );
+		mMultiviewTarget->bindLayer( eye );
+		ci::Area area = getMultiviewViewport();
+		ci::gl::viewport( area.getUL(), area.getSize() );
+		setMatricesEye( eye, eyeMatrixMode );
+		return true;
+	}
+
+	return false;
+}
+
+void Hmd::forEachStereoEye( const std::function<void( ci::vr::Eye )>& drawFn )
+{
+	for( uint32_t i = 0; i < ci::vr::EYE_COUNT; ++i ) {
+		ci::vr::Eye eye = static_cast<ci::vr::Eye>( i );
+		if( mMultiviewTarget ) {
+			mMultiviewTarget->bindLayer( eye );
+			ci::Area area = getMultiviewViewport();
+			ci::gl::viewport( area.getUL(), area.getSize() );
+		}
+		else {
+			ci::Area area = getEyeViewport( eye );
+			ci::gl::viewport( area.getUL(), area.getSize() );
+		}
+		drawFn( eye );
+	}
+
+	if( mMultiviewTarget ) {
+		mMultiviewTarget->bind();
+		ci::Area area = getMultiviewViewport();
+		ci::gl::viewport( area.getUL(), area.getSize() );
+	}
+	else {
+		ci::Area area = getEyeViewport( ci::vr::EYE_LEFT );
+		area.include( getEyeViewport( ci::vr::EYE_RIGHT ) );
+		ci::gl::viewport( area.getUL(), area.getSize() );
+	}
+}
+
+void Hmd::drawStereo( const ci::gl::BatchRef& batch, GLsizei instanceCount )
+{
+	batch->getGlslProg()->uniformBlock( kStereoUniformBlockName, kStereoUniformBlockBinding );
+
+	if( mMultiviewTarget ) {
+		// Multiview replicates each draw per view
+		if( ci::vr::MultiviewTarget::METHOD_MULTIVIEW == mMultiviewTarget->getMethod() ) {
+			batch->drawInstanced( instanceCount );
+		}
+		else {
+			batch->drawInstanced( 2 * instanceCount );
+		}
+	}
+	else {
+		ci::gl::ScopedState scopedClipDistance( GL_CLIP_DISTANCE0, true );
+		batch->drawInstanced( 2 * instanceCount );
+	}
+}
+
+const std::string& Hmd::getStereoShaderSource() const
+{
+	if( mMultiviewTarget ) {
+		return ( ci::vr::MultiviewTarget::METHOD_MULTIVIEW == mMultiviewTarget->getMethod() ) ? kMultiviewShaderSource : kLayeredShaderSource;
+	}
+	return kInstancedStereoShaderSource;
+}
+
+bool Hmd::hasHiddenAreaMask() const
+{
+	bool result = mHiddenAreaMask && ( mHiddenAreaBatch[ci::vr::EYE_LEFT] || mHiddenAreaBatch[ci::vr::EYE_RIGHT] );
+	return result;
+}
+
+void Hmd::setupHiddenAreaMask( ci::vr::Eye eye, const std::vector<ci::vec2>& triangles )
+{
+	mHiddenAreaBatch[eye].reset();
+	if( triangles.empty() ) {
+		return;
+	}
+
+	if( ! mHiddenAreaShader ) {
+		try {
+			mHiddenAreaShader = ci::gl::GlslProg::create( kHiddenAreaShaderVertex, kHiddenAreaShaderFragment );
+		}
+		catch( const std::exception& e ) {
+			std::string errMsg = "Hidden area shader failed(" + std::string( e.what() ) + ")";
+			throw ci::vr::Exception( errMsg );
+		}
+	}
+
+	// Vertex data vbo
+	ci::geom::BufferLayout layout = ci::geom::BufferLayout();
+	layout.append( ci::geom::POSITION, 2, sizeof( ci::vec2 ), 0, 0 );
+	ci::gl::VboRef vertexDataVbo = ci::gl::Vbo::create( GL_ARRAY_BUFFER, triangles );
+	std::vector<std::pair<ci::geom::BufferLayout, ci::gl::VboRef>> vertexArrayBuffers = { std::make_pair( layout, vertexDataVbo ) };
+
+	// Vbo mesh
+	ci::gl::VboMeshRef vboMesh = ci::gl::VboMesh::create( static_cast<uint32_t>( triangles.size() ), GL_TRIANGLES, vertexArrayBuffers );
+	mHiddenAreaBatch[eye] = ci::gl::Batch::create( vboMesh, mHiddenAreaShader );
+}
+
+void Hmd::drawHiddenAreaMask( ci::vr::Eye eye, const ci::Area& area )
+{
+	if( ( ! mHiddenAreaMask ) || ( eye >= ci::vr::EYE_COUNT ) || ( ! mHiddenAreaBatch[eye] ) ) {
+		return;
+	}
+
+	ci::gl::ScopedViewport scopedViewport( area.getUL(), area.getSize() );
+	ci::gl::ScopedDepthTest scopedDepthTest( true, GL_ALWAYS );
+	ci::gl::ScopedDepthWrite scopedDepthWrite( true );
+	// Winding differs between headsets and eyes
+	ci::gl::ScopedFaceCulling scopedFaceCulling( false );
+	ci::gl::ScopedBlend scopedBlend( false );
+	mHiddenAreaShader->uniform( "uColor", mClearColor );
+	mHiddenAreaBatch[eye]->draw();
+}
+
+void Hmd::drawStereoHiddenAreaMasks()
+{
+	if( ! hasHiddenAreaMask() ) {
+		return;
+	}
+
+	forEachStereoEye( [this]( ci::vr::Eye eye ) {
+		auto viewport = ci::gl::getViewport();
+		drawHiddenAreaMask( eye, ci::Area( viewport.first, viewport.first + viewport.second ) );
+	} );
+}
+
+bool Hmd::isFoveated() const
+{
+	bool result = mFoveation && ( ci::vr::STEREO_MODE_MULTI_PASS == mStereoMode );
+	return result;
+}
+
+void Hmd::setFoveation( float radius, float peripheryScale )
+{
+	mFoveationRadius = ci::clamp( radius, 0.05f, 1.0f );
+	mFoveationPeripheryScale = ci::clamp( peripheryScale, 0.1f, 1.0f );
+}
+
+ci::Area Hmd::getFoveaViewport( ci::vr::Eye eye ) const
+{
+	ci::Area eyeArea = getEyeViewport( eye );
+	ci::vec2 eyeSize = ci::vec2( eyeArea.getSize() );
+
+	// Straight ahead is off centre with the asymmetric eye frustums
+	ci::vec4 ahead = getEyeProjectionMatrix( eye ) * ci::vec4( 0, 0, -1, 1 );
+	ci::vec2 center = glm::clamp( ci::vec2( ahead ) / ahead.w, ci::vec2( -1 ), ci::vec2( 1 ) );
+	center = ci::vec2( eyeArea.getUL() ) + ( 0.5f * center + ci::vec2( 0.5f ) ) * eyeSize;
+
+	ci::vec2 halfSize = 0.5f * mFoveationRadius * eyeSize;
+	ci::Area result = ci::Area( ci::ivec2( center - halfSize ), ci::ivec2( center + halfSize ) );
+	result.clipBy( eyeArea );
+	return result;
+}
+
+void Hmd::drawFoveated( ci::vr::Eye eye, const std::function<void( ci::vr::FoveaRegion )>& drawFn )
+{
+	if( ( ! isFoveated() ) || ( ( ci::vr::EYE_LEFT != eye ) && ( ci::vr::EYE_RIGHT != eye ) ) ) {
+		drawFn( ci::vr::FOVEA_REGION_FULL );
+		return;
+	}
+
+	ci::Area eyeArea = getEyeViewport( eye );
+	ci::Area foveaArea = getFoveaViewport( eye );
+	ci::ivec2 peripherySize = ci::ivec2( ci::vec2( eyeArea.getSize() ) * mFoveationPeripheryScale + ci::vec2( 0.5f ) );
+	peripherySize = glm::max( peripherySize, ci::ivec2( 1 ) );
+
+	// Grows only, the periphery is drawn to its lower left corner
+	if( ( ! mFoveaPeripheryTarget ) || ( peripherySize.x > mFoveaPeripheryTarget->getWidth() ) || ( peripherySize.y > mFoveaPeripheryTarget->getHeight() ) ) {
+		ci::ivec2 targetSize = mFoveaPeripheryTarget ? glm::max( peripherySize, mFoveaPeripheryTarget->getSize() ) : peripherySize;
+		ci::gl::Texture2d::Format texFormat = ci::gl::Texture2d::Format();
+		texFormat.setInternalFormat( GL_RGBA8 );
+		texFormat.setWrapS( GL_CLAMP_TO_EDGE );
+		texFormat.setWrapT( GL_CLAMP_TO_EDGE );
+		texFormat.setMinFilter( GL_LINEAR );
+		texFormat.setMagFilter( GL_LINEAR );
+		ci::gl::Fbo::Format fboFormat = ci::gl::Fbo::Format();
+		fboFormat.setSamples( getSessionOptions().getSampleCount() );
+		fboFormat.setColorTextureFormat( texFormat );
+		fboFormat.enableDepthBuffer();
+		mFoveaPeripheryTarget = ci::gl::Fbo::create( targetSize.x, targetSize.y, fboFormat );
+	}
+
+	// Whole eye at reduced resolution
+	{
+		ci::gl::ScopedFramebuffer scopedFramebuffer( mFoveaPeripheryTarget );
+		ci::gl::ScopedViewport scopedViewport( ci::ivec2( 0 ), peripherySize );
+		ci::gl::ScopedScissor scopedScissor( ci::ivec2( 0 ), peripherySize );
+		ci::gl::clear( mClearColor );
+		drawHiddenAreaMask( eye, ci::Area( ci::ivec2( 0 ), peripherySize ) );
+		drawFn( ci::vr::FOVEA_REGION_PERIPHERY );
+	}
+
+	// Upsample into the eye, lower left origin on both sides
+	{
+		ci::vec2 texCoordMax = ci::vec2( peripherySize ) / ci::vec2( mFoveaPeripheryTarget->getSize() );
+		ci::gl::ScopedViewport scopedViewport( eyeArea.getUL(), eyeArea.getSize() );
+		ci::gl::ScopedDepth scopedDepth( false );
+		ci::gl::ScopedBlend scopedBlend( false );
+		ci::gl::ScopedMatrices scopedMatrices;
+		ci::gl::setMatricesWindow( eyeArea.getSize(), false );
+		ci::gl::ScopedTextureBind scopedTexture( mFoveaPeripheryTarget->getColorTexture() );
+		ci::gl::ScopedGlslProg scopedShader( ci::gl::getStockShader( ci::gl::ShaderDef().texture() ) );
+		ci::gl::drawSolidRect( ci::Rectf( ci::vec2( 0 ), ci::vec2( eyeArea.getSize() ) ), ci::vec2( 0 ), texCoordMax );
+	}
+
+	// Centre at full resolution, the projection narrowed to the fovea's part of the eye
+	{
+		ci::vec2 eyeMin = ci::vec2( eyeArea.getUL() );
+		ci::vec2 eyeSize = ci::vec2( eyeArea.getSize() );
+		ci::vec2 ndcMin = 2.0f * ( ci::vec2( foveaArea.getUL() ) - eyeMin ) / eyeSize - ci::vec2( 1 );
+		ci::vec2 ndcMax = 2.0f * ( ci::vec2( foveaArea.getLR() ) - eyeMin ) / eyeSize - ci::vec2( 1 );
+		ci::mat4 narrow;
+		narrow[0][0] = 2.0f / ( ndcMax.x - ndcMin.x );
+		narrow[1][1] = 2.0f / ( ndcMax.y - ndcMin.y );
+		narrow[3][0] = -( ndcMax.x + ndcMin.x ) / ( ndcMax.x - ndcMin.x );
+		narrow[3][1] = -( ndcMax.y + ndcMin.y ) / ( ndcMax.y - ndcMin.y );
+
+		ci::gl::ScopedViewport scopedViewport( foveaArea.getUL(), foveaArea.getSize() );
+		ci::gl::ScopedScissor scopedScissor( foveaArea.getUL(), foveaArea.getSize() );
+		ci::gl::clear( mClearColor );
+		drawHiddenAreaMask( eye, eyeArea );
+		ci::gl::ScopedProjectionMatrix scopedProjection;
+		ci::gl::setProjectionMatrix( narrow * ci::gl::getProjectionMatrix() );
+		drawFn( ci::vr::FOVEA_REGION_CENTER );
+	}
+}
+
 const ci::vr::CameraEye& Hmd::getEyeCamera( ci::vr::Eye eye ) const
 {
 	return ( ci::vr::EYE_HMD == eye ) ? mHmdCamera : mEyeCamera[eye];
@@ -96,6 +539,38 @@ void Hmd::updateElapsedFrames()
 	}
 }
 
+double Hmd::getTimeInSeconds() const
+{
+	return ci::app::getElapsedSeconds();
+}
+
+double Hmd::getPredictedDisplayTime() const
+{
+	return getTimeInSeconds();
+}
+
+const ci::vr::PoseStore& Hmd::getPoseStore() const
+{
+	return mContext->getPoseStore();
+}
+
+ci::vr::TrackedPose Hmd::getTrackedPose( uint32_t deviceIndex ) const
+{
+	return mContext->getPoseStore().getTrackedPose( deviceIndex );
+}
+
+ci::mat4 Hmd::getPredictedDeviceToTrackingMatrix( uint32_t deviceIndex ) const
+{
+	ci::mat4 result = getPredictedDeviceToTrackingMatrix( deviceIndex, getPredictedDisplayTime() );
+	return result;
+}
+
+ci::mat4 Hmd::getPredictedDeviceToTrackingMatrix( uint32_t deviceIndex, double targetTime ) const
+{
+	ci::mat4 result = mContext->getPoseStore().extrapolate( deviceIndex, targetTime );
+	return result;
+}
+
 ci::mat4 Hmd::getEyeViewMatrix( ci::vr::Eye eye ) const
 {
 	const ci::vr::CameraEye& cam = mEyeCamera[eye];
@@ -118,6 +593,32 @@ ci::mat4 Hmd::getEyeViewProjectionMatrix( ci::vr::Eye eye ) const
 	return result;
 }
 
+ci::vr::StereoFrustum Hmd::getStereoFrustum( ci::vr::CoordSys coordSys ) const
+{
+	// Same model matrix setMatricesEye() applies
+	ci::mat4 modelMatrix;
+	switch( coordSys ) {
+		case ci::vr::COORD_SYS_DEVICE: {
+			modelMatrix = mDeviceToTrackingMatrix;
+		}
+		break;
+
+		case ci::vr::COORD_SYS_WORLD: {
+			modelMatrix = mOriginMatrix * mLookMatrix;
+		}
+		break;
+
+		default: {
+		}
+		break;
+	}
+
+	ci::mat4 left = getEyeViewProjectionMatrix( ci::vr::EYE_LEFT ) * modelMatrix;
+	ci::mat4 right = getEyeViewProjectionMatrix( ci::vr::EYE_RIGHT ) * modelMatrix;
+	ci::vr::StereoFrustum result = ci::vr::StereoFrustum( left, right );
+	return result;
+}
+
 void Hmd::setMatricesEye( ci::vr::Eye eye, ci::vr::CoordSys eyeMatrixMode )
 {
 	const auto& cam = getEyeCamera( eye );
@@ -0,0 +1,116 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/InputThread.h"
+#include "cinder/app/App.h"
+
+#include <chrono>
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+	#include <mmsystem.h>
+	#pragma comment( lib, "winmm.lib" )
+#endif
+
+namespace cinder { namespace vr {
+
+// -------------------------------------------------------------------------------------------------
+// InputThread
+// -------------------------------------------------------------------------------------------------
+InputThread::InputThread( double hz, const PollFn& pollFn )
+	: mRate( hz ), mPollFn( pollFn ), mNumPolls( 0 )
+{
+	mThread = std::thread( &InputThread::threadProc, this );
+}
+
+InputThread::~InputThread()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mRunning = false;
+	}
+	mCondition.notify_one();
+
+	if( mThread.joinable() ) {
+		mThread.join();
+	}
+}
+
+InputThreadRef InputThread::create( double hz, const PollFn& pollFn )
+{
+	if( ( hz <= 0.0 ) || ( ! pollFn ) ) {
+		throw ci::vr::Exception( "Input thread needs a positive rate and a poll function" );
+	}
+
+	InputThreadRef result = InputThreadRef( new InputThread( hz, pollFn ) );
+	return result;
+}
+
+void InputThread::threadProc()
+{
+#if defined( CINDER_MSW )
+	// The default 15.6 ms timer resolution would cap the thread near 64 Hz
+	::timeBeginPeriod( 1 );
+	::SetThreadPriority( ::GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL );
+#endif
+
+	const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( 1.0 / mRate ) );
+	auto nextTick = std::chrono::steady_clock::now();
+	while( true ) {
+		mPollFn( ci::app::getElapsedSeconds() );
+		mNumPolls.fetch_add( 1, std::memory_order_relaxed );
+
+		nextTick += period;
+		const auto now = std::chrono::steady_clock::now();
+		if( nextTick < now ) {
+			nextTick = now;
+		}
+
+		std::unique_lock<std::mutex> lock( mMutex );
+		mCondition.wait_until( lock, nextTick, [this]() { return ! mRunning; } );
+		if( ! mRunning ) {
+			break;
+		}
+	}
+
+#if defined( CINDER_MSW )
+	::timeEndPeriod( 1 );
+#endif
+}
+
+}} // namespace cinder::vr
@@ -0,0 +1,131 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/MappedFile.h"
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace cinder { namespace vr {
+
+MappedFile::MappedFile( const ci::fs::path& path )
+	: mPath( path )
+{
+#if defined( CINDER_MSW )
+	HANDLE file = ::CreateFileW( mPath.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+	if( INVALID_HANDLE_VALUE == file ) {
+		throw ci::vr::Exception( "Couldn't open file: " + mPath.string() );
+	}
+	mFileHandle = file;
+
+	LARGE_INTEGER fileSize = {};
+	::GetFileSizeEx( file, &fileSize );
+	mSize = static_cast<size_t>( fileSize.QuadPart );
+
+	if( mSize > 0 ) {
+		HANDLE mapping = ::CreateFileMappingW( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		if( nullptr != mapping ) {
+			mMappingHandle = mapping;
+			mData = ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+		}
+	}
+#else
+	int fd = ::open( mPath.string().c_str(), O_RDONLY );
+	if( fd < 0 ) {
+		throw ci::vr::Exception( "Couldn't open file: " + mPath.string() );
+	}
+
+	struct stat st = {};
+	::fstat( fd, &st );
+	mSize = static_cast<size_t>( st.st_size );
+
+	if( mSize > 0 ) {
+		void *data = ::mmap( nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+		mData = ( MAP_FAILED != data ) ? data : nullptr;
+	}
+	// The mapping stays valid after the descriptor is closed
+	::close( fd );
+#endif
+
+	if( ( mSize > 0 ) && ( nullptr == mData ) ) {
+		unmap();
+		throw ci::vr::Exception( "Couldn't map file: " + mPath.string() );
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
+
+MappedFileRef MappedFile::create( const ci::fs::path& path )
+{
+	MappedFileRef result = MappedFileRef( new MappedFile( path ) );
+	return result;
+}
+
+void MappedFile::unmap()
+{
+#if defined( CINDER_MSW )
+	if( nullptr != mData ) {
+		::UnmapViewOfFile( mData );
+	}
+	if( nullptr != mMappingHandle ) {
+		::CloseHandle( static_cast<HANDLE>( mMappingHandle ) );
+	}
+	if( nullptr != mFileHandle ) {
+		::CloseHandle( static_cast<HANDLE>( mFileHandle ) );
+	}
+#else
+	if( nullptr != mData ) {
+		::munmap( mData, mSize );
+	}
+#endif
+	mData = nullptr;
+	mSize = 0;
+	mMappingHandle = nullptr;
+	mFileHandle = nullptr;
+}
+
+}} // namespace cinder::vr
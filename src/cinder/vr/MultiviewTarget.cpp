@@ -0,0 +1,204 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/MultiviewTarget.h"
+#include "cinder/gl/Context.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/gl/wrapper.h"
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#endif
+
+namespace cinder { namespace vr {
+
+// GL_OVR_multiview isn't in the loader, fetched on first use
+#if ! defined( GL_MAX_VIEWS_OVR )
+	#define GL_MAX_VIEWS_OVR 0x9631
+#endif
+
+typedef void ( APIENTRY *FramebufferTextureMultiviewOvrProc )( GLenum target, GLenum attachment, GLuint texture, GLint level, GLint baseViewIndex, GLsizei numViews );
+
+FramebufferTextureMultiviewOvrProc getFramebufferTextureMultiviewOvr()
+{
+	static FramebufferTextureMultiviewOvrProc sProc = nullptr;
+	static bool sLoaded = false;
+	if( ! sLoaded ) {
+#if defined( CINDER_MSW )
+		sProc = reinterpret_cast<FramebufferTextureMultiviewOvrProc>( ::wglGetProcAddress( "glFramebufferTextureMultiviewOVR" ) );
+#endif
+		sLoaded = true;
+	}
+	return sProc;
+}
+
+void checkFramebufferStatus( const std::string& name )
+{
+	GLenum status = glCheckFramebufferStatus( GL_FRAMEBUFFER );
+	if( GL_FRAMEBUFFER_COMPLETE != status ) {
+		throw ci::vr::Exception( "Multiview " + name + " framebuffer is incomplete, status=" + std::to_string( status ) );
+	}
+}
+
+// -------------------------------------------------------------------------------------------------
+// MultiviewTarget
+// -------------------------------------------------------------------------------------------------
+MultiviewTarget::MultiviewTarget( const ci::ivec2& eyeSize, uint32_t samples )
+	: mSize( eyeSize ), mSamples( samples > 1 ? samples : 0 )
+{
+	mMethod = MultiviewTarget::getSupportedMethod();
+	if( MultiviewTarget::METHOD_NONE == mMethod ) {
+		throw ci::vr::Exception( "Multiview and layered rendering aren't supported" );
+	}
+
+	for( auto& layerFramebuffer : mLayerFramebuffers ) {
+		layerFramebuffer = 0;
+	}
+
+	const GLenum target = getTextureTarget();
+	const GLsizei numLayers = static_cast<GLsizei>( ci::vr::EYE_COUNT );
+
+	// Color and depth arrays
+	glGenTextures( 1, &mColorTexture );
+	glGenTextures( 1, &mDepthTexture );
+	{
+		ci::gl::ScopedTextureBind scopedTexture( target, mColorTexture );
+		if( mSamples > 0 ) {
+			glTexImage3DMultisample( target, static_cast<GLsizei>( mSamples ), GL_RGBA8, mSize.x, mSize.y, numLayers, GL_TRUE );
+		}
+		else {
+			glTexImage3D( target, 0, GL_RGBA8, mSize.x, mSize.y, numLayers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+			glTexParameteri( target, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+			glTexParameteri( target, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+			glTexParameteri( target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+			glTexParameteri( target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+		}
+	}
+	{
+		ci::gl::ScopedTextureBind scopedTexture( target, mDepthTexture );
+		if( mSamples > 0 ) {
+			glTexImage3DMultisample( target, static_cast<GLsizei>( mSamples ), GL_DEPTH_COMPONENT24, mSize.x, mSize.y, numLayers, GL_TRUE );
+		}
+		else {
+			glTexImage3D( target, 0, GL_DEPTH_COMPONENT24, mSize.x, mSize.y, numLayers, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr );
+		}
+	}
+
+	// Framebuffer for both layers
+	glGenFramebuffers( 1, &mFramebuffer );
+	{
+		ci::gl::ScopedFramebuffer scopedFramebuffer( GL_FRAMEBUFFER, mFramebuffer );
+		if( MultiviewTarget::METHOD_MULTIVIEW == mMethod ) {
+			FramebufferTextureMultiviewOvrProc framebufferTextureMultiview = getFramebufferTextureMultiviewOvr();
+			framebufferTextureMultiview( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, mColorTexture, 0, 0, numLayers );
+			framebufferTextureMultiview( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mDepthTexture, 0, 0, numLayers );
+		}
+		else {
+			glFramebufferTexture( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, mColorTexture, 0 );
+			glFramebufferTexture( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mDepthTexture, 0 );
+		}
+		checkFramebufferStatus( "stereo" );
+	}
+
+	// Framebuffer per layer
+	glGenFramebuffers( numLayers, mLayerFramebuffers );
+	for( GLint layer = 0; layer < numLayers; ++layer ) {
+		ci::gl::ScopedFramebuffer scopedFramebuffer( GL_FRAMEBUFFER, mLayerFramebuffers[layer] );
+		glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, mColorTexture, 0, layer );
+		glFramebufferTextureLayer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, mDepthTexture, 0, layer );
+		checkFramebufferStatus( "layer" );
+	}
+}
+
+MultiviewTarget::~MultiviewTarget()
+{
+	glDeleteFramebuffers( static_cast<GLsizei>( ci::vr::EYE_COUNT ), mLayerFramebuffers );
+	glDeleteFramebuffers( 1, &mFramebuffer );
+	glDeleteTextures( 1, &mDepthTexture );
+	glDeleteTextures( 1, &mColorTexture );
+}
+
+MultiviewTargetRef MultiviewTarget::create( const ci::ivec2& eyeSize, uint32_t samples )
+{
+	MultiviewTargetRef result = MultiviewTargetRef( new MultiviewTarget( eyeSize, samples ) );
+	return result;
+}
+
+MultiviewTarget::Method MultiviewTarget::getSupportedMethod()
+{
+	MultiviewTarget::Method result = MultiviewTarget::METHOD_NONE;
+	if( ci::gl::isExtensionAvailable( "GL_OVR_multiview2" ) && ( nullptr != getFramebufferTextureMultiviewOvr() ) ) {
+		GLint maxViews = 0;
+		glGetIntegerv( GL_MAX_VIEWS_OVR, &maxViews );
+		if( maxViews >= static_cast<GLint>( ci::vr::EYE_COUNT ) ) {
+			result = MultiviewTarget::METHOD_MULTIVIEW;
+		}
+	}
+
+	if( ( MultiviewTarget::METHOD_NONE == result ) && ( ci::gl::isExtensionAvailable( "GL_ARB_shader_viewport_layer_array" ) || ci::gl::isExtensionAvailable( "GL_AMD_vertex_shader_layer" ) ) ) {
+		result = MultiviewTarget::METHOD_LAYERED;
+	}
+
+	return result;
+}
+
+GLenum MultiviewTarget::getTextureTarget() const
+{
+	return ( mSamples > 0 ) ? GL_TEXTURE_2D_MULTISAMPLE_ARRAY : GL_TEXTURE_2D_ARRAY;
+}
+
+void MultiviewTarget::bind()
+{
+	ci::gl::context()->bindFramebuffer( GL_FRAMEBUFFER, mFramebuffer );
+}
+
+void MultiviewTarget::bindLayer( ci::vr::Eye eye )
+{
+	ci::gl::context()->bindFramebuffer( GL_FRAMEBUFFER, mLayerFramebuffers[eye] );
+}
+
+void MultiviewTarget::resolve( ci::vr::Eye eye, const ci::gl::FboRef& dst, const ci::Area& dstArea )
+{
+	ci::gl::ScopedFramebuffer scopedReadFramebuffer( GL_READ_FRAMEBUFFER, mLayerFramebuffers[eye] );
+	ci::gl::ScopedFramebuffer scopedDrawFramebuffer( GL_DRAW_FRAMEBUFFER, dst->getId() );
+	glBlitFramebuffer( 0, 0, dstArea.getWidth(), dstArea.getHeight(), dstArea.x1, dstArea.y1, dstArea.x2, dstArea.y2, GL_COLOR_BUFFER_BIT, GL_NEAREST );
+	// Written behind the Fbo's back, its textures need resolving again
+	dst->markAsDirty();
+}
+
+}} // namespace cinder::vr
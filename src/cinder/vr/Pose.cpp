@@ -0,0 +1,107 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/Pose.h"
+#include "cinder/CinderGlm.h"
+
+#include <cmath>
+
+namespace cinder { namespace vr {
+
+ci::mat4 extrapolatePose( const ci::mat4& deviceToTracking, const ci::vec3& linearVelocity, const ci::vec3& angularVelocity, float dt )
+{
+	ci::mat4 result = deviceToTracking;
+
+	// Rotate about the device's position, the angular velocity is in tracking space
+	float speed = glm::length( angularVelocity );
+	if( speed > 0.0f ) {
+		ci::mat4 rotation = glm::rotate( speed * dt, angularVelocity / speed );
+		result = rotation * result;
+	}
+
+	ci::vec3 position = ci::vec3( deviceToTracking[3] ) + linearVelocity * dt;
+	result[3] = ci::vec4( position, 1.0f );
+	return result;
+}
+
+void calculateVelocities( const ci::mat4& prevDeviceToTracking, const ci::mat4& deviceToTracking, float dt, ci::vec3 *outLinearVelocity, ci::vec3 *outAngularVelocity )
+{
+	if( dt <= 0.0f ) {
+		*outLinearVelocity = ci::vec3( 0 );
+		*outAngularVelocity = ci::vec3( 0 );
+		return;
+	}
+
+	*outLinearVelocity = ( ci::vec3( deviceToTracking[3] ) - ci::vec3( prevDeviceToTracking[3] ) ) / dt;
+
+	ci::quat prevOrientation = glm::quat_cast( ci::mat3( prevDeviceToTracking ) );
+	ci::quat orientation = glm::quat_cast( ci::mat3( deviceToTracking ) );
+	ci::quat delta = orientation * glm::inverse( prevOrientation );
+	// Take the short way round
+	if( delta.w < 0.0f ) {
+		delta = -delta;
+	}
+
+	float angle = glm::angle( delta );
+	*outAngularVelocity = ( angle > 0.0f ) ? ( glm::axis( delta ) * ( angle / dt ) ) : ci::vec3( 0 );
+}
+
+// -------------------------------------------------------------------------------------------------
+// TrackedPose
+// -------------------------------------------------------------------------------------------------
+void TrackedPose::set( const ci::mat4& deviceToTracking, const ci::vec3& linearVelocity, const ci::vec3& angularVelocity, double sampleTime )
+{
+	mValid = true;
+	mDeviceToTrackingMatrix = deviceToTracking;
+	mLinearVelocity = linearVelocity;
+	mAngularVelocity = angularVelocity;
+	mSampleTime = sampleTime;
+}
+
+ci::mat4 TrackedPose::extrapolate( double targetTime ) const
+{
+	if( ! mValid ) {
+		return mDeviceToTrackingMatrix;
+	}
+
+	float dt = static_cast<float>( clampPredictionInterval( targetTime - mSampleTime ) );
+	ci::mat4 result = extrapolatePose( mDeviceToTrackingMatrix, mLinearVelocity, mAngularVelocity, dt );
+	return result;
+}
+
+}} // namespace cinder::vr
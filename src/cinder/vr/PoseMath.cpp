@@ -0,0 +1,288 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/PoseMath.h"
+
+#if defined( CINDER_VR_ENABLE_SSE2 )
+	#include <emmintrin.h>
+#endif
+
+namespace cinder { namespace vr {
+
+namespace {
+
+inline const float* sourceAt( const void *src, size_t srcStride, size_t index )
+{
+	return reinterpret_cast<const float*>( reinterpret_cast<const uint8_t*>( src ) + ( index * srcStride ) );
+}
+
+// Writes the column major rotation of the unit quaternion \a q (x, y, z, w) into \a m.
+inline void quatToColumns( const float *q, float *m )
+{
+	const float x = q[0], y = q[1], z = q[2], w = q[3];
+	const float xx = x*x, yy = y*y, zz = z*z;
+	const float xy = x*y, xz = x*z, yz = y*z;
+	const float wx = w*x, wy = w*y, wz = w*z;
+	m[ 0] = 1.0f - 2.0f*( yy + zz ); m[ 1] = 2.0f*( xy + wz );        m[ 2] = 2.0f*( xz - wy );        m[ 3] = 0.0f;
+	m[ 4] = 2.0f*( xy - wz );        m[ 5] = 1.0f - 2.0f*( xx + zz ); m[ 6] = 2.0f*( yz + wx );        m[ 7] = 0.0f;
+	m[ 8] = 2.0f*( xz + wy );        m[ 9] = 2.0f*( yz - wx );        m[10] = 1.0f - 2.0f*( xx + yy ); m[11] = 0.0f;
+}
+
+} // anonymous namespace
+
+#if defined( CINDER_VR_ENABLE_SSE2 )
+
+// -------------------------------------------------------------------------------------------------
+// SSE2
+// -------------------------------------------------------------------------------------------------
+void convertRowMajor3x4( const void *src, size_t srcStride, ci::mat4 *dst, size_t count )
+{
+	const __m128 row3 = _mm_set_ps( 1.0f, 0.0f, 0.0f, 0.0f );
+	for( size_t i = 0; i < count; ++i ) {
+		const float *s = sourceAt( src, srcStride, i );
+		__m128 c0 = _mm_loadu_ps( s + 0 );
+		__m128 c1 = _mm_loadu_ps( s + 4 );
+		__m128 c2 = _mm_loadu_ps( s + 8 );
+		__m128 c3 = row3;
+		_MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+		float *d = &dst[i][0][0];
+		_mm_storeu_ps( d +  0, c0 );
+		_mm_storeu_ps( d +  4, c1 );
+		_mm_storeu_ps( d +  8, c2 );
+		_mm_storeu_ps( d + 12, c3 );
+	}
+}
+
+void convertQuatPosition( const void *src, size_t srcStride, ci::mat4 *dst, size_t count )
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 two = _mm_set1_ps( 2.0f );
+
+	// Four poses per iteration: gather into lanes, expand the quaternions side by side, then
+	// transpose so that each output column is contiguous again.
+	size_t i = 0;
+	for( ; ( i + 4 ) <= count; i += 4 ) {
+		const float *s0 = sourceAt( src, srcStride, i + 0 );
+		const float *s1 = sourceAt( src, srcStride, i + 1 );
+		const float *s2 = sourceAt( src, srcStride, i + 2 );
+		const float *s3 = sourceAt( src, srcStride, i + 3 );
+		__m128 x  = _mm_set_ps( s3[0], s2[0], s1[0], s0[0] );
+		__m128 y  = _mm_set_ps( s3[1], s2[1], s1[1], s0[1] );
+		__m128 z  = _mm_set_ps( s3[2], s2[2], s1[2], s0[2] );
+		__m128 w  = _mm_set_ps( s3[3], s2[3], s1[3], s0[3] );
+		__m128 px = _mm_set_ps( s3[4], s2[4], s1[4], s0[4] );
+		__m128 py = _mm_set_ps( s3[5], s2[5], s1[5], s0[5] );
+		__m128 pz = _mm_set_ps( s3[6], s2[6], s1[6], s0[6] );
+
+		__m128 x2 = _mm_mul_ps( x, two );
+		__m128 y2 = _mm_mul_ps( y, two );
+		__m128 z2 = _mm_mul_ps( z, two );
+		__m128 xx = _mm_mul_ps( x, x2 ), yy = _mm_mul_ps( y, y2 ), zz = _mm_mul_ps( z, z2 );
+		__m128 xy = _mm_mul_ps( x, y2 ), xz = _mm_mul_ps( x, z2 ), yz = _mm_mul_ps( y, z2 );
+		__m128 wx = _mm_mul_ps( w, x2 ), wy = _mm_mul_ps( w, y2 ), wz = _mm_mul_ps( w, z2 );
+
+		__m128 m00 = _mm_sub_ps( one, _mm_add_ps( yy, zz ) );
+		__m128 m01 = _mm_add_ps( xy, wz );
+		__m128 m02 = _mm_sub_ps( xz, wy );
+		__m128 m03 = zero;
+		__m128 m10 = _mm_sub_ps( xy, wz );
+		__m128 m11 = _mm_sub_ps( one, _mm_add_ps( xx, zz ) );
+		__m128 m12 = _mm_add_ps( yz, wx );
+		__m128 m13 = zero;
+		__m128 m20 = _mm_add_ps( xz, wy );
+		__m128 m21 = _mm_sub_ps( yz, wx );
+		__m128 m22 = _mm_sub_ps( one, _mm_add_ps( xx, yy ) );
+		__m128 m23 = zero;
+		__m128 m33 = one;
+		_MM_TRANSPOSE4_PS( m00, m01, m02, m03 );
+		_MM_TRANSPOSE4_PS( m10, m11, m12, m13 );
+		_MM_TRANSPOSE4_PS( m20, m21, m22, m23 );
+		_MM_TRANSPOSE4_PS( px, py, pz, m33 );
+
+		const __m128 columns[4][4] = {
+			{ m00, m10, m20, px },
+			{ m01, m11, m21, py },
+			{ m02, m12, m22, pz },
+			{ m03, m13, m23, m33 },
+		};
+		for( size_t j = 0; j < 4; ++j ) {
+			float *d = &dst[i + j][0][0];
+			_mm_storeu_ps( d +  0, columns[j][0] );
+			_mm_storeu_ps( d +  4, columns[j][1] );
+			_mm_storeu_ps( d +  8, columns[j][2] );
+			_mm_storeu_ps( d + 12, columns[j][3] );
+		}
+	}
+
+	// Remainder
+	for( ; i < count; ++i ) {
+		const float *s = sourceAt( src, srcStride, i );
+		float *d = &dst[i][0][0];
+		quatToColumns( s, d );
+		d[12] = s[4]; d[13] = s[5]; d[14] = s[6]; d[15] = 1.0f;
+	}
+}
+
+void invertRigid( const ci::mat4 *src, ci::mat4 *dst, size_t count )
+{
+	const __m128 row3 = _mm_set_ps( 1.0f, 0.0f, 0.0f, 0.0f );
+	for( size_t i = 0; i < count; ++i ) {
+		const float *s = &src[i][0][0];
+		__m128 c0 = _mm_loadu_ps( s +  0 );
+		__m128 c1 = _mm_loadu_ps( s +  4 );
+		__m128 c2 = _mm_loadu_ps( s +  8 );
+		__m128 t  = _mm_loadu_ps( s + 12 );
+		__m128 c3 = _mm_setzero_ps();
+		// Transposed rotation
+		_MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+		// -R^T * t, the transposed rotation has zero w so subtracting from row3 also sets w to 1
+		__m128 p = _mm_mul_ps( c0, _mm_shuffle_ps( t, t, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+		p = _mm_add_ps( p, _mm_mul_ps( c1, _mm_shuffle_ps( t, t, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+		p = _mm_add_ps( p, _mm_mul_ps( c2, _mm_shuffle_ps( t, t, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+		p = _mm_sub_ps( row3, p );
+		float *d = &dst[i][0][0];
+		_mm_storeu_ps( d +  0, c0 );
+		_mm_storeu_ps( d +  4, c1 );
+		_mm_storeu_ps( d +  8, c2 );
+		_mm_storeu_ps( d + 12, p );
+	}
+}
+
+void multiplyTransforms( const ci::mat4& lhs, const ci::mat4 *src, ci::mat4 *dst, size_t count )
+{
+	const float *l = &lhs[0][0];
+	const __m128 l0 = _mm_loadu_ps( l +  0 );
+	const __m128 l1 = _mm_loadu_ps( l +  4 );
+	const __m128 l2 = _mm_loadu_ps( l +  8 );
+	const __m128 l3 = _mm_loadu_ps( l + 12 );
+	for( size_t i = 0; i < count; ++i ) {
+		const float *s = &src[i][0][0];
+		__m128 r[4];
+		for( int c = 0; c < 4; ++c ) {
+			__m128 col = _mm_loadu_ps( s + 4*c );
+			__m128 v = _mm_mul_ps( l0, _mm_shuffle_ps( col, col, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+			v = _mm_add_ps( v, _mm_mul_ps( l1, _mm_shuffle_ps( col, col, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+			v = _mm_add_ps( v, _mm_mul_ps( l2, _mm_shuffle_ps( col, col, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+			v = _mm_add_ps( v, _mm_mul_ps( l3, _mm_shuffle_ps( col, col, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+			r[c] = v;
+		}
+		float *d = &dst[i][0][0];
+		_mm_storeu_ps( d +  0, r[0] );
+		_mm_storeu_ps( d +  4, r[1] );
+		_mm_storeu_ps( d +  8, r[2] );
+		_mm_storeu_ps( d + 12, r[3] );
+	}
+}
+
+#else // defined( CINDER_VR_ENABLE_SSE2 )
+
+// -------------------------------------------------------------------------------------------------
+// Scalar
+// -------------------------------------------------------------------------------------------------
+void convertRowMajor3x4( const void *src, size_t srcStride, ci::mat4 *dst, size_t count )
+{
+	for( size_t i = 0; i < count; ++i ) {
+		const float *s = sourceAt( src, srcStride, i );
+		float *d = &dst[i][0][0];
+		for( int c = 0; c < 4; ++c ) {
+			d[4*c + 0] = s[0 + c];
+			d[4*c + 1] = s[4 + c];
+			d[4*c + 2] = s[8 + c];
+			d[4*c + 3] = ( 3 == c ) ? 1.0f : 0.0f;
+		}
+	}
+}
+
+void convertQuatPosition( const void *src, size_t srcStride, ci::mat4 *dst, size_t count )
+{
+	for( size_t i = 0; i < count; ++i ) {
+		const float *s = sourceAt( src, srcStride, i );
+		float *d = &dst[i][0][0];
+		quatToColumns( s, d );
+		d[12] = s[4]; d[13] = s[5]; d[14] = s[6]; d[15] = 1.0f;
+	}
+}
+
+void invertRigid( const ci::mat4 *src, ci::mat4 *dst, size_t count )
+{
+	for( size_t i = 0; i < count; ++i ) {
+		float s[16];
+		const float *p = &src[i][0][0];
+		for( int j = 0; j < 16; ++j ) {
+			s[j] = p[j];
+		}
+		float *d = &dst[i][0][0];
+		for( int c = 0; c < 3; ++c ) {
+			d[4*c + 0] = s[c + 0];
+			d[4*c + 1] = s[c + 4];
+			d[4*c + 2] = s[c + 8];
+			d[4*c + 3] = 0.0f;
+		}
+		for( int r = 0; r < 3; ++r ) {
+			d[12 + r] = -( s[4*r + 0]*s[12] + s[4*r + 1]*s[13] + s[4*r + 2]*s[14] );
+		}
+		d[15] = 1.0f;
+	}
+}
+
+void multiplyTransforms( const ci::mat4& lhs, const ci::mat4 *src, ci::mat4 *dst, size_t count )
+{
+	float l[16];
+	const float *p = &lhs[0][0];
+	for( int j = 0; j < 16; ++j ) {
+		l[j] = p[j];
+	}
+	for( size_t i = 0; i < count; ++i ) {
+		float s[16];
+		p = &src[i][0][0];
+		for( int j = 0; j < 16; ++j ) {
+			s[j] = p[j];
+		}
+		float *d = &dst[i][0][0];
+		for( int c = 0; c < 4; ++c ) {
+			for( int r = 0; r < 4; ++r ) {
+				d[4*c + r] = l[r]*s[4*c + 0] + l[4 + r]*s[4*c + 1] + l[8 + r]*s[4*c + 2] + l[12 + r]*s[4*c + 3];
+			}
+		}
+	}
+}
+
+#endif // defined( CINDER_VR_ENABLE_SSE2 )
+
+}} // namespace cinder::vr
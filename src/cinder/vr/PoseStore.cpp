@@ -0,0 +1,155 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/PoseStore.h"
+#include "cinder/vr/PoseMath.h"
+#include "cinder/CinderGlm.h"
+
+#include <cstring>
+
+namespace cinder { namespace vr {
+
+PoseStore::PoseStore()
+{
+	for( uint32_t i = 0; i < kPoseStoreMaxDevices; ++i ) {
+		mPositions[i] = ci::vec3( 0 );
+		mRotations[i] = ci::quat();
+		mLinearVelocities[i] = ci::vec3( 0 );
+		mAngularVelocities[i] = ci::vec3( 0 );
+		mSampleTimes[i] = 0.0;
+		mDeviceGenerations[i] = 0;
+	}
+}
+
+void PoseStore::beginUpdate()
+{
+	++mGeneration;
+	mChangedMask = 0;
+}
+
+void PoseStore::endUpdate()
+{
+	uint64_t dirtyMask = mChangedMask & mValidMask;
+	forEachDevice( dirtyMask, [this]( uint32_t deviceIndex ) {
+		ci::vr::invertRigid( &mDeviceToTrackingMatrices[deviceIndex], &mTrackingToDeviceMatrices[deviceIndex], 1 );
+	} );
+}
+
+void PoseStore::markChanged( uint32_t deviceIndex )
+{
+	const uint64_t bit = 1ULL << deviceIndex;
+	mValidMask |= bit;
+	mChangedMask |= bit;
+	mDeviceGenerations[deviceIndex] = mGeneration;
+}
+
+void PoseStore::setPose( uint32_t deviceIndex, const ci::mat4& deviceToTracking, const ci::vec3& linearVelocity, const ci::vec3& angularVelocity, double sampleTime )
+{
+	if( deviceIndex >= kPoseStoreMaxDevices ) {
+		return;
+	}
+
+	mLinearVelocities[deviceIndex] = linearVelocity;
+	mAngularVelocities[deviceIndex] = angularVelocity;
+	mSampleTimes[deviceIndex] = sampleTime;
+
+	// Bitwise compare, trackers report static devices with identical values every frame
+	if( isValid( deviceIndex ) && ( 0 == std::memcmp( &mDeviceToTrackingMatrices[deviceIndex], &deviceToTracking, sizeof( ci::mat4 ) ) ) ) {
+		return;
+	}
+
+	mDeviceToTrackingMatrices[deviceIndex] = deviceToTracking;
+	mPositions[deviceIndex] = ci::vec3( deviceToTracking[3] );
+	mRotations[deviceIndex] = glm::quat_cast( ci::mat3( deviceToTracking ) );
+	markChanged( deviceIndex );
+}
+
+void PoseStore::setPose( uint32_t deviceIndex, const ci::vec3& position, const ci::quat& rotation, const ci::vec3& linearVelocity, const ci::vec3& angularVelocity, double sampleTime )
+{
+	if( deviceIndex >= kPoseStoreMaxDevices ) {
+		return;
+	}
+
+	mLinearVelocities[deviceIndex] = linearVelocity;
+	mAngularVelocities[deviceIndex] = angularVelocity;
+	mSampleTimes[deviceIndex] = sampleTime;
+
+	if( isValid( deviceIndex ) && ( position == mPositions[deviceIndex] ) && ( rotation == mRotations[deviceIndex] ) ) {
+		return;
+	}
+
+	mPositions[deviceIndex] = position;
+	mRotations[deviceIndex] = rotation;
+	const float packed[7] = { rotation.x, rotation.y, rotation.z, rotation.w, position.x, position.y, position.z };
+	ci::vr::convertQuatPosition( packed, sizeof( packed ), &mDeviceToTrackingMatrices[deviceIndex], 1 );
+	markChanged( deviceIndex );
+}
+
+void PoseStore::invalidate( uint32_t deviceIndex )
+{
+	if( ! isValid( deviceIndex ) ) {
+		return;
+	}
+
+	const uint64_t bit = 1ULL << deviceIndex;
+	mValidMask &= ~bit;
+	mChangedMask |= bit;
+	mDeviceGenerations[deviceIndex] = mGeneration;
+}
+
+ci::mat4 PoseStore::extrapolate( uint32_t deviceIndex, double targetTime ) const
+{
+	if( ! isValid( deviceIndex ) ) {
+		return ( deviceIndex < kPoseStoreMaxDevices ) ? mDeviceToTrackingMatrices[deviceIndex] : ci::mat4();
+	}
+
+	float dt = static_cast<float>( ci::vr::clampPredictionInterval( targetTime - mSampleTimes[deviceIndex] ) );
+	ci::mat4 result = ci::vr::extrapolatePose( mDeviceToTrackingMatrices[deviceIndex], mLinearVelocities[deviceIndex], mAngularVelocities[deviceIndex], dt );
+	return result;
+}
+
+ci::vr::TrackedPose PoseStore::getTrackedPose( uint32_t deviceIndex ) const
+{
+	ci::vr::TrackedPose result;
+	if( isValid( deviceIndex ) ) {
+		result.set( mDeviceToTrackingMatrices[deviceIndex], mLinearVelocities[deviceIndex], mAngularVelocities[deviceIndex], mSampleTimes[deviceIndex] );
+	}
+	return result;
+}
+
+}} // namespace cinder::vr
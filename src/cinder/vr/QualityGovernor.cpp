@@ -0,0 +1,229 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/QualityGovernor.h"
+#include "cinder/Log.h"
+
+#include <algorithm>
+
+namespace cinder { namespace vr {
+
+// Upper limit for the raise window multiplier
+const uint32_t kMaxRaiseBackoff = 8;
+
+// -------------------------------------------------------------------------------------------------
+// QualityGovernor::Knob
+// -------------------------------------------------------------------------------------------------
+QualityGovernor::Knob::Knob( const std::string& name, int32_t minLevel, int32_t maxLevel, int32_t level, float cost, const Callback& callback )
+	: mName( name ), mMinLevel( minLevel ), mMaxLevel( maxLevel ), mCost( cost ), mCallback( callback )
+{
+	if( mMinLevel > mMaxLevel ) {
+		mMinLevel = mMaxLevel;
+	}
+	setLevel( level );
+}
+
+void QualityGovernor::Knob::setLevel( int32_t level )
+{
+	mLevel = ( level < mMinLevel ) ? mMinLevel : ( ( level > mMaxLevel ) ? mMaxLevel : level );
+}
+
+// -------------------------------------------------------------------------------------------------
+// QualityGovernor
+// -------------------------------------------------------------------------------------------------
+QualityGovernor::QualityGovernor()
+{
+}
+
+QualityGovernor::~QualityGovernor()
+{
+}
+
+QualityGovernorRef QualityGovernor::create()
+{
+	QualityGovernorRef result = QualityGovernorRef( new QualityGovernor() );
+	return result;
+}
+
+QualityGovernor::Knob* QualityGovernor::addKnob( const std::string& name, int32_t minLevel, int32_t maxLevel, int32_t level, float cost, const Knob::Callback& callback )
+{
+	if( getKnob( name ) ) {
+		throw ci::vr::Exception( "Quality knob already exists: " + name );
+	}
+
+	mKnobs.push_back( std::unique_ptr<Knob>( new Knob( name, minLevel, maxLevel, level, cost, callback ) ) );
+	Knob* result = mKnobs.back().get();
+	return result;
+}
+
+void QualityGovernor::removeKnob( const std::string& name )
+{
+	mKnobs.erase(
+		std::remove_if( std::begin( mKnobs ), std::end( mKnobs ),
+			[&name]( const std::unique_ptr<Knob>& elem ) -> bool {
+				return name == elem->getName();
+			}
+		),
+		std::end( mKnobs )
+	);
+}
+
+QualityGovernor::Knob* QualityGovernor::getKnob( const std::string& name ) const
+{
+	Knob* result = nullptr;
+	for( const auto& knob : mKnobs ) {
+		if( name == knob->getName() ) {
+			result = knob.get();
+			break;
+		}
+	}
+	return result;
+}
+
+void QualityGovernor::update( const ci::vr::QualityGovernor::FrameStats& stats )
+{
+	mLastFrameStats = stats;
+	++mFrameIndex;
+
+	mSignalFrameStats.emit( stats );
+
+	if( stats.budgetSeconds <= 0.0 ) {
+		return;
+	}
+
+	// A raise that survived its own window is good, start trusting raises again
+	if( mRaisePending && ( ( mFrameIndex - mLastRaiseFrame ) >= mRaiseFrames ) ) {
+		mRaisePending = false;
+		mRaiseBackoff = ( mRaiseBackoff > 1 ) ? ( mRaiseBackoff / 2 ) : 1;
+	}
+
+	// Let the last change show up in the timings
+	if( mCooldown > 0 ) {
+		--mCooldown;
+		return;
+	}
+
+	uint32_t numMissed = stats.numDroppedFrames + stats.numReprojectedFrames;
+	double headroom = stats.getHeadroom();
+	if( ( numMissed > 0 ) || ( stats.hasGpuTime() && ( headroom < mLowerHeadroom ) ) ) {
+		mOverFrames += ( numMissed > 0 ) ? numMissed : 1;
+		mUnderFrames = 0;
+	}
+	else if( stats.hasGpuTime() && ( headroom > mRaiseHeadroom ) ) {
+		mUnderFrames += 1;
+		mOverFrames = 0;
+	}
+	else {
+		// Inside the band, or no GPU time to go on
+		mOverFrames = 0;
+		mUnderFrames = 0;
+	}
+
+	bool changed = false;
+	if( mOverFrames >= mLowerFrames ) {
+		changed = lower();
+		if( changed && mRaisePending ) {
+			// Undid a recent raise, wait longer before the next one
+			mRaisePending = false;
+			mRaiseBackoff = ( mRaiseBackoff < kMaxRaiseBackoff ) ? ( mRaiseBackoff * 2 ) : kMaxRaiseBackoff;
+		}
+	}
+	else if( mUnderFrames >= ( mRaiseFrames * mRaiseBackoff ) ) {
+		changed = raise();
+		if( changed ) {
+			mRaisePending = true;
+			mLastRaiseFrame = mFrameIndex;
+		}
+	}
+
+	if( changed ) {
+		mOverFrames = 0;
+		mUnderFrames = 0;
+		mCooldown = mCooldownFrames;
+	}
+}
+
+bool QualityGovernor::lower()
+{
+	Knob* knob = nullptr;
+	for( const auto& elem : mKnobs ) {
+		if( elem->isLocked() || ( elem->getLevel() <= elem->getMinLevel() ) ) {
+			continue;
+		}
+		if( ( nullptr == knob ) || ( elem->getCost() > knob->getCost() ) ) {
+			knob = elem.get();
+		}
+	}
+
+	if( nullptr == knob ) {
+		return false;
+	}
+
+	knob->mLevel -= 1;
+	CI_LOG_I( "Quality knob " << knob->getName() << " lowered to " << knob->getLevel() );
+	if( knob->mCallback ) {
+		knob->mCallback( knob->getLevel() );
+	}
+	return true;
+}
+
+bool QualityGovernor::raise()
+{
+	Knob* knob = nullptr;
+	for( const auto& elem : mKnobs ) {
+		if( elem->isLocked() || ( elem->getLevel() >= elem->getMaxLevel() ) ) {
+			continue;
+		}
+		if( ( nullptr == knob ) || ( elem->getCost() < knob->getCost() ) ) {
+			knob = elem.get();
+		}
+	}
+
+	if( nullptr == knob ) {
+		return false;
+	}
+
+	knob->mLevel += 1;
+	CI_LOG_I( "Quality knob " << knob->getName() << " raised to " << knob->getLevel() );
+	if( knob->mCallback ) {
+		knob->mCallback( knob->getLevel() );
+	}
+	return true;
+}
+
+}} // namespace cinder::vr
@@ -0,0 +1,791 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/RayQuery.h"
+#include "cinder/vr/Context.h"
+#include "cinder/vr/Controller.h"
+#include "cinder/vr/Hmd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <thread>
+
+namespace cinder { namespace vr {
+
+namespace {
+
+const uint32_t kMaxLeafItems = 4;
+const uint32_t kMaxStackDepth = 64;
+// Rebuild once refits have grown the summed node area past this factor of the built area
+const float kMaxRefitGrowth = 2.0f;
+// Smallest share of a batch worth a thread of its own
+const size_t kMinRaysPerThread = 64;
+
+inline float minf( float a, float b )
+{
+	return ( a < b ) ? a : b;
+}
+
+inline float maxf( float a, float b )
+{
+	return ( a > b ) ? a : b;
+}
+
+inline bool intersectBox( const ci::vec3& boxMin, const ci::vec3& boxMax, const ci::vec3& origin, const ci::vec3& invDirection, float maxDistance, float *outDistance )
+{
+	float t0 = ( boxMin.x - origin.x ) * invDirection.x;
+	float t1 = ( boxMax.x - origin.x ) * invDirection.x;
+	float tNear = minf( t0, t1 );
+	float tFar = maxf( t0, t1 );
+
+	t0 = ( boxMin.y - origin.y ) * invDirection.y;
+	t1 = ( boxMax.y - origin.y ) * invDirection.y;
+	tNear = maxf( tNear, minf( t0, t1 ) );
+	tFar = minf( tFar, maxf( t0, t1 ) );
+
+	t0 = ( boxMin.z - origin.z ) * invDirection.z;
+	t1 = ( boxMax.z - origin.z ) * invDirection.z;
+	tNear = maxf( tNear, minf( t0, t1 ) );
+	tFar = minf( tFar, maxf( t0, t1 ) );
+
+	// Origins inside the box hit at 0
+	tNear = maxf( tNear, 0.0f );
+	if( ( tNear > tFar ) || ( tNear > maxDistance ) ) {
+		return false;
+	}
+
+	*outDistance = tNear;
+	return true;
+}
+
+inline bool intersectSphere( const ci::vec3& center, float radius, const ci::vec3& origin, const ci::vec3& direction, float maxDistance, float *outDistance )
+{
+	const ci::vec3 oc = origin - center;
+	const float c = glm::dot( oc, oc ) - ( radius * radius );
+	// Origins inside the sphere hit at 0
+	if( c <= 0.0f ) {
+		*outDistance = 0.0f;
+		return true;
+	}
+
+	const float a = glm::dot( direction, direction );
+	const float b = glm::dot( oc, direction );
+	if( ( b >= 0.0f ) || ( a <= 0.0f ) ) {
+		return false;
+	}
+
+	const float discriminant = ( b * b ) - ( a * c );
+	if( discriminant < 0.0f ) {
+		return false;
+	}
+
+	const float t = ( -b - std::sqrt( discriminant ) ) / a;
+	if( t > maxDistance ) {
+		return false;
+	}
+
+	*outDistance = t;
+	return true;
+}
+
+inline bool intersectTriangle( const ci::vec3& p0, const ci::vec3& p1, const ci::vec3& p2, const ci::vec3& origin, const ci::vec3& direction, float maxDistance, float *outDistance )
+{
+	const ci::vec3 e1 = p1 - p0;
+	const ci::vec3 e2 = p2 - p0;
+	const ci::vec3 pv = glm::cross( direction, e2 );
+	const float det = glm::dot( e1, pv );
+	if( 0.0f == det ) {
+		return false;
+	}
+
+	const float invDet = 1.0f / det;
+	const ci::vec3 tv = origin - p0;
+	const float u = glm::dot( tv, pv ) * invDet;
+	if( ( u < 0.0f ) || ( u > 1.0f ) ) {
+		return false;
+	}
+
+	const ci::vec3 qv = glm::cross( tv, e1 );
+	const float v = glm::dot( direction, qv ) * invDet;
+	if( ( v < 0.0f ) || ( ( u + v ) > 1.0f ) ) {
+		return false;
+	}
+
+	const float t = glm::dot( e2, qv ) * invDet;
+	if( ( t < 0.0f ) || ( t > maxDistance ) ) {
+		return false;
+	}
+
+	*outDistance = t;
+	return true;
+}
+
+//! Visits the leaves whose bounds the ray enters before \a maxDistance, nearest child first.
+//! \a leafFn( first, count ) may lower \a maxDistance to prune the rest of the traversal.
+template <typename NodeT, typename LeafFn>
+void traverse( const std::vector<NodeT>& nodes, const ci::vec3& origin, const ci::vec3& invDirection, float *maxDistance, const LeafFn& leafFn )
+{
+	struct Entry {
+		uint32_t	node;
+		float		distance;
+	};
+
+	float t = 0.0f;
+	if( nodes.empty() || ( ! intersectBox( nodes[0].bounds.min, nodes[0].bounds.max, origin, invDirection, *maxDistance, &t ) ) ) {
+		return;
+	}
+
+	Entry stack[kMaxStackDepth];
+	uint32_t top = 0;
+	stack[top].node = 0;
+	stack[top].distance = t;
+	++top;
+
+	while( top > 0 ) {
+		const Entry entry = stack[--top];
+		if( entry.distance > *maxDistance ) {
+			continue;
+		}
+
+		const NodeT& node = nodes[entry.node];
+		if( node.count > 0 ) {
+			leafFn( node.first, node.count );
+			continue;
+		}
+
+		const uint32_t left = entry.node + 1;
+		const uint32_t right = node.first;
+		float tLeft = 0.0f;
+		float tRight = 0.0f;
+		const bool hitLeft = intersectBox( nodes[left].bounds.min, nodes[left].bounds.max, origin, invDirection, *maxDistance, &tLeft );
+		const bool hitRight = intersectBox( nodes[right].bounds.min, nodes[right].bounds.max, origin, invDirection, *maxDistance, &tRight );
+
+		// Push the far child first so the near child pops next
+		if( hitLeft && hitRight ) {
+			const bool leftFirst = ( tLeft <= tRight );
+			stack[top].node = leftFirst ? right : left;
+			stack[top].distance = leftFirst ? tRight : tLeft;
+			++top;
+			stack[top].node = leftFirst ? left : right;
+			stack[top].distance = leftFirst ? tLeft : tRight;
+			++top;
+		}
+		else if( hitLeft ) {
+			stack[top].node = left;
+			stack[top].distance = tLeft;
+			++top;
+		}
+		else if( hitRight ) {
+			stack[top].node = right;
+			stack[top].distance = tRight;
+			++top;
+		}
+	}
+}
+
+} // anonymous namespace
+
+// -------------------------------------------------------------------------------------------------
+// RayQuery::Bounds
+// -------------------------------------------------------------------------------------------------
+void RayQuery::Bounds::include( const ci::vec3& p )
+{
+	min = glm::min( min, p );
+	max = glm::max( max, p );
+}
+
+void RayQuery::Bounds::include( const Bounds& b )
+{
+	min = glm::min( min, b.min );
+	max = glm::max( max, b.max );
+}
+
+float RayQuery::Bounds::getArea() const
+{
+	if( ( min.x > max.x ) || ( min.y > max.y ) || ( min.z > max.z ) ) {
+		return 0.0f;
+	}
+
+	const ci::vec3 d = max - min;
+	float result = 2.0f * ( ( d.x * d.y ) + ( d.y * d.z ) + ( d.z * d.x ) );
+	return result;
+}
+
+// -------------------------------------------------------------------------------------------------
+// RayQuery::RayData
+// -------------------------------------------------------------------------------------------------
+struct RayQuery::RayData {
+	ci::vec3	origin;
+	ci::vec3	direction;
+	ci::vec3	invDirection;
+
+	RayData( const ci::vec3& aOrigin, const ci::vec3& aDirection )
+		: origin( aOrigin ), direction( aDirection ), invDirection( 1.0f / aDirection.x, 1.0f / aDirection.y, 1.0f / aDirection.z ) {}
+};
+
+// -------------------------------------------------------------------------------------------------
+// RayQuery
+// -------------------------------------------------------------------------------------------------
+RayQuery::RayQuery()
+{
+}
+
+RayQuery::~RayQuery()
+{
+}
+
+RayQueryRef RayQuery::create()
+{
+	RayQueryRef result = RayQueryRef( new RayQuery() );
+	return result;
+}
+
+float RayQuery::build( const std::vector<Bounds>& itemBounds, std::vector<uint32_t> *order, std::vector<Node> *outNodes )
+{
+	outNodes->clear();
+	if( order->empty() ) {
+		return 0.0f;
+	}
+
+	outNodes->reserve( 2 * order->size() / kMaxLeafItems + 1 );
+	buildRecursive( itemBounds, order->data(), 0, static_cast<uint32_t>( order->size() ), outNodes );
+
+	float result = 0.0f;
+	for( const auto& node : *outNodes ) {
+		result += node.bounds.getArea();
+	}
+	return result;
+}
+
+uint32_t RayQuery::buildRecursive( const std::vector<Bounds>& itemBounds, uint32_t *order, uint32_t first, uint32_t count, std::vector<Node> *nodes )
+{
+	const uint32_t result = static_cast<uint32_t>( nodes->size() );
+	nodes->push_back( Node() );
+
+	Bounds bounds;
+	Bounds centers;
+	for( uint32_t i = first; i < ( first + count ); ++i ) {
+		bounds.include( itemBounds[order[i]] );
+		centers.include( itemBounds[order[i]].getCenter() );
+	}
+	(*nodes)[result].bounds = bounds;
+
+	if( count <= kMaxLeafItems ) {
+		(*nodes)[result].first = first;
+		(*nodes)[result].count = count;
+		return result;
+	}
+
+	// Median split along the widest spread of item centers
+	const ci::vec3 spread = centers.max - centers.min;
+	const int axis = ( spread.x > spread.y ) ? ( ( spread.x > spread.z ) ? 0 : 2 ) : ( ( spread.y > spread.z ) ? 1 : 2 );
+	const uint32_t half = count / 2;
+	std::nth_element( order + first, order + first + half, order + first + count,
+		[&itemBounds, axis]( uint32_t a, uint32_t b ) -> bool {
+			return itemBounds[a].getCenter()[axis] < itemBounds[b].getCenter()[axis];
+		}
+	);
+
+	buildRecursive( itemBounds, order, first, half, nodes );
+	const uint32_t right = buildRecursive( itemBounds, order, first + half, count - half, nodes );
+	(*nodes)[result].first = right;
+	(*nodes)[result].count = 0;
+	return result;
+}
+
+RayQuery::ColliderId RayQuery::allocate( Shape shape, void* userData )
+{
+	ColliderId result = kInvalidCollider;
+	if( ! mFreeColliders.empty() ) {
+		result = mFreeColliders.back();
+		mFreeColliders.pop_back();
+	}
+	else {
+		result = static_cast<ColliderId>( mColliders.size() );
+		mColliders.push_back( Collider() );
+	}
+
+	Collider& collider = mColliders[result];
+	collider = Collider();
+	collider.shape = shape;
+	collider.alive = true;
+	collider.userData = userData;
+
+	++mNumColliders;
+	mNeedsRebuild = true;
+	return result;
+}
+
+RayQuery::Collider& RayQuery::getCollider( ColliderId collider )
+{
+	if( ( collider >= mColliders.size() ) || ( ! mColliders[collider].alive ) ) {
+		throw ci::vr::Exception( "Invalid ray query collider: " + std::to_string( collider ) );
+	}
+	return mColliders[collider];
+}
+
+const RayQuery::Collider& RayQuery::getCollider( ColliderId collider ) const
+{
+	if( ( collider >= mColliders.size() ) || ( ! mColliders[collider].alive ) ) {
+		throw ci::vr::Exception( "Invalid ray query collider: " + std::to_string( collider ) );
+	}
+	return mColliders[collider];
+}
+
+void RayQuery::updateBounds( Collider& collider )
+{
+	collider.bounds = Bounds();
+	switch( collider.shape ) {
+		case SHAPE_BOX: {
+			collider.bounds.include( collider.min );
+			collider.bounds.include( collider.max );
+		}
+		break;
+
+		case SHAPE_SPHERE: {
+			const ci::vec3 radius = ci::vec3( collider.max.x );
+			collider.bounds.include( collider.min - radius );
+			collider.bounds.include( collider.min + radius );
+		}
+		break;
+
+		case SHAPE_MESH: {
+			if( collider.mesh->nodes.empty() ) {
+				break;
+			}
+
+			const Bounds& local = collider.mesh->nodes[0].bounds;
+			for( int i = 0; i < 8; ++i ) {
+				const ci::vec3 corner = ci::vec3( ( i & 1 ) ? local.max.x : local.min.x, ( i & 2 ) ? local.max.y : local.min.y, ( i & 4 ) ? local.max.z : local.min.z );
+				collider.bounds.include( ci::vec3( collider.transform * ci::vec4( corner, 1.0f ) ) );
+			}
+		}
+		break;
+	}
+}
+
+RayQuery::ColliderId RayQuery::addBox( const ci::AxisAlignedBox& box, void* userData )
+{
+	ColliderId result = allocate( SHAPE_BOX, userData );
+	Collider& collider = mColliders[result];
+	collider.min = box.getMin();
+	collider.max = box.getMax();
+	updateBounds( collider );
+	return result;
+}
+
+RayQuery::ColliderId RayQuery::addSphere( const ci::Sphere& sphere, void* userData )
+{
+	ColliderId result = allocate( SHAPE_SPHERE, userData );
+	Collider& collider = mColliders[result];
+	collider.min = sphere.getCenter();
+	collider.max = ci::vec3( sphere.getRadius(), 0, 0 );
+	updateBounds( collider );
+	return result;
+}
+
+RayQuery::ColliderId RayQuery::addMesh( const std::vector<ci::vec3>& positions, const std::vector<uint32_t>& indices, const ci::mat4& transform, void* userData )
+{
+	if( 0 != ( indices.size() % 3 ) ) {
+		throw ci::vr::Exception( "Ray query mesh index count must be a multiple of 3" );
+	}
+
+	for( const auto& index : indices ) {
+		if( index >= positions.size() ) {
+			throw ci::vr::Exception( "Ray query mesh index out of range: " + std::to_string( index ) );
+		}
+	}
+
+	auto mesh = std::make_shared<Mesh>();
+	mesh->positions = positions;
+	mesh->indices = indices;
+
+	const uint32_t numTriangles = static_cast<uint32_t>( indices.size() / 3 );
+	std::vector<Bounds> triangleBounds( numTriangles );
+	mesh->order.resize( numTriangles );
+	for( uint32_t i = 0; i < numTriangles; ++i ) {
+		triangleBounds[i].include( positions[indices[3 * i + 0]] );
+		triangleBounds[i].include( positions[indices[3 * i + 1]] );
+		triangleBounds[i].include( positions[indices[3 * i + 2]] );
+		mesh->order[i] = i;
+	}
+	build( triangleBounds, &mesh->order, &mesh->nodes );
+
+	ColliderId result = allocate( SHAPE_MESH, userData );
+	Collider& collider = mColliders[result];
+	collider.mesh = mesh;
+	collider.transform = transform;
+	collider.invTransform = glm::inverse( transform );
+	updateBounds( collider );
+	return result;
+}
+
+RayQuery::ColliderId RayQuery::addMesh( const ci::TriMesh& mesh, const ci::mat4& transform, void* userData )
+{
+	const ci::vec3* positions = mesh.getPositions<3>();
+	std::vector<ci::vec3> meshPositions( positions, positions + mesh.getNumVertices() );
+	ColliderId result = addMesh( meshPositions, mesh.getIndices(), transform, userData );
+	return result;
+}
+
+void RayQuery::remove( ColliderId collider )
+{
+	Collider& target = getCollider( collider );
+	target = Collider();
+	mFreeColliders.push_back( collider );
+	--mNumColliders;
+	mNeedsRebuild = true;
+}
+
+void RayQuery::clear()
+{
+	mColliders.clear();
+	mFreeColliders.clear();
+	mNumColliders = 0;
+	mOrder.clear();
+	mNodes.clear();
+	mBuiltArea = 0;
+	mNeedsRebuild = false;
+	mNeedsRefit = false;
+}
+
+void RayQuery::setBox( ColliderId collider, const ci::AxisAlignedBox& box )
+{
+	Collider& target = getCollider( collider );
+	if( SHAPE_BOX != target.shape ) {
+		throw ci::vr::Exception( "Ray query collider is not a box: " + std::to_string( collider ) );
+	}
+
+	target.min = box.getMin();
+	target.max = box.getMax();
+	updateBounds( target );
+	mNeedsRefit = true;
+}
+
+void RayQuery::setSphere( ColliderId collider, const ci::Sphere& sphere )
+{
+	Collider& target = getCollider( collider );
+	if( SHAPE_SPHERE != target.shape ) {
+		throw ci::vr::Exception( "Ray query collider is not a sphere: " + std::to_string( collider ) );
+	}
+
+	target.min = sphere.getCenter();
+	target.max = ci::vec3( sphere.getRadius(), 0, 0 );
+	updateBounds( target );
+	mNeedsRefit = true;
+}
+
+void RayQuery::setTransform( ColliderId collider, const ci::mat4& transform )
+{
+	Collider& target = getCollider( collider );
+	if( SHAPE_MESH != target.shape ) {
+		throw ci::vr::Exception( "Ray query collider is not a mesh: " + std::to_string( collider ) );
+	}
+
+	target.transform = transform;
+	target.invTransform = glm::inverse( transform );
+	updateBounds( target );
+	mNeedsRefit = true;
+}
+
+void RayQuery::setEnabled( ColliderId collider, bool enabled )
+{
+	getCollider( collider ).enabled = enabled;
+}
+
+bool RayQuery::isEnabled( ColliderId collider ) const
+{
+	return getCollider( collider ).enabled;
+}
+
+void* RayQuery::getUserData( ColliderId collider ) const
+{
+	return getCollider( collider ).userData;
+}
+
+RayQuery::Shape RayQuery::getShape( ColliderId collider ) const
+{
+	return getCollider( collider ).shape;
+}
+
+void RayQuery::rebuild()
+{
+	std::vector<Bounds> colliderBounds( mColliders.size() );
+	mOrder.clear();
+	mOrder.reserve( mNumColliders );
+	for( size_t i = 0; i < mColliders.size(); ++i ) {
+		if( mColliders[i].alive ) {
+			colliderBounds[i] = mColliders[i].bounds;
+			mOrder.push_back( static_cast<uint32_t>( i ) );
+		}
+	}
+
+	mBuiltArea = build( colliderBounds, &mOrder, &mNodes );
+}
+
+void RayQuery::refit()
+{
+	// Children always follow their parent, so a reverse walk sees both children first
+	float area = 0.0f;
+	for( size_t i = mNodes.size(); i > 0; --i ) {
+		Node& node = mNodes[i - 1];
+		node.bounds = Bounds();
+		if( node.count > 0 ) {
+			for( uint32_t j = node.first; j < ( node.first + node.count ); ++j ) {
+				node.bounds.include( mColliders[mOrder[j]].bounds );
+			}
+		}
+		else {
+			node.bounds.include( mNodes[i].bounds );
+			node.bounds.include( mNodes[node.first].bounds );
+		}
+		area += node.bounds.getArea();
+	}
+
+	if( area > ( kMaxRefitGrowth * mBuiltArea ) ) {
+		rebuild();
+	}
+}
+
+void RayQuery::update()
+{
+	if( mNeedsRebuild ) {
+		rebuild();
+	}
+	else if( mNeedsRefit ) {
+		refit();
+	}
+
+	mNeedsRebuild = false;
+	mNeedsRefit = false;
+}
+
+bool RayQuery::intersect( const Collider& collider, const RayData& ray, float maxDistance, float *outDistance, uint32_t *outTriangle ) const
+{
+	switch( collider.shape ) {
+		case SHAPE_BOX: {
+			return intersectBox( collider.min, collider.max, ray.origin, ray.invDirection, maxDistance, outDistance );
+		}
+
+		case SHAPE_SPHERE: {
+			return intersectSphere( collider.min, collider.max.x, ray.origin, ray.direction, maxDistance, outDistance );
+		}
+
+		case SHAPE_MESH: {
+			// Affine transforms keep the ray parameter, so mesh space distances need no conversion
+			const Mesh& mesh = *collider.mesh;
+			const RayData local = RayData( ci::vec3( collider.invTransform * ci::vec4( ray.origin, 1.0f ) ), ci::vec3( collider.invTransform * ci::vec4( ray.direction, 0.0f ) ) );
+			float nearest = maxDistance;
+			bool result = false;
+			traverse( mesh.nodes, local.origin, local.invDirection, &nearest,
+				[&]( uint32_t first, uint32_t count ) {
+					for( uint32_t i = first; i < ( first + count ); ++i ) {
+						const uint32_t triangle = mesh.order[i];
+						const uint32_t* tri = &mesh.indices[3 * triangle];
+						float t = 0.0f;
+						if( intersectTriangle( mesh.positions[tri[0]], mesh.positions[tri[1]], mesh.positions[tri[2]], local.origin, local.direction, nearest, &t ) ) {
+							nearest = t;
+							*outTriangle = triangle;
+							result = true;
+						}
+					}
+				}
+			);
+
+			if( result ) {
+				*outDistance = nearest;
+			}
+			return result;
+		}
+	}
+
+	return false;
+}
+
+RayQuery::Hit RayQuery::makeHit( ColliderId collider, const ci::Ray& ray, float distance, uint32_t triangle ) const
+{
+	Hit result;
+	if( kInvalidCollider != collider ) {
+		result.collider = collider;
+		result.distance = distance;
+		result.position = ray.calcPosition( distance );
+		result.triangle = triangle;
+		result.userData = mColliders[collider].userData;
+	}
+	return result;
+}
+
+RayQuery::Hit RayQuery::queryOne( const ci::Ray& ray, float maxDistance ) const
+{
+	const RayData data = RayData( ray.getOrigin(), ray.getDirection() );
+	float nearest = maxDistance;
+	ColliderId hitCollider = kInvalidCollider;
+	uint32_t hitTriangle = 0xFFFFFFFF;
+	traverse( mNodes, data.origin, data.invDirection, &nearest,
+		[&]( uint32_t first, uint32_t count ) {
+			for( uint32_t i = first; i < ( first + count ); ++i ) {
+				const ColliderId id = mOrder[i];
+				const Collider& collider = mColliders[id];
+				float t = 0.0f;
+				uint32_t triangle = 0xFFFFFFFF;
+				if( collider.enabled && intersect( collider, data, nearest, &t, &triangle ) ) {
+					nearest = t;
+					hitCollider = id;
+					hitTriangle = triangle;
+				}
+			}
+		}
+	);
+
+	Hit result = makeHit( hitCollider, ray, nearest, hitTriangle );
+	return result;
+}
+
+void RayQuery::queryRange( const ci::Ray *rays, size_t begin, size_t end, Hit *outHits, float maxDistance ) const
+{
+	for( size_t i = begin; i < end; ++i ) {
+		outHits[i] = queryOne( rays[i], maxDistance );
+	}
+}
+
+RayQuery::Hit RayQuery::queryNearest( const ci::Ray& ray, float maxDistance )
+{
+	update();
+	Hit result = queryOne( ray, maxDistance );
+	return result;
+}
+
+void RayQuery::queryNearest( const ci::Ray *rays, size_t count, Hit *outHits, float maxDistance )
+{
+	update();
+
+	size_t numThreads = 1;
+	if( count >= mParallelThreshold ) {
+		numThreads = std::thread::hardware_concurrency();
+		numThreads = ( 0 == numThreads ) ? 1 : numThreads;
+		numThreads = ( numThreads > ( count / kMinRaysPerThread ) ) ? ( count / kMinRaysPerThread ) : numThreads;
+		numThreads = ( 0 == numThreads ) ? 1 : numThreads;
+	}
+
+	if( numThreads <= 1 ) {
+		queryRange( rays, 0, count, outHits, maxDistance );
+		return;
+	}
+
+	// Rays write disjoint hits and the hierarchy is read-only until the next update()
+	const size_t raysPerThread = ( count + numThreads - 1 ) / numThreads;
+	std::vector<std::thread> threads;
+	for( size_t i = 1; i < numThreads; ++i ) {
+		const size_t begin = i * raysPerThread;
+		const size_t end = ( ( begin + raysPerThread ) < count ) ? ( begin + raysPerThread ) : count;
+		if( begin < end ) {
+			threads.push_back( std::thread( [this, rays, begin, end, outHits, maxDistance]() {
+				queryRange( rays, begin, end, outHits, maxDistance );
+			} ) );
+		}
+	}
+	queryRange( rays, 0, raysPerThread, outHits, maxDistance );
+	for( auto& thread : threads ) {
+		thread.join();
+	}
+}
+
+std::vector<RayQuery::InputHit> RayQuery::queryInputRays( const ci::vr::Context *context, float maxDistance )
+{
+	std::vector<InputHit> result;
+	queryInputRays( context, &result, maxDistance );
+	return result;
+}
+
+void RayQuery::queryInputRays( const ci::vr::Context *context, std::vector<InputHit> *outHits, float maxDistance )
+{
+	outHits->clear();
+	if( nullptr == context ) {
+		return;
+	}
+
+	if( nullptr != context->getHmd() ) {
+		InputHit inputHit;
+		inputHit.ray = context->getHmd()->getInputRay();
+		outHits->push_back( inputHit );
+	}
+
+	const ci::vr::Controller::Type kTypes[] = { ci::vr::Controller::TYPE_LEFT, ci::vr::Controller::TYPE_RIGHT, ci::vr::Controller::TYPE_REMOTE, ci::vr::Controller::TYPE_XBOX };
+	for( const auto& type : kTypes ) {
+		const ci::vr::Controller* controller = context->getController( type );
+		if( ( nullptr != controller ) && controller->hasInputRay() ) {
+			InputHit inputHit;
+			inputHit.controller = controller;
+			inputHit.ray = controller->getInputRay();
+			outHits->push_back( inputHit );
+		}
+	}
+
+	update();
+	for( auto& inputHit : *outHits ) {
+		inputHit.hit = queryOne( inputHit.ray, maxDistance );
+	}
+}
+
+RayQuery::Hit RayQuery::queryNearestLinear( const ci::Ray& ray, float maxDistance ) const
+{
+	const RayData data = RayData( ray.getOrigin(), ray.getDirection() );
+	float nearest = maxDistance;
+	ColliderId hitCollider = kInvalidCollider;
+	uint32_t hitTriangle = 0xFFFFFFFF;
+	for( size_t i = 0; i < mColliders.size(); ++i ) {
+		const Collider& collider = mColliders[i];
+		if( ( ! collider.alive ) || ( ! collider.enabled ) ) {
+			continue;
+		}
+
+		float t = 0.0f;
+		uint32_t triangle = 0xFFFFFFFF;
+		if( intersect( collider, data, nearest, &t, &triangle ) ) {
+			nearest = t;
+			hitCollider = static_cast<ColliderId>( i );
+			hitTriangle = triangle;
+		}
+	}
+
+	Hit result = makeHit( hitCollider, ray, nearest, hitTriangle );
+	return result;
+}
+
+}} // namespace cinder::vr
@@ -0,0 +1,246 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/Recording.h"
+#include "cinder/vr/Hmd.h"
+
+#include <cstring>
+
+namespace cinder { namespace vr {
+
+const char kRecordingMagic[8] = { 'C', 'I', 'V', 'R', 'R', 'E', 'C', '\0' };
+
+void toRecorded( const ci::mat4& m, float *out )
+{
+	for( int c = 0; c < 4; ++c ) {
+		out[3*c + 0] = m[c][0];
+		out[3*c + 1] = m[c][1];
+		out[3*c + 2] = m[c][2];
+	}
+}
+
+ci::mat4 fromRecorded( const float *m )
+{
+	return ci::mat4(
+		m[0], m[ 1], m[ 2], 0.0f,
+		m[3], m[ 4], m[ 5], 0.0f,
+		m[6], m[ 7], m[ 8], 0.0f,
+		m[9], m[10], m[11], 1.0f
+	);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Recorder
+// -------------------------------------------------------------------------------------------------
+Recorder::Recorder( const ci::fs::path& path, ci::vr::Api api )
+	: mPath( path )
+{
+#if defined( CINDER_MSW )
+	mFile = ::_wfopen( mPath.wstring().c_str(), L"wb" );
+#else
+	mFile = std::fopen( mPath.string().c_str(), "wb" );
+#endif
+	if( nullptr == mFile ) {
+		throw ci::vr::Exception( "Couldn't open recording file for writing: " + mPath.string() );
+	}
+
+	RecordingHeader header = {};
+	std::memcpy( header.magic, kRecordingMagic, sizeof( kRecordingMagic ) );
+	header.version = kRecordingVersion;
+	header.headerSize = sizeof( RecordingHeader );
+	header.frameSize = sizeof( RecordedFrame );
+	header.api = static_cast<uint32_t>( api );
+	header.maxControllers = kRecordingMaxControllers;
+	header.maxDevices = kRecordingMaxDevices;
+	std::fwrite( &header, sizeof( header ), 1, mFile );
+	std::fflush( mFile );
+}
+
+Recorder::~Recorder()
+{
+	close();
+}
+
+RecorderRef Recorder::create( const ci::fs::path& path, ci::vr::Api api )
+{
+	RecorderRef result = RecorderRef( new Recorder( path, api ) );
+	return result;
+}
+
+void Recorder::record( double time, const ci::vr::Hmd *hmd, const ci::vr::PoseStore& poseStore, const std::vector<ci::vr::ControllerRef>& controllers )
+{
+	if( nullptr == mFile ) {
+		return;
+	}
+
+	std::memset( &mFrame, 0, sizeof( mFrame ) );
+	mFrame.time = time;
+	mFrame.frameIndex = hmd ? hmd->getElapsedFrames() : mNumFrames;
+	toRecorded( hmd ? hmd->getDeviceToTrackingMatrix() : ci::mat4(), mFrame.hmdDeviceToTracking );
+	mFrame.displayTime = hmd ? hmd->getPredictedDisplayTime() : 0.0;
+
+	// Every tracked device, so a replay reproduces getPoseStore()
+	mFrame.validMask = poseStore.getValidMask();
+	mFrame.changedMask = poseStore.getChangedMask();
+	ci::vr::PoseStore::forEachDevice( mFrame.validMask, [this, &poseStore]( uint32_t deviceIndex ) {
+		RecordedDevicePose& rec = mFrame.devices[deviceIndex];
+		const ci::vec3& position = poseStore.getPosition( deviceIndex );
+		const ci::quat& rotation = poseStore.getRotation( deviceIndex );
+		const ci::vec3& linearVelocity = poseStore.getLinearVelocity( deviceIndex );
+		const ci::vec3& angularVelocity = poseStore.getAngularVelocity( deviceIndex );
+		for( int i = 0; i < 3; ++i ) {
+			rec.position[i] = position[i];
+			rec.linearVelocity[i] = linearVelocity[i];
+			rec.angularVelocity[i] = angularVelocity[i];
+		}
+		rec.rotation[0] = rotation.x;
+		rec.rotation[1] = rotation.y;
+		rec.rotation[2] = rotation.z;
+		rec.rotation[3] = rotation.w;
+		rec.sampleTime = poseStore.getSampleTime( deviceIndex ) - mFrame.displayTime;
+	} );
+
+	for( const auto& ctrl : controllers ) {
+		if( mFrame.numControllers >= kRecordingMaxControllers ) {
+			break;
+		}
+
+		RecordedController& rec = mFrame.controllers[mFrame.numControllers];
+		rec.type = static_cast<uint32_t>( ctrl->getType() );
+		rec.trackedDeviceIndex = ctrl->getTrackedDeviceIndex();
+		toRecorded( ctrl->getDeviceToTrackingMatrix(), rec.deviceToTracking );
+
+		rec.buttonsKnown = ctrl->getButtonsKnown();
+		rec.buttonsDown = ctrl->getButtonsDown();
+
+		const uint32_t triggerMask = ctrl->getTriggerMask() & ( ( 1u << kRecordingMaxTriggers ) - 1 );
+		for( uint32_t bits = triggerMask; 0 != bits; bits &= ( bits - 1 ) ) {
+			const uint32_t i = ci::vr::countTrailingZeros( bits );
+			const ci::vr::Controller::Trigger *trigger = ctrl->getTrigger( static_cast<ci::vr::Controller::TriggerId>( 1u << i ) );
+			rec.triggersKnown |= static_cast<uint16_t>( 1u << i );
+			rec.triggers[i] = trigger->getValue();
+		}
+
+		const uint32_t axisMask = ctrl->getAxisMask() & ( ( 1u << kRecordingMaxAxes ) - 1 );
+		for( uint32_t bits = axisMask; 0 != bits; bits &= ( bits - 1 ) ) {
+			const uint32_t i = ci::vr::countTrailingZeros( bits );
+			const ci::vr::Controller::Axis *axis = ctrl->getAxis( static_cast<ci::vr::Controller::AxisId>( 1u << i ) );
+			rec.axesKnown |= static_cast<uint16_t>( 1u << i );
+			rec.axes[i][0] = axis->getValue().x;
+			rec.axes[i][1] = axis->getValue().y;
+		}
+
+		++mFrame.numControllers;
+	}
+
+	std::fwrite( &mFrame, sizeof( mFrame ), 1, mFile );
+	++mNumFrames;
+
+	// Keep the file readable while recording without flushing every frame
+	const uint32_t kFlushInterval = 90;
+	if( 0 == ( mNumFrames % kFlushInterval ) ) {
+		std::fflush( mFile );
+	}
+}
+
+void Recorder::close()
+{
+	if( nullptr != mFile ) {
+		std::fclose( mFile );
+		mFile = nullptr;
+	}
+}
+
+// -------------------------------------------------------------------------------------------------
+// Recording
+// -------------------------------------------------------------------------------------------------
+Recording::Recording( const ci::fs::path& path )
+	: mPath( path )
+{
+	mFile = ci::vr::MappedFile::create( mPath );
+	if( mFile->getSize() < sizeof( RecordingHeader ) ) {
+		throw ci::vr::Exception( "Couldn't map recording file: " + mPath.string() );
+	}
+
+	mHeader = static_cast<const RecordingHeader*>( mFile->getData() );
+	bool valid = ( 0 == std::memcmp( mHeader->magic, kRecordingMagic, sizeof( kRecordingMagic ) ) ) &&
+				 ( kRecordingVersion == mHeader->version ) &&
+				 ( sizeof( RecordingHeader ) == mHeader->headerSize ) &&
+				 ( sizeof( RecordedFrame ) == mHeader->frameSize );
+	if( ! valid ) {
+		throw ci::vr::Exception( "Unsupported recording file: " + mPath.string() );
+	}
+
+	mFrames = reinterpret_cast<const RecordedFrame*>( static_cast<const uint8_t*>( mFile->getData() ) + mHeader->headerSize );
+	mNumFrames = static_cast<uint32_t>( ( mFile->getSize() - mHeader->headerSize ) / mHeader->frameSize );
+}
+
+Recording::~Recording()
+{
+}
+
+RecordingRef Recording::create( const ci::fs::path& path )
+{
+	RecordingRef result = RecordingRef( new Recording( path ) );
+	return result;
+}
+
+double Recording::getDuration() const
+{
+	double result = ( mNumFrames > 0 ) ? mFrames[mNumFrames - 1].time : 0.0;
+	return result;
+}
+
+uint32_t Recording::findFrame( double time, uint32_t hint ) const
+{
+	if( 0 == mNumFrames ) {
+		return 0;
+	}
+
+	uint32_t result = ( hint < mNumFrames ) ? hint : ( mNumFrames - 1 );
+	// Playback usually moves forward a frame or two per call
+	if( mFrames[result].time > time ) {
+		result = 0;
+	}
+	while( ( ( result + 1 ) < mNumFrames ) && ( mFrames[result + 1].time <= time ) ) {
+		++result;
+	}
+	return result;
+}
+
+}} // namespace cinder::vr
@@ -0,0 +1,308 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/StereoFrustum.h"
+
+#if defined( CINDER_VR_ENABLE_SSE2 )
+	#include <emmintrin.h>
+#endif
+
+#include <cmath>
+
+namespace cinder { namespace vr {
+
+namespace {
+
+const uint32_t kNumFrustums = 3;
+const uint32_t kNumCorners = 8;
+
+inline const float* sourceAt( const void *src, size_t srcStride, size_t index )
+{
+	return reinterpret_cast<const float*>( reinterpret_cast<const uint8_t*>( src ) + ( index * srcStride ) );
+}
+
+inline ci::vec4 normalizePlane( const ci::vec4& plane )
+{
+	float len = std::sqrt( plane.x * plane.x + plane.y * plane.y + plane.z * plane.z );
+	ci::vec4 result = ( len > 0.0f ) ? ( plane / len ) : plane;
+	return result;
+}
+
+// Gribb and Hartmann, GL clip space. Normalized so distances are in the matrix's source units.
+void extractPlanes( const ci::mat4& m, ci::vec4 *planes )
+{
+	ci::vec4 row0 = ci::vec4( m[0][0], m[1][0], m[2][0], m[3][0] );
+	ci::vec4 row1 = ci::vec4( m[0][1], m[1][1], m[2][1], m[3][1] );
+	ci::vec4 row2 = ci::vec4( m[0][2], m[1][2], m[2][2], m[3][2] );
+	ci::vec4 row3 = ci::vec4( m[0][3], m[1][3], m[2][3], m[3][3] );
+	planes[StereoFrustum::PLANE_LEFT]   = normalizePlane( row3 + row0 );
+	planes[StereoFrustum::PLANE_RIGHT]  = normalizePlane( row3 - row0 );
+	planes[StereoFrustum::PLANE_BOTTOM] = normalizePlane( row3 + row1 );
+	planes[StereoFrustum::PLANE_TOP]    = normalizePlane( row3 - row1 );
+	planes[StereoFrustum::PLANE_NEAR]   = normalizePlane( row3 + row2 );
+	planes[StereoFrustum::PLANE_FAR]    = normalizePlane( row3 - row2 );
+}
+
+void extractCorners( const ci::mat4& m, ci::vec3 *corners )
+{
+	ci::mat4 invM = ci::inverse( m );
+	for( uint32_t i = 0; i < kNumCorners; ++i ) {
+		ci::vec4 ndc = ci::vec4( ( i & 1 ) ? 1.0f : -1.0f, ( i & 2 ) ? 1.0f : -1.0f, ( i & 4 ) ? 1.0f : -1.0f, 1.0f );
+		ci::vec4 p = invM * ndc;
+		corners[i] = ci::vec3( p ) / p.w;
+	}
+}
+
+inline bool isSphereInside( const ci::vec4 *planes, const ci::vec3& center, float radius )
+{
+	for( uint32_t i = 0; i < StereoFrustum::PLANE_COUNT; ++i ) {
+		const ci::vec4& p = planes[i];
+		if( ( p.x * center.x + p.y * center.y + p.z * center.z + p.w ) < -radius ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+inline bool isBoxInside( const ci::vec4 *planes, const ci::vec3& center, const ci::vec3& extents )
+{
+	for( uint32_t i = 0; i < StereoFrustum::PLANE_COUNT; ++i ) {
+		const ci::vec4& p = planes[i];
+		float reach = std::fabs( p.x ) * extents.x + std::fabs( p.y ) * extents.y + std::fabs( p.z ) * extents.z;
+		if( ( p.x * center.x + p.y * center.y + p.z * center.z + p.w ) < -reach ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Combined frustum first, the eyes are only tested when it passes
+inline uint32_t toVisibility( bool combined, bool left, bool right )
+{
+	uint32_t result = StereoFrustum::VISIBLE_NONE;
+	if( combined ) {
+		result |= StereoFrustum::VISIBLE_COMBINED;
+		result |= left ? StereoFrustum::VISIBLE_LEFT : 0;
+		result |= right ? StereoFrustum::VISIBLE_RIGHT : 0;
+	}
+	return result;
+}
+
+#if defined( CINDER_VR_ENABLE_SSE2 )
+
+// Per plane broadcasts for all three frustums
+struct PlanesSse {
+	__m128	nx[kNumFrustums * StereoFrustum::PLANE_COUNT];
+	__m128	ny[kNumFrustums * StereoFrustum::PLANE_COUNT];
+	__m128	nz[kNumFrustums * StereoFrustum::PLANE_COUNT];
+	__m128	d[kNumFrustums * StereoFrustum::PLANE_COUNT];
+
+	PlanesSse( const ci::vec4 *planes, bool absNormals ) {
+		for( uint32_t i = 0; i < ( kNumFrustums * StereoFrustum::PLANE_COUNT ); ++i ) {
+			const ci::vec4& p = planes[i];
+			nx[i] = _mm_set1_ps( absNormals ? std::fabs( p.x ) : p.x );
+			ny[i] = _mm_set1_ps( absNormals ? std::fabs( p.y ) : p.y );
+			nz[i] = _mm_set1_ps( absNormals ? std::fabs( p.z ) : p.z );
+			d[i] = _mm_set1_ps( p.w );
+		}
+	}
+};
+
+// Lanes of ( x, y, z ) that are in front of every plane of \a frustum, at distance -reach or more
+inline int insideMask( const PlanesSse& planes, const PlanesSse *absPlanes, uint32_t frustum, __m128 x, __m128 y, __m128 z, __m128 reach, __m128 ex, __m128 ey, __m128 ez )
+{
+	__m128 inside = _mm_castsi128_ps( _mm_set1_epi32( -1 ) );
+	for( uint32_t i = 0; i < StereoFrustum::PLANE_COUNT; ++i ) {
+		uint32_t k = frustum * StereoFrustum::PLANE_COUNT + i;
+		__m128 dist = _mm_add_ps( _mm_add_ps( _mm_mul_ps( planes.nx[k], x ), _mm_mul_ps( planes.ny[k], y ) ), _mm_add_ps( _mm_mul_ps( planes.nz[k], z ), planes.d[k] ) );
+		__m128 r = reach;
+		if( nullptr != absPlanes ) {
+			r = _mm_add_ps( _mm_add_ps( _mm_mul_ps( absPlanes->nx[k], ex ), _mm_mul_ps( absPlanes->ny[k], ey ) ), _mm_mul_ps( absPlanes->nz[k], ez ) );
+		}
+		inside = _mm_and_ps( inside, _mm_cmpge_ps( _mm_add_ps( dist, r ), _mm_setzero_ps() ) );
+	}
+	return _mm_movemask_ps( inside );
+}
+
+inline void writeVisibility( int combined, int left, int right, uint8_t *out )
+{
+	for( int j = 0; j < 4; ++j ) {
+		out[j] = static_cast<uint8_t>( toVisibility( 0 != ( combined & ( 1 << j ) ), 0 != ( left & ( 1 << j ) ), 0 != ( right & ( 1 << j ) ) ) );
+	}
+}
+
+#endif // defined( CINDER_VR_ENABLE_SSE2 )
+
+} // anonymous namespace
+
+// -------------------------------------------------------------------------------------------------
+// StereoFrustum
+// -------------------------------------------------------------------------------------------------
+StereoFrustum::StereoFrustum( const ci::mat4& leftViewProjection, const ci::mat4& rightViewProjection )
+{
+	set( leftViewProjection, rightViewProjection );
+}
+
+void StereoFrustum::set( const ci::mat4& leftViewProjection, const ci::mat4& rightViewProjection )
+{
+	ci::vec4 *left = mPlanes + ( 1 + ci::vr::EYE_LEFT ) * PLANE_COUNT;
+	ci::vec4 *right = mPlanes + ( 1 + ci::vr::EYE_RIGHT ) * PLANE_COUNT;
+	extractPlanes( leftViewProjection, left );
+	extractPlanes( rightViewProjection, right );
+
+	ci::vec3 corners[2 * kNumCorners];
+	extractCorners( leftViewProjection, corners );
+	extractCorners( rightViewProjection, corners + kNumCorners );
+
+	// Outer side planes come from the outer eye, the others average both eyes. Each is pushed
+	// out until every corner of both frustums is inside, so the result contains both.
+	for( uint32_t i = 0; i < PLANE_COUNT; ++i ) {
+		ci::vec3 normal;
+		switch( i ) {
+			case PLANE_LEFT  : normal = ci::vec3( left[i] ); break;
+			case PLANE_RIGHT : normal = ci::vec3( right[i] ); break;
+			default          : normal = ci::normalize( ci::vec3( left[i] ) + ci::vec3( right[i] ) ); break;
+		}
+
+		float distance = -ci::dot( normal, corners[0] );
+		for( uint32_t j = 1; j < ( 2 * kNumCorners ); ++j ) {
+			float d = -ci::dot( normal, corners[j] );
+			distance = ( d > distance ) ? d : distance;
+		}
+		mPlanes[i] = ci::vec4( normal, distance );
+	}
+}
+
+uint32_t StereoFrustum::cullSphere( const ci::vec3& center, float radius ) const
+{
+	bool combined = isSphereInside( mPlanes, center, radius );
+	bool left = combined && isSphereInside( mPlanes + ( 1 + ci::vr::EYE_LEFT ) * PLANE_COUNT, center, radius );
+	bool right = combined && isSphereInside( mPlanes + ( 1 + ci::vr::EYE_RIGHT ) * PLANE_COUNT, center, radius );
+	uint32_t result = toVisibility( combined, left, right );
+	return result;
+}
+
+uint32_t StereoFrustum::cullBox( const ci::vec3& boxMin, const ci::vec3& boxMax ) const
+{
+	ci::vec3 center = 0.5f * ( boxMin + boxMax );
+	ci::vec3 extents = 0.5f * ( boxMax - boxMin );
+	bool combined = isBoxInside( mPlanes, center, extents );
+	bool left = combined && isBoxInside( mPlanes + ( 1 + ci::vr::EYE_LEFT ) * PLANE_COUNT, center, extents );
+	bool right = combined && isBoxInside( mPlanes + ( 1 + ci::vr::EYE_RIGHT ) * PLANE_COUNT, center, extents );
+	uint32_t result = toVisibility( combined, left, right );
+	return result;
+}
+
+void StereoFrustum::cullSpheres( const void *src, size_t srcStride, size_t count, uint8_t *outVisibility ) const
+{
+	size_t i = 0;
+
+#if defined( CINDER_VR_ENABLE_SSE2 )
+	const PlanesSse planes( mPlanes, false );
+	const __m128 zero = _mm_setzero_ps();
+	for( ; ( i + 4 ) <= count; i += 4 ) {
+		__m128 x = _mm_loadu_ps( sourceAt( src, srcStride, i + 0 ) );
+		__m128 y = _mm_loadu_ps( sourceAt( src, srcStride, i + 1 ) );
+		__m128 z = _mm_loadu_ps( sourceAt( src, srcStride, i + 2 ) );
+		__m128 r = _mm_loadu_ps( sourceAt( src, srcStride, i + 3 ) );
+		_MM_TRANSPOSE4_PS( x, y, z, r );
+
+		int combined = insideMask( planes, nullptr, 0, x, y, z, r, zero, zero, zero );
+		int left = 0;
+		int right = 0;
+		if( 0 != combined ) {
+			left = combined & insideMask( planes, nullptr, 1 + ci::vr::EYE_LEFT, x, y, z, r, zero, zero, zero );
+			right = combined & insideMask( planes, nullptr, 1 + ci::vr::EYE_RIGHT, x, y, z, r, zero, zero, zero );
+		}
+		writeVisibility( combined, left, right, outVisibility + i );
+	}
+#endif
+
+	for( ; i < count; ++i ) {
+		const float *s = sourceAt( src, srcStride, i );
+		outVisibility[i] = static_cast<uint8_t>( cullSphere( ci::vec3( s[0], s[1], s[2] ), s[3] ) );
+	}
+}
+
+void StereoFrustum::cullBoxes( const void *src, size_t srcStride, size_t count, uint8_t *outVisibility ) const
+{
+	size_t i = 0;
+
+#if defined( CINDER_VR_ENABLE_SSE2 )
+	const PlanesSse planes( mPlanes, false );
+	const PlanesSse absPlanes( mPlanes, true );
+	const __m128 half = _mm_set1_ps( 0.5f );
+	const __m128 zero = _mm_setzero_ps();
+	for( ; ( i + 4 ) <= count; i += 4 ) {
+		const float *s0 = sourceAt( src, srcStride, i + 0 );
+		const float *s1 = sourceAt( src, srcStride, i + 1 );
+		const float *s2 = sourceAt( src, srcStride, i + 2 );
+		const float *s3 = sourceAt( src, srcStride, i + 3 );
+
+		__m128 minX = _mm_set_ps( s3[0], s2[0], s1[0], s0[0] );
+		__m128 minY = _mm_set_ps( s3[1], s2[1], s1[1], s0[1] );
+		__m128 minZ = _mm_set_ps( s3[2], s2[2], s1[2], s0[2] );
+		__m128 maxX = _mm_set_ps( s3[3], s2[3], s1[3], s0[3] );
+		__m128 maxY = _mm_set_ps( s3[4], s2[4], s1[4], s0[4] );
+		__m128 maxZ = _mm_set_ps( s3[5], s2[5], s1[5], s0[5] );
+
+		__m128 x = _mm_mul_ps( _mm_add_ps( minX, maxX ), half );
+		__m128 y = _mm_mul_ps( _mm_add_ps( minY, maxY ), half );
+		__m128 z = _mm_mul_ps( _mm_add_ps( minZ, maxZ ), half );
+		__m128 ex = _mm_mul_ps( _mm_sub_ps( maxX, minX ), half );
+		__m128 ey = _mm_mul_ps( _mm_sub_ps( maxY, minY ), half );
+		__m128 ez = _mm_mul_ps( _mm_sub_ps( maxZ, minZ ), half );
+
+		int combined = insideMask( planes, &absPlanes, 0, x, y, z, zero, ex, ey, ez );
+		int left = 0;
+		int right = 0;
+		if( 0 != combined ) {
+			left = combined & insideMask( planes, &absPlanes, 1 + ci::vr::EYE_LEFT, x, y, z, zero, ex, ey, ez );
+			right = combined & insideMask( planes, &absPlanes, 1 + ci::vr::EYE_RIGHT, x, y, z, zero, ex, ey, ez );
+		}
+		writeVisibility( combined, left, right, outVisibility + i );
+	}
+#endif
+
+	for( ; i < count; ++i ) {
+		const float *s = sourceAt( src, srcStride, i );
+		outVisibility[i] = static_cast<uint8_t>( cullBox( ci::vec3( s[0], s[1], s[2] ), ci::vec3( s[3], s[4], s[5] ) ) );
+	}
+}
+
+}} // namespace cinder::vr
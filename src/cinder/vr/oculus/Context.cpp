@@ -48,8 +48,11 @@
 
 namespace cinder { namespace vr { namespace oculus {
 
+// About a third of a second of polling at 1000 Hz for all three controllers
+const size_t kPolledInputCapacity = 1024;
+
 Context::Context( const ci::vr::SessionOptions& sessionOptions, ci::vr::oculus::DeviceManager* deviceManager )
-	: ci::vr::Context( sessionOptions, deviceManager )
+	: ci::vr::Context( sessionOptions, deviceManager ), mPollTypes( 0 )
 {
 }
 
@@ -125,10 +128,23 @@ void Context::beginSession()
 	// Set frame rate for VR
 	ci::gl::enableVerticalSync( getSessionOptions().getVerticalSync() );
 	ci::app::setFrameRate( getSessionOptions().getFrameRate() );
+
+	// Poll input off the render thread
+	if( getSessionOptions().getInputPollRate() > 0.0 ) {
+		for( auto& time : mPolledStateTimes ) {
+			time = -1.0;
+		}
+		mPolledInputs.reset( new ci::vr::SpscRing<PolledInput>( kPolledInputCapacity ) );
+		startInputThread();
+	}
 }
 
 void Context::endSession()
 {
+	// Stop polling before the session goes away
+	stopInputThread();
+	mPolledInputs.reset();
+
 	// Destroy HMD
 	mHmd.reset();
 
@@ -138,8 +154,44 @@ void Context::endSession()
 	}
 }
 
+void Context::updatePoseData( const ::ovrTrackingState& trackingState )
+{
+	mPoseStore.beginUpdate();
+
+	const unsigned int kTrackedFlags = ::ovrStatus_OrientationTracked | ::ovrStatus_PositionTracked;
+
+	const ::ovrPoseStatef* poseStates[3] = { &trackingState.HeadPose, &trackingState.HandPoses[::ovrHand_Left], &trackingState.HandPoses[::ovrHand_Right] };
+	const unsigned int statusFlags[3] = { trackingState.StatusFlags, trackingState.HandStatusFlags[::ovrHand_Left], trackingState.HandStatusFlags[::ovrHand_Right] };
+	const uint32_t deviceIndices[3] = { ci::vr::oculus::kTrackedDeviceIndexHmd, ci::vr::oculus::kTrackedDeviceIndexLeftHand, ci::vr::oculus::kTrackedDeviceIndexRightHand };
+	for( int i = 0; i < 3; ++i ) {
+		if( 0 == ( statusFlags[i] & kTrackedFlags ) ) {
+			mPoseStore.invalidate( deviceIndices[i] );
+			continue;
+		}
+
+		const ::ovrPoseStatef& poseState = *poseStates[i];
+		ci::vec3 position = ci::vr::oculus::fromOvr( poseState.ThePose.Position );
+		ci::quat rotation = ci::vr::oculus::fromOvr( poseState.ThePose.Orientation );
+		ci::vec3 linearVelocity = ci::vr::oculus::fromOvr( poseState.LinearVelocity );
+		ci::vec3 angularVelocity = ci::vr::oculus::fromOvr( poseState.AngularVelocity );
+		mPoseStore.setPose( deviceIndices[i], position, rotation, linearVelocity, angularVelocity, poseState.TimeInSeconds );
+	}
+
+	mPoseStore.endUpdate();
+}
+
 void Context::processEvents()
 {
+	// Oculus has no device event queue, controller input is read in sampleInput
+}
+
+void Context::sampleInput()
+{
+	if( mInputThread ) {
+		drainPolledInput();
+		return;
+	}
+
 	for( auto& baseCtrl : mControllers ) {
 		auto ctrl = std::dynamic_pointer_cast<ci::vr::oculus::Controller>( baseCtrl );
 		::ovrControllerType ctrlType = ctrl->getInternalType();
@@ -152,6 +204,62 @@ void Context::processEvents()
 	}
 }
 
+void Context::drainPolledInput()
+{
+	// Controllers by internal type bit, these are the types the input thread polls next
+	ci::vr::oculus::Controller* controllers[8] = {};
+	uint32_t pollTypes = 0;
+	for( auto& baseCtrl : mControllers ) {
+		auto ctrl = static_cast<ci::vr::oculus::Controller*>( baseCtrl.get() );
+		uint32_t ctrlType = static_cast<uint32_t>( ctrl->getInternalType() );
+		controllers[ci::vr::countTrailingZeros( ctrlType )] = ctrl;
+		pollTypes |= ctrlType;
+	}
+	mPollTypes.store( pollTypes, std::memory_order_release );
+
+	// Drain everything polled since the last update, then process only the latest state of each
+	// controller so signals fire once per frame like they do without the thread
+	::ovrInputState latestStates[8];
+	uint32_t latestMask = 0;
+	PolledInput input;
+	while( mPolledInputs->pop( &input ) ) {
+		uint32_t bit = ci::vr::countTrailingZeros( static_cast<uint32_t>( input.type ) );
+		ci::vr::oculus::Controller* ctrl = controllers[bit];
+		// Disconnected after it was polled
+		if( nullptr == ctrl ) {
+			continue;
+		}
+		mInputSamples.push_back( ctrl->toInputSample( input.time, input.state ) );
+		latestStates[bit] = input.state;
+		latestMask |= ( 1u << bit );
+	}
+	for( uint32_t bits = latestMask; 0 != bits; bits &= ( bits - 1 ) ) {
+		uint32_t bit = ci::vr::countTrailingZeros( bits );
+		controllers[bit]->processInputState( latestStates[bit] );
+	}
+}
+
+void Context::pollInput( double time )
+{
+	const uint32_t pollTypes = mPollTypes.load( std::memory_order_acquire );
+	for( uint32_t bits = pollTypes; 0 != bits; bits &= ( bits - 1 ) ) {
+		const uint32_t bit = ci::vr::countTrailingZeros( bits );
+		PolledInput input;
+		input.time = time;
+		input.type = static_cast<::ovrControllerType>( 1u << bit );
+		input.state = ::ovrInputState();
+		if( ::ovrSuccess != ::ovr_GetInputState( mSession, input.type, &input.state ) ) {
+			continue;
+		}
+		// The runtime hasn't updated this controller since the last poll
+		if( input.state.TimeInSeconds == mPolledStateTimes[bit] ) {
+			continue;
+		}
+		mPolledStateTimes[bit] = input.state.TimeInSeconds;
+		mPolledInputs->push( input );
+	}
+}
+
 }}} // namespace cinder::vr::oculus
 
 #endif // defined( CINDER_VR_ENABLE_OCULUS )
\ No newline at end of file
@@ -58,119 +58,126 @@ Controller::~Controller()
 
 void Controller::processButtons( const ::ovrInputState& state )
 {
-	// Process down 
-	for( uint32_t i = 0; i < 32; ++i ) {
-		::ovrButton buttonMask = static_cast<::ovrButton>( 1u << i );
-		if( buttonMask == ( state.Buttons & buttonMask ) ) {
-			ci::vr::Controller::ButtonId buttonId = fromOvr( buttonMask );
-			auto button = getButton( buttonId );
-			if( button ) {
-				setButtonState( button, ci::vr::Controller::STATE_DOWN );
-			}
+	// Process down, visiting only the bits that are set
+	for( uint32_t bits = static_cast<uint32_t>( state.Buttons ); 0 != bits; bits &= ( bits - 1 ) ) {
+		::ovrButton buttonMask = static_cast<::ovrButton>( bits & ( ~bits + 1 ) );
+		auto button = getButton( fromOvr( buttonMask ) );
+		if( button ) {
+			setButtonState( button, ci::vr::Controller::STATE_DOWN );
 		}
 	}
 
 	// Process up
-	for( auto button : mButtons ) {
-		if( ci::vr::Controller::STATE_UNKNOWN == button->getState() ) {
-			continue;
-		}
-
+	for( uint32_t bits = getButtonsKnown(); 0 != bits; bits &= ( bits - 1 ) ) {
+		ci::vr::Controller::Button* button = &mButtons[ci::vr::countTrailingZeros( bits )];
 		::ovrButton buttonMask = toOvr( button->getId() );
 		if( buttonMask != ( state.Buttons & buttonMask ) ) {
-			setButtonState( button.get(), ci::vr::Controller::STATE_UP );
+			setButtonState( button, ci::vr::Controller::STATE_UP );
 		}
 	}
 }
 
 void Controller::processTriggers( const ::ovrInputState& state )
 {
+	for( uint32_t bits = mTriggerMask; 0 != bits; bits &= ( bits - 1 ) ) {
+		ci::vr::Controller::Trigger* trigger = &mTriggers[ci::vr::countTrailingZeros( bits )];
+		setTriggerValue( trigger, getRawTriggerValue( trigger->getId(), state ) );
+	}
+}
+
+void Controller::processAxes( const ::ovrInputState& state )
+{
+	for( uint32_t bits = mAxisMask; 0 != bits; bits &= ( bits - 1 ) ) {
+		ci::vr::Controller::Axis* axis = &mAxes[ci::vr::countTrailingZeros( bits )];
+		setAxisValue( axis, getRawAxisValue( axis->getId(), state ) );
+	}
+}
+
+float Controller::getRawTriggerValue( ci::vr::Controller::TriggerId id, const ::ovrInputState& state ) const
+{
+	float result = 0.0f;
 	switch( mInternalType ) {
 		case ::ovrControllerType_LTouch:
 		case ::ovrControllerType_RTouch: {
-			for( auto& trigger : mTriggers ) {
-				switch( trigger->getId() ) {
-					case ci::vr::Controller::TRIGGER_OCULUS_TOUCH_LEFT_INDEX: {
-						setTriggerValue( trigger.get(), state.IndexTrigger[::ovrHand_Left] );
-					}
-					break;
-
-					case ci::vr::Controller::TRIGGER_OCULUS_TOUCH_RIGHT_INDEX: {
-						setTriggerValue( trigger.get(), state.IndexTrigger[::ovrHand_Right] );
-					}
-					break;
-
-					case ci::vr::Controller::TRIGGER_OCULUS_TOUCH_LEFT_HAND: {
-						setTriggerValue( trigger.get(), state.HandTrigger[::ovrHand_Left] );
-					}
-					break;
-
-					case ci::vr::Controller::TRIGGER_OCULUS_TOUCH_RIGHT_HAND: {
-						setTriggerValue( trigger.get(), state.HandTrigger[::ovrHand_Right] );
-					}
-					break;
-				}
+			switch( id ) {
+				case ci::vr::Controller::TRIGGER_OCULUS_TOUCH_LEFT_INDEX	: result = state.IndexTrigger[::ovrHand_Left]; break;
+				case ci::vr::Controller::TRIGGER_OCULUS_TOUCH_RIGHT_INDEX	: result = state.IndexTrigger[::ovrHand_Right]; break;
+				case ci::vr::Controller::TRIGGER_OCULUS_TOUCH_LEFT_HAND		: result = state.HandTrigger[::ovrHand_Left]; break;
+				case ci::vr::Controller::TRIGGER_OCULUS_TOUCH_RIGHT_HAND	: result = state.HandTrigger[::ovrHand_Right]; break;
+				default: break;
 			}
 		}
 		break;
 
 		case ::ovrControllerType_XBox: {
-			for( auto& trigger : mTriggers ) {
-				switch( trigger->getId() ) {
-					case ci::vr::Controller::TRIGGER_OCULUS_XBOX_LEFT: {
-						setTriggerValue( trigger.get(), state.IndexTrigger[::ovrHand_Left] );
-					}
-					break;
-
-					case ci::vr::Controller::TRIGGER_OCULUS_XBOX_RIGHT: {
-						setTriggerValue( trigger.get(), state.IndexTrigger[::ovrHand_Right] );
-					}
-					break;
-				}
+			switch( id ) {
+				case ci::vr::Controller::TRIGGER_OCULUS_XBOX_LEFT	: result = state.IndexTrigger[::ovrHand_Left]; break;
+				case ci::vr::Controller::TRIGGER_OCULUS_XBOX_RIGHT	: result = state.IndexTrigger[::ovrHand_Right]; break;
+				default: break;
 			}
 		}
 		break;
+
+		default: break;
 	}
+	return result;
 }
 
-void Controller::processAxes( const ::ovrInputState& state )
+ci::vec2 Controller::getRawAxisValue( ci::vr::Controller::AxisId id, const ::ovrInputState& state ) const
 {
+	ci::vec2 result = ci::vec2( 0.0f );
 	switch( mInternalType ) {
 		case ::ovrControllerType_LTouch:
 		case ::ovrControllerType_RTouch: {
-			for( auto& axis : mAxes ) {
-				switch( axis->getId() ) {
-					case ci::vr::Controller::AXIS_OCULUS_TOUCH_LTHUMBSTICK: {
-						setAxisValue( axis.get(), ci::vr::oculus::fromOvr( state.Thumbstick[::ovrHand_Left] ) );
-					}
-					break;
-
-					case ci::vr::Controller::AXIS_OCULUS_TOUCH_RTHUMBSTICK: {
-						setAxisValue( axis.get(), ci::vr::oculus::fromOvr( state.Thumbstick[::ovrHand_Right] ) );
-					}
-					break;
-				}
+			switch( id ) {
+				case ci::vr::Controller::AXIS_OCULUS_TOUCH_LTHUMBSTICK	: result = ci::vr::oculus::fromOvr( state.Thumbstick[::ovrHand_Left] ); break;
+				case ci::vr::Controller::AXIS_OCULUS_TOUCH_RTHUMBSTICK	: result = ci::vr::oculus::fromOvr( state.Thumbstick[::ovrHand_Right] ); break;
+				default: break;
 			}
 		}
 		break;
 
 		case ::ovrControllerType_XBox: {
-			for( auto& axis : mAxes ) {
-				switch( axis->getId() ) {
-					case ci::vr::Controller::AXIS_OCULUS_XBOX_LTHUMBSTICK: {
-						setAxisValue( axis.get(), ci::vr::oculus::fromOvr( state.Thumbstick[::ovrHand_Left] ) );
-					}
-					break;
-
-					case ci::vr::Controller::AXIS_OCULUS_XBOX_RTHUMBSTICK: {
-						setAxisValue( axis.get(), ci::vr::oculus::fromOvr( state.Thumbstick[::ovrHand_Right] ) );
-					}
-					break;
-				}
+			switch( id ) {
+				case ci::vr::Controller::AXIS_OCULUS_XBOX_LTHUMBSTICK	: result = ci::vr::oculus::fromOvr( state.Thumbstick[::ovrHand_Left] ); break;
+				case ci::vr::Controller::AXIS_OCULUS_XBOX_RTHUMBSTICK	: result = ci::vr::oculus::fromOvr( state.Thumbstick[::ovrHand_Right] ); break;
+				default: break;
 			}
 		}
 		break;
+
+		default: break;
+	}
+	return result;
+}
+
+ci::vr::InputSample Controller::toInputSample( double time, const ::ovrInputState& state ) const
+{
+	ci::vr::InputSample result = ci::vr::InputSample();
+	result.time = time;
+	result.type = static_cast<uint32_t>( getType() );
+
+	for( uint32_t bits = static_cast<uint32_t>( state.Buttons ); 0 != bits; bits &= ( bits - 1 ) ) {
+		::ovrButton buttonMask = static_cast<::ovrButton>( bits & ( ~bits + 1 ) );
+		ci::vr::Controller::ButtonId id = fromOvr( buttonMask );
+		if( getButton( id ) ) {
+			result.buttonsDown |= static_cast<uint32_t>( id );
+		}
+	}
+
+	for( uint32_t bits = mTriggerMask; 0 != bits; bits &= ( bits - 1 ) ) {
+		const uint32_t i = ci::vr::countTrailingZeros( bits );
+		result.triggers[i] = mTriggers[i].normalize( getRawTriggerValue( mTriggers[i].getId(), state ) );
+	}
+
+	for( uint32_t bits = mAxisMask; 0 != bits; bits &= ( bits - 1 ) ) {
+		const uint32_t i = ci::vr::countTrailingZeros( bits );
+		ci::vec2 value = getRawAxisValue( mAxes[i].getId(), state );
+		result.axes[i][0] = value.x;
+		result.axes[i][1] = value.y;
 	}
+
+	return result;
 }
 
 // -------------------------------------------------------------------------------------------------
@@ -179,12 +186,12 @@ void Controller::processAxes( const ::ovrInputState& state )
 ControllerRemote::ControllerRemote( ci::vr::Context *context )
 	: ci::vr::oculus::Controller( ci::vr::Controller::TYPE_REMOTE, ::ovrControllerType_Remote, context )
 {
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_REMOTE_ENTER, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_REMOTE_BACK, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_REMOTE_DPAD_LEFT, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_REMOTE_DPAD_UP, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_REMOTE_DPAD_RIGHT, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_REMOTE_DPAD_DOWN, this ) );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_REMOTE_ENTER );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_REMOTE_BACK );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_REMOTE_DPAD_LEFT );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_REMOTE_DPAD_UP );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_REMOTE_DPAD_RIGHT );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_REMOTE_DPAD_DOWN );
 }
 
 ControllerRemote::~ControllerRemote()
@@ -270,27 +277,27 @@ void ControllerRemote::processInputState( const ::ovrInputState& state )
 ControllerXbox::ControllerXbox( ci::vr::Context *context )
 	: ci::vr::oculus::Controller( ci::vr::Controller::TYPE_XBOX, ::ovrControllerType_XBox, context )
 {
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_A, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_B, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_X, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_Y, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_LTHUMBSTICK, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_RTHUMBSTICK, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_LSHOULDER, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_RSHOULDER, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_ENTER, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_BACK, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_XBOX_HOME, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_DPAD_LEFT, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_DPAD_UP, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_DPAD_RIGHT, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_DPAD_DOWN, this ) );
-
-	mTriggers.push_back( ci::vr::Controller::Trigger::create( ci::vr::Controller::TRIGGER_OCULUS_XBOX_LEFT, this ) );
-	mTriggers.push_back( ci::vr::Controller::Trigger::create( ci::vr::Controller::TRIGGER_OCULUS_XBOX_RIGHT, this ) );
-
-	mAxes.push_back( ci::vr::Controller::Axis::create( ci::vr::Controller::AXIS_OCULUS_XBOX_LTHUMBSTICK, this ) );
-	mAxes.push_back( ci::vr::Controller::Axis::create( ci::vr::Controller::AXIS_OCULUS_XBOX_RTHUMBSTICK, this ) );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_A );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_B );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_X );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_Y );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_LTHUMBSTICK );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_RTHUMBSTICK );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_LSHOULDER );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_RSHOULDER );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_ENTER );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_BACK );
+	addButton( ci::vr::Controller::BUTTON_OCULUS_XBOX_HOME );
+	addButton( ci::vr::Controller::BUTTON_DPAD_LEFT );
+	addButton( ci::vr::Controller::BUTTON_DPAD_UP );
+	addButton( ci::vr::Controller::BUTTON_DPAD_RIGHT );
+	addButton( ci::vr::Controller::BUTTON_DPAD_DOWN );
+
+	addTrigger( ci::vr::Controller::TRIGGER_OCULUS_XBOX_LEFT );
+	addTrigger( ci::vr::Controller::TRIGGER_OCULUS_XBOX_RIGHT );
+
+	addAxis( ci::vr::Controller::AXIS_OCULUS_XBOX_LTHUMBSTICK );
+	addAxis( ci::vr::Controller::AXIS_OCULUS_XBOX_RTHUMBSTICK );
 }
 
 ControllerXbox::~ControllerXbox()
@@ -417,32 +424,34 @@ ControllerTouch::ControllerTouch( ci::vr::Controller::Type type, ci::vr::Context
 		throw ci::vr::oculus::Exception( "Invalid touch controller type" );
 	}
 
+	mTrackedDeviceIndex = ( ci::vr::Controller::TYPE_LEFT == type ) ? ci::vr::oculus::kTrackedDeviceIndexLeftHand : ci::vr::oculus::kTrackedDeviceIndexRightHand;
+
 	const float kTouchHandMinLimit = 0.2f;
 	const float kTouchHandMaxLimit = 0.94f;
 
 	switch( type ) {
 		case ci::vr::Controller::TYPE_LEFT: {
-			mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_TOUCH_X, this ) );
-			mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_TOUCH_Y, this ) );
-			mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_TOUCH_LTHUMBSTICK, this ) );
-			mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_TOUCH_ENTER, this ) );
+			addButton( ci::vr::Controller::BUTTON_OCULUS_TOUCH_X );
+			addButton( ci::vr::Controller::BUTTON_OCULUS_TOUCH_Y );
+			addButton( ci::vr::Controller::BUTTON_OCULUS_TOUCH_LTHUMBSTICK );
+			addButton( ci::vr::Controller::BUTTON_OCULUS_TOUCH_ENTER );
 
-			mTriggers.push_back( ci::vr::Controller::Trigger::create( ci::vr::Controller::TRIGGER_OCULUS_TOUCH_LEFT_INDEX, this ) );
-			mTriggers.push_back( ci::vr::Controller::Trigger::create( ci::vr::Controller::TRIGGER_OCULUS_TOUCH_LEFT_HAND, this, kTouchHandMinLimit, kTouchHandMaxLimit ) );
+			addTrigger( ci::vr::Controller::TRIGGER_OCULUS_TOUCH_LEFT_INDEX );
+			addTrigger( ci::vr::Controller::TRIGGER_OCULUS_TOUCH_LEFT_HAND, kTouchHandMinLimit, kTouchHandMaxLimit );
 
-			mAxes.push_back( ci::vr::Controller::Axis::create( ci::vr::Controller::AXIS_OCULUS_TOUCH_LTHUMBSTICK, this ) );
+			addAxis( ci::vr::Controller::AXIS_OCULUS_TOUCH_LTHUMBSTICK );
 		}
 		break;
 
 		case ci::vr::Controller::TYPE_RIGHT: {
-			mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_TOUCH_A, this ) );
-			mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_TOUCH_B, this ) );
-			mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_OCULUS_TOUCH_RTHUMBSTICK, this ) );
+			addButton( ci::vr::Controller::BUTTON_OCULUS_TOUCH_A );
+			addButton( ci::vr::Controller::BUTTON_OCULUS_TOUCH_B );
+			addButton( ci::vr::Controller::BUTTON_OCULUS_TOUCH_RTHUMBSTICK );
 
-			mTriggers.push_back( ci::vr::Controller::Trigger::create( ci::vr::Controller::TRIGGER_OCULUS_TOUCH_RIGHT_INDEX, this ) );
-			mTriggers.push_back( ci::vr::Controller::Trigger::create( ci::vr::Controller::TRIGGER_OCULUS_TOUCH_RIGHT_HAND, this, kTouchHandMinLimit, kTouchHandMaxLimit ) );
+			addTrigger( ci::vr::Controller::TRIGGER_OCULUS_TOUCH_RIGHT_INDEX );
+			addTrigger( ci::vr::Controller::TRIGGER_OCULUS_TOUCH_RIGHT_HAND, kTouchHandMinLimit, kTouchHandMaxLimit );
 
-			mAxes.push_back( ci::vr::Controller::Axis::create( ci::vr::Controller::AXIS_OCULUS_TOUCH_RTHUMBSTICK, this ) );
+			addAxis( ci::vr::Controller::AXIS_OCULUS_TOUCH_RTHUMBSTICK );
 		}
 		break;
 	}
@@ -39,15 +39,53 @@
 #include "cinder/vr/oculus/Hmd.h"
 #include "cinder/vr/oculus/Context.h"
 #include "cinder/vr/oculus/Oculus.h"
+#include "cinder/vr/PoseMath.h"
 //
 #include "cinder/app/App.h"
+#include "cinder/CinderMath.h"
 #include "cinder/Log.h"
 
 #if defined( CINDER_VR_ENABLE_OCULUS )
 
+#include <cmath>
+
 namespace cinder { namespace vr { namespace oculus {
 
 const float kFullFov = 110.0f; // Degrees
+const uint32_t kHiddenAreaSegments = 64;
+
+// LibOVR has no hidden area mesh. Masks what's outside the circle around the lens axis that
+// reaches the farthest edge of the eye's field of view, only the corners and conservatively.
+std::vector<ci::vec2> calcHiddenAreaTriangles( const ::ovrFovPort& fov )
+{
+	float radius = ( fov.LeftTan > fov.RightTan ) ? fov.LeftTan : fov.RightTan;
+	radius = ( fov.UpTan > radius ) ? fov.UpTan : radius;
+	radius = ( fov.DownTan > radius ) ? fov.DownTan : radius;
+	// Segments circumscribe the circle. Outer edge is past the corners, the viewport clips the rest.
+	float innerRadius = radius / std::cos( static_cast<float>( M_PI ) / static_cast<float>( kHiddenAreaSegments ) );
+	float outerRadius = 2.0f * radius;
+	ci::vec2 tanMin = ci::vec2( -fov.LeftTan, -fov.DownTan );
+	ci::vec2 tanSize = ci::vec2( fov.LeftTan + fov.RightTan, fov.DownTan + fov.UpTan );
+	auto toNdc = [&]( const ci::vec2& tan ) -> ci::vec2 {
+		return 2.0f * ( tan - tanMin ) / tanSize - ci::vec2( 1 );
+	};
+
+	std::vector<ci::vec2> result;
+	result.reserve( 6 * kHiddenAreaSegments );
+	for( uint32_t i = 0; i < kHiddenAreaSegments; ++i ) {
+		float a0 = 2.0f * static_cast<float>( M_PI ) * static_cast<float>( i ) / static_cast<float>( kHiddenAreaSegments );
+		float a1 = 2.0f * static_cast<float>( M_PI ) * static_cast<float>( i + 1 ) / static_cast<float>( kHiddenAreaSegments );
+		ci::vec2 d0 = ci::vec2( std::cos( a0 ), std::sin( a0 ) );
+		ci::vec2 d1 = ci::vec2( std::cos( a1 ), std::sin( a1 ) );
+		ci::vec2 inner0 = toNdc( innerRadius * d0 );
+		ci::vec2 inner1 = toNdc( innerRadius * d1 );
+		ci::vec2 outer0 = toNdc( outerRadius * d0 );
+		ci::vec2 outer1 = toNdc( outerRadius * d1 );
+		result.push_back( inner0 ); result.push_back( outer0 ); result.push_back( outer1 );
+		result.push_back( inner0 ); result.push_back( outer1 ); result.push_back( inner1 );
+	}
+	return result;
+}
 
 Hmd::Hmd( ci::vr::oculus::Context *context )
 	: ci::vr::Hmd( context ), mContext( context )
@@ -67,6 +105,8 @@ Hmd::Hmd( ci::vr::oculus::Context *context )
 		mEyeRenderDesc[i] = ::ovr_GetRenderDesc( mSession, (ovrEyeType)i, mHmdDesc.DefaultEyeFov[i] );
 	}
 
+	setupGpuTiming();
+	setupDynamicResolution();
 	initializeRenderTarget();
 	onMonoscopicChange();
 	app::getWindow()->getSignalResize().connect( [this](){
@@ -110,7 +150,8 @@ ci::vr::oculus::HmdRef Hmd::create( ci::vr::oculus::Context *context )
 
 void Hmd::initializeRenderTarget()
 {
-	mRenderTargetSize = ci::ivec2( mScreenPercentage * ci::vec2( fromOvr( mHmdDesc.Resolution ) ) );
+	// Allocated at the largest scale, dynamic resolution renders to a sub-rectangle
+	mRenderTargetSize = ci::ivec2( mScreenPercentage * getMaxResolutionScale() * ci::vec2( fromOvr( mHmdDesc.Resolution ) ) );
 
     ::ovrTextureSwapChainDesc desc = {};
     desc.Type			= ovrTexture_2D;
@@ -166,10 +207,19 @@ void Hmd::initializeRenderTarget()
 		ci::gl::FboRef renderTarget = ci::gl::Fbo::create( mRenderTargetSize.x, mRenderTargetSize.y, fboFmt );
 		mRenderTargets.push_back( renderTarget );
 	}
+
+	// Layers are resolved into the side by side swapchain texture, the runtime doesn't take arrays
+	if( isMultiviewStereo() ) {
+		setupMultiviewTarget( ci::ivec2( mRenderTargetSize.x / 2, mRenderTargetSize.y ), getSessionOptions().getSampleCount() );
+	}
+
+	setupHiddenAreaMask( ci::vr::EYE_LEFT, calcHiddenAreaTriangles( mEyeRenderDesc[ovrEye_Left].Fov ) );
+	setupHiddenAreaMask( ci::vr::EYE_RIGHT, calcHiddenAreaTriangles( mEyeRenderDesc[ovrEye_Right].Fov ) );
 }
 
 void Hmd::destroyRenderTarget()
 {
+	mMultiviewTarget.reset();
 	mRenderTargets.clear();
 
 	if( nullptr != mTextureSwapChain ) {
@@ -242,9 +292,19 @@ void Hmd::recenterTrackingOrigin()
 
 void Hmd::bind()
 {
+	mFrameTiming->beginFrame();
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_BIND );
+
+	// Picks this frame's resolution scale
+	beginGpuFrame();
+
 	// Update matrices based on pose data
 	{
-		::ovrTrackingState trackingState = ::ovr_GetTrackingState( mSession, 0.0, ovrFalse );
+		// Sample at the time this frame is expected to be displayed, ovr_GetEyePoses below
+		// marks the latency sample for the frame.
+		::ovrTrackingState trackingState = ::ovr_GetTrackingState( mSession, getPredictedDisplayTime(), ovrFalse );
+		mContext->updatePoseData( trackingState );
+
 		// Calculate device to tracking matrix
 		mDeviceToTrackingMatrix = ci::vr::oculus::fromOvr( trackingState.HeadPose.ThePose );
 		// Calculate tracking to device matrix
@@ -296,23 +356,43 @@ void Hmd::bind()
 		::ovr_GetTextureSwapChainCurrentIndex( mSession, mTextureSwapChain, &mCurrentSwapChainIndex );
 		// Find the corresponding render target and bind it
 		auto& renderTarget = mRenderTargets[static_cast<size_t>( mCurrentSwapChainIndex )];
-		renderTarget->bindFramebuffer();
-		// Clear it
-		ci::gl::ScopedViewport scopedViewPort( mRenderTargetSize );
-		ci::gl::clear( mClearColor );
+		if( mMultiviewTarget ) {
+			mMultiviewTarget->bind();
+			// Clears both layers
+			ci::gl::ScopedViewport scopedViewPort( mMultiviewTarget->getSize() );
+			ci::gl::clear( mClearColor );
+		}
+		else {
+			renderTarget->bindFramebuffer();
+			// Clear it
+			ci::gl::ScopedViewport scopedViewPort( mRenderTargetSize );
+			ci::gl::clear( mClearColor );
+		}
+
+		// Both eyes share the target and are cleared together, in every stereo mode
+		drawStereoHiddenAreaMasks();
 	}
 }
 
 void Hmd::unbind()
 {
+	mFrameTiming->endEye();
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_UNBIND );
+
 	if( mTextureSwapChain && ( ! mRenderTargets.empty() ) && mIsVisible && ( -1 != mCurrentSwapChainIndex ) ) {
 		// Unbind current render target
 		auto& renderTarget = mRenderTargets[static_cast<size_t>( mCurrentSwapChainIndex )];
+		if( mMultiviewTarget ) {
+			mMultiviewTarget->resolve( ci::vr::EYE_LEFT, renderTarget, getEyeViewport( ci::vr::EYE_LEFT ) );
+			mMultiviewTarget->resolve( ci::vr::EYE_RIGHT, renderTarget, getEyeViewport( ci::vr::EYE_RIGHT ) );
+		}
 		renderTarget->unbindFramebuffer();
 		// Commit swapchain
 		::ovr_CommitTextureSwapChain( mSession, mTextureSwapChain );
 	}
 
+	endGpuFrame();
+
 	/*
 	submitFrame();
 
@@ -324,6 +404,8 @@ void Hmd::unbind()
 
 void Hmd::submitFrame()
 {
+	mFrameTiming->beginPhase( ci::vr::FrameTiming::PHASE_SUBMIT_FRAME );
+
 	// Set up positional data.
 	ovrViewScaleDesc viewScaleDesc;
 	viewScaleDesc.HmdSpaceToWorldScaleInMeters = 1.0f;
@@ -331,8 +413,8 @@ void Hmd::submitFrame()
 	mBaseLayer.Header.Type = ovrLayerType_EyeFov;
 	mBaseLayer.Header.Flags = ovrLayerFlag_TextureOriginAtBottomLeft;
 	mBaseLayer.SensorSampleTime = mSensorSampleTime;
-	for( auto eye : getEyes() ) {
-		auto area = getEyeViewport( eye );
+	for( uint32_t eye = 0; eye < ci::vr::EYE_COUNT; ++eye ) {
+		auto area = getEyeViewport( static_cast<ci::vr::Eye>( eye ) );
 		viewScaleDesc.HmdToEyeOffset[eye]	= mEyeViewOffset[eye];
 		mBaseLayer.Fov[eye]					= mEyeRenderDesc[eye].Fov;
 		mBaseLayer.RenderPose[eye]			= mEyeRenderPose[eye];
@@ -342,7 +424,10 @@ void Hmd::submitFrame()
 	mBaseLayer.ColorTexture[1] = NULL;
 	
 	ovrLayerHeader* layers = &mBaseLayer.Header;
+	// Blocks until the compositor is ready for the next frame
+	mFrameTiming->beginPhase( ci::vr::FrameTiming::PHASE_COMPOSITOR_WAIT );
 	auto result = ::ovr_SubmitFrame( mSession, mFrameIndex, &viewScaleDesc, &layers, 1 );
+	mFrameTiming->endPhase( ci::vr::FrameTiming::PHASE_COMPOSITOR_WAIT );
 	mIsVisible = ( result == ovrSuccess );
 
 	++mFrameIndex;
@@ -351,6 +436,9 @@ void Hmd::submitFrame()
 	if( mIsVisible ) {
 		updateElapsedFrames();
 	}
+
+	mFrameTiming->endPhase( ci::vr::FrameTiming::PHASE_SUBMIT_FRAME );
+	mFrameTiming->endFrame();
 }
 
 float Hmd::getFullFov() const
@@ -358,20 +446,32 @@ float Hmd::getFullFov() const
 	return kFullFov;
 }
 
+double Hmd::getTimeInSeconds() const
+{
+	return ::ovr_GetTimeInSeconds();
+}
+
+double Hmd::getPredictedDisplayTime() const
+{
+	return ::ovr_GetPredictedDisplayTime( mSession, mFrameIndex );
+}
+
 ci::Area Hmd::getEyeViewport( ci::vr::Eye eye ) const
 {
-	auto size = mRenderTargetSize;
-	if( ci::vr::EYE_LEFT == eye ) {
-		return Area( 0, 0, size.x / 2, size.y );
-	}
-	else if( ci::vr::EYE_RIGHT == eye ) {
-		return Area( ( size.x + 1 ) / 2, 0, size.x, size.y );
+	if( ( ci::vr::EYE_LEFT == eye ) || ( ci::vr::EYE_RIGHT == eye ) ) {
+		return calcEyeViewport( eye, mRenderTargetSize, true );
 	}
 	return Area( 0, 0, 0, 0 );
 }
 
 void Hmd::enableEye( ci::vr::Eye eye, ci::vr::CoordSys eyeMatrixMode )
 {
+	if( enableStereoEye( eye, eyeMatrixMode ) ) {
+		return;
+	}
+
+	mFrameTiming->beginEye( eye );
+
 	ci::Area area = getEyeViewport( eye );
 	if( ci::vr::EYE_HMD == eye ) {
 		auto viewport = ci::gl::getViewport();
@@ -449,9 +549,10 @@ void Hmd::calculateOriginMatrix()
 void Hmd::calculateInputRay()
 {
 	// Ray components
-	ci::mat4 coordSysMatrix = mInverseLookMatrix * mInverseOriginMatrix * mDeviceToTrackingMatrix;
-	ci::vec3 p0 = ci::vec3( coordSysMatrix * ci::vec4( 0, 0, 0, 1 ) );
-	ci::vec3 dir = ci::vec3( coordSysMatrix * ci::vec4( 0, 0, -1, 0 ) );
+	ci::mat4 coordSysMatrix;
+	ci::vr::multiplyTransforms( mInverseLookMatrix * mInverseOriginMatrix, &mDeviceToTrackingMatrix, &coordSysMatrix, 1 );
+	ci::vec3 p0 = ci::vec3( coordSysMatrix[3] );
+	ci::vec3 dir = -ci::vec3( coordSysMatrix[2] );
 	// Input ray
 	mInputRay = ci::Ray( p0, dir );
 }
@@ -474,15 +575,18 @@ void Hmd::drawMirroredImpl( const ci::Rectf& r )
 
 			case Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_STEREO: {
 				auto tex = mRenderTargets[static_cast<size_t>( mCurrentSwapChainIndex )]->getColorTexture();
-				auto fittedRect = ci::Rectf( tex->getBounds() ).getCenteredFit( r, true );
-				ci::gl::draw( tex, fittedRect );
+				ci::Area area = getEyeViewport( ci::vr::EYE_LEFT );
+				area.include( getEyeViewport( ci::vr::EYE_RIGHT ) );
+				auto fittedRect = ci::Rectf( area ).getCenteredFit( r, true );
+				ci::gl::draw( tex, area, fittedRect );
 			}
 			break;
 
 			case Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_MONO_LEFT: {
 				auto tex = mRenderTargets[static_cast<size_t>( mCurrentSwapChainIndex )]->getColorTexture();
-				float width = static_cast<float>( tex->getWidth() ) / 2.0f;
-				float height = static_cast<float>( tex->getHeight() );
+				ci::Area area = getEyeViewport( ci::vr::EYE_LEFT );
+				float width = static_cast<float>( area.getWidth() );
+				float height = static_cast<float>( area.getHeight() );
 				auto texRect = ci::Rectf( 0, 0, width, height );
 				auto fittedRect = r.getCenteredFit( texRect, true );
 				ci::gl::draw( tex, Area( fittedRect ), r );
@@ -491,10 +595,11 @@ void Hmd::drawMirroredImpl( const ci::Rectf& r )
 
 			case Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_MONO_RIGHT: {
 				auto tex = mRenderTargets[static_cast<size_t>( mCurrentSwapChainIndex )]->getColorTexture();
-				float width = static_cast<float>( tex->getWidth() ) / 2.0f;
-				float height = static_cast<float>( tex->getHeight() );
+				ci::Area area = getEyeViewport( ci::vr::EYE_RIGHT );
+				float width = static_cast<float>( area.getWidth() );
+				float height = static_cast<float>( area.getHeight() );
 				auto texRect = ci::Rectf( 0, 0, width, height );
-				texRect += ci::vec2( width, 0.0f );
+				texRect += ci::vec2( area.getUL() );
 				auto fittedRect = r.getCenteredFit( texRect, true );
 				ci::gl::draw( tex, Area( fittedRect ), r );
 			}
@@ -505,6 +610,7 @@ void Hmd::drawMirroredImpl( const ci::Rectf& r )
 
 void Hmd::drawControllers( ci::vr::Eye eyeType )
 {
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_DRAW_CONTROLLERS );
 }
 
 void Hmd::drawDebugInfo()
@@ -41,6 +41,7 @@
 #include "cinder/vr/openvr/DeviceManager.h"
 #include "cinder/vr/openvr/Hmd.h"
 #include "cinder/vr/openvr/OpenVr.h"
+#include "cinder/vr/PoseMath.h"
 #include "cinder/app/App.h"
 #include "cinder/Log.h"
 
@@ -48,16 +49,31 @@
 
 namespace cinder { namespace vr { namespace openvr {
 
+// About a quarter of a second of polling at 1000 Hz for both hands
+const size_t kPolledInputCapacity = 512;
+
 Context::Context( const ci::vr::SessionOptions& sessionOptions, ci::vr::openvr::DeviceManager* deviceManager )
-	: ci::vr::Context( sessionOptions, deviceManager )
+	: ci::vr::Context( sessionOptions, deviceManager ), mPollDevices( 0 )
 { 
 	mDeviceManager = deviceManager;
 	mVrSystem = mDeviceManager->getVrSystem();
 	
-	// Allocate pose and and coord sys mat rices
+	// Allocate poses, matrices live in the pose store
+	static_assert( ::vr::k_unMaxTrackedDeviceCount <= ci::vr::kPoseStoreMaxDevices, "PoseStore can't hold all OpenVR devices" );
 	mPoses.resize( ::vr::k_unMaxTrackedDeviceCount );
-	mDeviceToTrackingMatrices.resize( ::vr::k_unMaxTrackedDeviceCount );
-	mTrackingToDeviceMatrices.resize( ::vr::k_unMaxTrackedDeviceCount );
+	mPoseMatrices.resize( ::vr::k_unMaxTrackedDeviceCount );
+
+	// Display timing for pose prediction
+	float displayFrequency = mVrSystem->GetFloatTrackedDeviceProperty( ::vr::k_unTrackedDeviceIndex_Hmd, ::vr::Prop_DisplayFrequency_Float );
+	if( displayFrequency > 0.0f ) {
+		mFrameDuration = 1.0 / static_cast<double>( displayFrequency );
+	}
+	mVsyncToPhotons = mVrSystem->GetFloatTrackedDeviceProperty( ::vr::k_unTrackedDeviceIndex_Hmd, ::vr::Prop_SecondsFromVsyncToPhotons_Float );
+
+	// Device topology, kept current by processTrackedDeviceEvents
+	mDeviceClasses.resize( ::vr::k_unMaxTrackedDeviceCount, ::vr::TrackedDeviceClass_Invalid );
+	mControllerTypes.resize( ::vr::k_unMaxTrackedDeviceCount, ci::vr::Controller::TYPE_UNKNOWN );
+	updateTrackedDevices();
 
 	// These start out with the events disabled
 	mViveControllers[ci::vr::Controller::TYPE_LEFT] = ci::vr::openvr::Controller::create( UINT32_MAX, ci::vr::Controller::TYPE_LEFT, this );
@@ -108,36 +124,127 @@ void Context::scanForControllers()
 
 void Context::updatePoseData()
 {
-	::vr::VRCompositor()->WaitGetPoses( mPoses.data(), ::vr::k_unMaxTrackedDeviceCount, nullptr, 0 );
+	// Blocks until the compositor is ready for the next frame
+	{
+		ci::vr::FrameTiming::ScopedPhase scopedPhase( mHmd ? mHmd->getFrameTiming() : nullptr, ci::vr::FrameTiming::PHASE_COMPOSITOR_WAIT );
+		::vr::VRCompositor()->WaitGetPoses( mPoses.data(), ::vr::k_unMaxTrackedDeviceCount, nullptr, 0 );
+	}
+
+	// WaitGetPoses predicts for the display time of the frame that's about to be rendered
+	double sampleTime = getPredictedDisplayTime();
+
+	// Convert every pose in one pass, HmdMatrix34_t is the first member of TrackedDevicePose_t
+	ci::vr::convertRowMajor3x4( &mPoses[0].mDeviceToAbsoluteTracking, sizeof( ::vr::TrackedDevicePose_t ), mPoseMatrices.data(), ::vr::k_unMaxTrackedDeviceCount );
 
+	mPoseStore.beginUpdate();
 	for( ::vr::TrackedDeviceIndex_t deviceIndex = ::vr::k_unTrackedDeviceIndex_Hmd; deviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++deviceIndex )	{
-		if( mPoses[deviceIndex].bPoseIsValid ) {
-			mDeviceToTrackingMatrices[deviceIndex] = ci::vr::openvr::fromOpenVr( mPoses[deviceIndex].mDeviceToAbsoluteTracking );
-			mTrackingToDeviceMatrices[deviceIndex] = glm::affineInverse( mDeviceToTrackingMatrices[deviceIndex] );
+		const auto& pose = mPoses[deviceIndex];
+		if( pose.bPoseIsValid ) {
+			mPoseStore.setPose( deviceIndex, mPoseMatrices[deviceIndex], ci::vr::openvr::fromOpenVr( pose.vVelocity ), ci::vr::openvr::fromOpenVr( pose.vAngularVelocity ), sampleTime );
+		}
+		else {
+			mPoseStore.invalidate( deviceIndex );
 		}
 	}
+	mPoseStore.endUpdate();
 
 	// Update controller input rays
-	for( ::vr::TrackedDeviceIndex_t deviceIndex = ::vr::k_unTrackedDeviceIndex_Hmd; deviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++deviceIndex ) {
-		if( ::vr::TrackedDeviceClass_Controller != mVrSystem->GetTrackedDeviceClass( deviceIndex ) ) {
-			continue;
+	uint64_t controllerMask = mPoseStore.getValidMask() & mControllerMask;
+	ci::vr::PoseStore::forEachDevice( controllerMask, [this]( uint32_t deviceIndex ) {
+		ci::vr::Controller::Type ctrlType = mControllerTypes[deviceIndex];
+		if( ( ci::vr::Controller::TYPE_UNKNOWN != ctrlType ) && mViveControllers[ctrlType]->isEventsEnabled() ) {
+			const ci::mat4& inverseLookMatrix = mHmd->getInverseLookMatrix();
+			const ci::mat4& inverseOriginMatrix = mHmd->getInverseOriginMatrix();
+			const ci::mat4& deviceToTracking = getDeviceToTrackingMatrix( deviceIndex );
+			const ci::mat4& trackingToDevice = getDeviceToTrackingMatrix( ::vr::k_unTrackedDeviceIndex_Hmd );
+			mViveControllers[ctrlType]->processControllerPose( inverseLookMatrix, inverseOriginMatrix, deviceToTracking, trackingToDevice );
 		}
+	} );
+}
+
+::vr::ETrackedDeviceClass Context::getTrackedDeviceClass( ::vr::TrackedDeviceIndex_t deviceIndex ) const
+{
+	::vr::ETrackedDeviceClass result = ( deviceIndex < ::vr::k_unMaxTrackedDeviceCount ) ? mDeviceClasses[deviceIndex] : ::vr::TrackedDeviceClass_Invalid;
+	return result;
+}
+
+ci::vr::Controller::Type Context::getControllerType( ::vr::TrackedDeviceIndex_t deviceIndex ) const
+{
+	ci::vr::Controller::Type result = ( deviceIndex < ::vr::k_unMaxTrackedDeviceCount ) ? mControllerTypes[deviceIndex] : ci::vr::Controller::TYPE_UNKNOWN;
+	return result;
+}
+
+void Context::updateTrackedDevice( ::vr::TrackedDeviceIndex_t deviceIndex )
+{
+	if( deviceIndex >= ::vr::k_unMaxTrackedDeviceCount ) {
+		return;
+	}
 
-		ci::vr::Controller::Type ctrlType = ci::vr::Controller::TYPE_UNKNOWN;
+	::vr::ETrackedDeviceClass deviceClass = ::vr::TrackedDeviceClass_Invalid;
+	if( mVrSystem->IsTrackedDeviceConnected( deviceIndex ) ) {
+		deviceClass = mVrSystem->GetTrackedDeviceClass( deviceIndex );
+	}
+
+	ci::vr::Controller::Type ctrlType = ci::vr::Controller::TYPE_UNKNOWN;
+	const uint64_t bit = 1ULL << deviceIndex;
+	if( ::vr::TrackedDeviceClass_Controller == deviceClass ) {
 		::vr::ETrackedControllerRole role = mVrSystem->GetControllerRoleForTrackedDeviceIndex( deviceIndex );
 		switch( role ) {
 			case ::vr::TrackedControllerRole_LeftHand  : ctrlType = ci::vr::Controller::TYPE_LEFT; break;
 			case ::vr::TrackedControllerRole_RightHand : ctrlType = ci::vr::Controller::TYPE_RIGHT; break;
+			default: break;
 		}
+		mControllerMask |= bit;
+	}
+	else {
+		mControllerMask &= ~bit;
+	}
 
-		if( ( ci::vr::Controller::TYPE_UNKNOWN != ctrlType ) && ( mPoses[deviceIndex].bPoseIsValid ) && mViveControllers[ctrlType]->isEventsEnabled() ) {
-			const ci::mat4& inverseLookMatrix = mHmd->getInverseLookMatrix();
-			const ci::mat4& inverseOriginMatrix = mHmd->getInverseOriginMatrix();
-			const ci::mat4& deviceToTracking = getDeviceToTrackingMatrix( deviceIndex );
-			const ci::mat4& trackingToDevice = getDeviceToTrackingMatrix( ::vr::k_unTrackedDeviceIndex_Hmd );
-			mViveControllers[ctrlType]->processControllerPose( inverseLookMatrix, inverseOriginMatrix, deviceToTracking, trackingToDevice );
-		}
+	mDeviceClasses[deviceIndex] = deviceClass;
+	mControllerTypes[deviceIndex] = ctrlType;
+}
+
+void Context::updateTrackedDevices()
+{
+	for( ::vr::TrackedDeviceIndex_t deviceIndex = ::vr::k_unTrackedDeviceIndex_Hmd; deviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++deviceIndex ) {
+		updateTrackedDevice( deviceIndex );
+	}
+}
+
+double Context::getPredictedDisplayTime() const
+{
+	float secondsSinceLastVsync = 0.0f;
+	mVrSystem->GetTimeSinceLastVsync( &secondsSinceLastVsync, nullptr );
+	double result = ci::app::getElapsedSeconds() - static_cast<double>( secondsSinceLastVsync ) + mFrameDuration + mVsyncToPhotons;
+	return result;
+}
+
+void Context::updateFrameStats( ci::vr::QualityGovernor::FrameStats* stats )
+{
+	ci::vr::Context::updateFrameStats( stats );
+	stats->budgetSeconds = mFrameDuration;
+
+	::vr::IVRCompositor* compositor = ::vr::VRCompositor();
+	if( ! compositor ) {
+		return;
+	}
+
+	// GPU time of the whole frame, the app's share plus distortion and overlays
+	::vr::Compositor_FrameTiming timing = {};
+	timing.m_nSize = sizeof( ::vr::Compositor_FrameTiming );
+	if( compositor->GetFrameTiming( &timing, 0 ) && ( timing.m_flTotalRenderGpuMs > 0.0f ) ) {
+		stats->gpuSeconds = static_cast<double>( timing.m_flTotalRenderGpuMs ) / 1000.0;
+	}
+
+	// Cumulative counts, report the change since the last call
+	::vr::Compositor_CumulativeStats cumulative = {};
+	compositor->GetCumulativeStats( &cumulative, sizeof( ::vr::Compositor_CumulativeStats ) );
+	if( ( cumulative.m_nNumDroppedFrames >= mPrevNumDroppedFrames ) && ( cumulative.m_nNumReprojectedFrames >= mPrevNumReprojectedFrames ) ) {
+		stats->numDroppedFrames = cumulative.m_nNumDroppedFrames - mPrevNumDroppedFrames;
+		stats->numReprojectedFrames = cumulative.m_nNumReprojectedFrames - mPrevNumReprojectedFrames;
 	}
+	mPrevNumDroppedFrames = cumulative.m_nNumDroppedFrames;
+	mPrevNumReprojectedFrames = cumulative.m_nNumReprojectedFrames;
 }
 
 void Context::beginSession()
@@ -151,31 +258,32 @@ void Context::beginSession()
 
 	// Get connected controllers
 	updateControllerConnections();
+
+	// Poll input off the render thread
+	if( getSessionOptions().getInputPollRate() > 0.0 ) {
+		mPolledPacketNums.assign( ::vr::k_unMaxTrackedDeviceCount, UINT32_MAX );
+		mPolledInputs.reset( new ci::vr::SpscRing<PolledInput>( kPolledInputCapacity ) );
+		startInputThread();
+	}
 }
 
 void Context::endSession()
 {
+	stopInputThread();
+	mPolledInputs.reset();
 }
 
 void Context::updateControllerConnections()
 {
-	for( ::vr::TrackedDeviceIndex_t deviceIndex = ::vr::k_unTrackedDeviceIndex_Hmd; deviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++deviceIndex ) {
-		if( ::vr::TrackedDeviceClass_Controller == mVrSystem->GetTrackedDeviceClass( deviceIndex ) ) {
-			ci::vr::Controller::Type ctrlType = ci::vr::Controller::TYPE_UNKNOWN;
-			::vr::ETrackedControllerRole role = mVrSystem->GetControllerRoleForTrackedDeviceIndex( deviceIndex );
-			switch( role ) {
-				case ::vr::TrackedControllerRole_LeftHand  : ctrlType = ci::vr::Controller::TYPE_LEFT; break;
-				case ::vr::TrackedControllerRole_RightHand : ctrlType = ci::vr::Controller::TYPE_RIGHT; break;
-				default: break;
-			}
-
-			if( ci::vr::Controller::TYPE_UNKNOWN != ctrlType ) {
-				mViveControllers[ctrlType]->setEventsEnabled();
-				addController( mViveControllers[ctrlType] );
-				getSignalControllerConnected().emit( mViveControllers[ctrlType].get() );
-			}
+	ci::vr::PoseStore::forEachDevice( mControllerMask, [this]( uint32_t deviceIndex ) {
+		ci::vr::Controller::Type ctrlType = mControllerTypes[deviceIndex];
+		if( ci::vr::Controller::TYPE_UNKNOWN != ctrlType ) {
+			mViveControllers[ctrlType]->mTrackedDeviceIndex = deviceIndex;
+			mViveControllers[ctrlType]->setEventsEnabled();
+			addController( mViveControllers[ctrlType] );
+			getSignalControllerConnected().emit( mViveControllers[ctrlType].get() );
 		}
-	}
+	} );
 }
 
 void Context::processTrackedDeviceEvents( const ::vr::VREvent_t &event )
@@ -183,6 +291,8 @@ void Context::processTrackedDeviceEvents( const ::vr::VREvent_t &event )
 	switch( event.eventType ) {
 		case ::vr::VREvent_TrackedDeviceActivated: {
 			CI_LOG_D( "EVENT: VREvent_TrackedDeviceActivated" );
+			updateTrackedDevice( event.trackedDeviceIndex );
+
 			// Activate the render models in the HMD in case they need to be drawn.
 			auto hmd = std::dynamic_pointer_cast<ci::vr::openvr::Hmd>( mHmd );
 			if( hmd ) {
@@ -224,21 +334,14 @@ void Context::processTrackedDeviceEvents( const ::vr::VREvent_t &event )
 		case ::vr::VREvent_TrackedDeviceDeactivated: {
 			CI_LOG_D( "EVENT: VREvent_TrackedDeviceDeactivated" );
 			// Disconnect, remove, and disable the controller specified by event.trackedDeviceIndex.
-			if( ::vr::TrackedDeviceClass_Controller == mVrSystem->GetTrackedDeviceClass( event.trackedDeviceIndex ) ) {
-				ci::vr::Controller::Type ctrlType = ci::vr::Controller::TYPE_UNKNOWN;
-				::vr::ETrackedControllerRole role = mVrSystem->GetControllerRoleForTrackedDeviceIndex( event.trackedDeviceIndex );
-				switch( role ) {
-					case ::vr::TrackedControllerRole_LeftHand  : ctrlType = ci::vr::Controller::TYPE_LEFT; break;
-					case ::vr::TrackedControllerRole_RightHand : ctrlType = ci::vr::Controller::TYPE_RIGHT; break;
-					default: break;
-				}
-
-				if( ci::vr::Controller::TYPE_UNKNOWN != ctrlType ) {
-					getSignalControllerDisconnected().emit( mViveControllers[ctrlType].get() );
-					removeController( mViveControllers[ctrlType] );
-					mViveControllers[ctrlType]->setEventsEnabled( false );
-					mViveControllers[ctrlType]->clearInputRay();
-				}
+			// Uses the cached role since the runtime may no longer report one for the device.
+			ci::vr::Controller::Type ctrlType = getControllerType( event.trackedDeviceIndex );
+			updateTrackedDevice( event.trackedDeviceIndex );
+			if( ci::vr::Controller::TYPE_UNKNOWN != ctrlType ) {
+				getSignalControllerDisconnected().emit( mViveControllers[ctrlType].get() );
+				removeController( mViveControllers[ctrlType] );
+				mViveControllers[ctrlType]->setEventsEnabled( false );
+				mViveControllers[ctrlType]->clearInputRay();
 			}
 		}
 		break;
@@ -264,6 +367,9 @@ void Context::processTrackedDeviceEvents( const ::vr::VREvent_t &event )
 
 		case ::vr::VREvent_TrackedDeviceRoleChanged: {
 			CI_LOG_D( "EVENT: VREvent_TrackedDeviceRoleChanged" );
+			// Roles can move between devices, refresh all of them
+			updateTrackedDevices();
+
 			// Disconnect, remove, and disable all both controllers
 			for( auto& ctrlIt : mViveControllers ) {
 				auto& ctrl = ctrlIt.second;
@@ -279,36 +385,91 @@ void Context::processTrackedDeviceEvents( const ::vr::VREvent_t &event )
 
 		default: break;
 	}
+}
 
-	// Process input
-	for( ::vr::TrackedDeviceIndex_t deviceIndex = ::vr::k_unTrackedDeviceIndex_Hmd; deviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++deviceIndex ) {
-		if( ::vr::TrackedDeviceClass_Controller != mVrSystem->GetTrackedDeviceClass( deviceIndex ) ) {
-			continue;
+void Context::processEvents()
+{
+	::vr::VREvent_t event = {};
+	while( mVrSystem->PollNextEvent( &event, sizeof( ::vr::VREvent_t ) ) ) {
+		processTrackedDeviceEvents( event );
+	}
+}
+
+void Context::sampleInput()
+{
+	if( mInputThread ) {
+		drainPolledInput();
+		return;
+	}
+
+	// One GetControllerState per enabled hand controller
+	ci::vr::PoseStore::forEachDevice( mControllerMask, [this]( uint32_t deviceIndex ) {
+		ci::vr::Controller::Type ctrlType = mControllerTypes[deviceIndex];
+		if( ( ci::vr::Controller::TYPE_UNKNOWN == ctrlType ) || ( ! mViveControllers[ctrlType]->isEventsEnabled() ) ) {
+			return;
 		}
 
-		ci::vr::Controller::Type ctrlType = ci::vr::Controller::TYPE_UNKNOWN;
-		::vr::ETrackedControllerRole role = mVrSystem->GetControllerRoleForTrackedDeviceIndex( deviceIndex );
-		switch( role ) {
-			case ::vr::TrackedControllerRole_LeftHand  : ctrlType = ci::vr::Controller::TYPE_LEFT; break;
-			case ::vr::TrackedControllerRole_RightHand : ctrlType = ci::vr::Controller::TYPE_RIGHT; break;
-			default: break;
+		::vr::VRControllerState_t state = {};
+		if( mVrSystem->GetControllerState( deviceIndex, &state ) ) {
+			mViveControllers[ctrlType]->processControllerState( state );
 		}
+	} );
+}
 
-		if( ci::vr::Controller::TYPE_UNKNOWN != ctrlType ) {
-			::vr::VRControllerState_t state = {};
-			if( mVrSystem->GetControllerState( deviceIndex, &state ) && mViveControllers[ctrlType]->isEventsEnabled() ) {
-				mViveControllers[ctrlType]->processControllerState( state );
-			}
+void Context::drainPolledInput()
+{
+	// Devices the input thread polls next
+	uint64_t pollDevices = 0;
+	ci::vr::PoseStore::forEachDevice( mControllerMask, [this, &pollDevices]( uint32_t deviceIndex ) {
+		ci::vr::Controller::Type ctrlType = mControllerTypes[deviceIndex];
+		if( ( ci::vr::Controller::TYPE_UNKNOWN != ctrlType ) && mViveControllers[ctrlType]->isEventsEnabled() ) {
+			pollDevices |= ( 1ULL << deviceIndex );
+		}
+	} );
+	mPollDevices.store( pollDevices, std::memory_order_release );
+
+	// Drain everything polled since the last update, then process only the latest state of each
+	// hand so signals fire once per frame like they do without the thread
+	ci::vr::openvr::Controller* latestCtrls[2] = {};
+	::vr::VRControllerState_t latestStates[2];
+	PolledInput input;
+	while( mPolledInputs->pop( &input ) ) {
+		// Skip devices that went away or changed roles after they were polled
+		if( 0 == ( pollDevices & ( 1ULL << input.deviceIndex ) ) ) {
+			continue;
+		}
+		ci::vr::Controller::Type ctrlType = mControllerTypes[input.deviceIndex];
+		ci::vr::openvr::Controller* ctrl = mViveControllers[ctrlType].get();
+		mInputSamples.push_back( ctrl->toInputSample( input.time, input.state ) );
+		uint32_t hand = ( ci::vr::Controller::TYPE_LEFT == ctrlType ) ? 0 : 1;
+		latestCtrls[hand] = ctrl;
+		latestStates[hand] = input.state;
+	}
+	for( uint32_t hand = 0; hand < 2; ++hand ) {
+		if( nullptr != latestCtrls[hand] ) {
+			latestCtrls[hand]->processControllerState( latestStates[hand] );
 		}
 	}
 }
 
-void Context::processEvents()
+void Context::pollInput( double time )
 {
-	::vr::VREvent_t event = {};
-	while( mVrSystem->PollNextEvent( &event, sizeof( ::vr::VREvent_t ) ) ) {
-		processTrackedDeviceEvents( event );
-	}
+	const uint64_t pollDevices = mPollDevices.load( std::memory_order_acquire );
+	ci::vr::PoseStore::forEachDevice( pollDevices, [this, time]( uint32_t deviceIndex ) {
+		PolledInput input;
+		input.time = time;
+		input.deviceIndex = deviceIndex;
+		input.state = ::vr::VRControllerState_t();
+		if( ! mVrSystem->GetControllerState( deviceIndex, &input.state ) ) {
+			return;
+		}
+		// The runtime hasn't updated this controller since the last poll
+		if( input.state.unPacketNum == mPolledPacketNums[deviceIndex] ) {
+			return;
+		}
+		mPolledPacketNums[deviceIndex] = input.state.unPacketNum;
+		mPolledInputs->push( input );
+	} );
 }
 
 }}} // namespace cinder::vr::vive
@@ -38,18 +38,21 @@
 
 #include "cinder/vr/openvr/Controller.h"
 #include "cinder/vr/openvr/OpenVr.h"
+#include "cinder/vr/PoseMath.h"
 
 #if defined( CINDER_VR_ENABLE_OPENVR )
 
 namespace cinder { namespace vr { namespace openvr {
 
 Controller::Controller( ::vr::TrackedDeviceIndex_t trackedDeviceIndex, ci::vr::Controller::Type type, ci::vr::Context *context )
-	: ci::vr::Controller( type, context ), mTrackedDeviceIndex( trackedDeviceIndex )
+	: ci::vr::Controller( type, context )
 {
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_VIVE_APPLICATION_MENU, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_VIVE_GRIP, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_VIVE_TOUCHPAD, this ) );
-	mButtons.push_back( ci::vr::Controller::Button::create( ci::vr::Controller::BUTTON_VIVE_TRIGGER, this ) );
+	mTrackedDeviceIndex = trackedDeviceIndex;
+
+	addButton( ci::vr::Controller::BUTTON_VIVE_APPLICATION_MENU );
+	addButton( ci::vr::Controller::BUTTON_VIVE_GRIP );
+	addButton( ci::vr::Controller::BUTTON_VIVE_TOUCHPAD );
+	addButton( ci::vr::Controller::BUTTON_VIVE_TRIGGER );
 
 	// Default to button states being up
 	{
@@ -70,14 +73,14 @@ Controller::Controller( ::vr::TrackedDeviceIndex_t trackedDeviceIndex, ci::vr::C
 
 	switch( type ) {
 		case ci::vr::Controller::TYPE_LEFT: {
-			mTriggers.push_back( ci::vr::Controller::Trigger::create( ci::vr::Controller::TRIGGER_VIVE_LEFT, this ) );
-			mAxes.push_back( ci::vr::Controller::Axis::create( ci::vr::Controller::AXIS_VIVE_LEFT, this ) );
+			addTrigger( ci::vr::Controller::TRIGGER_VIVE_LEFT );
+			addAxis( ci::vr::Controller::AXIS_VIVE_LEFT );
 		}
 		break;
 
 		case ci::vr::Controller::TYPE_RIGHT: {
-			mTriggers.push_back( ci::vr::Controller::Trigger::create( ci::vr::Controller::TRIGGER_VIVE_RIGHT, this ) );
-			mAxes.push_back( ci::vr::Controller::Axis::create( ci::vr::Controller::AXIS_VIVE_RIGHT, this ) );
+			addTrigger( ci::vr::Controller::TRIGGER_VIVE_RIGHT );
+			addAxis( ci::vr::Controller::AXIS_VIVE_RIGHT );
 		}
 		break;
 
@@ -236,9 +239,10 @@ void Controller::processTriggers( const ::vr::VRControllerState_t& state )
 	if( isTouched ) {
 		value = state.rAxis[ci::vr::openvr::Controller::AXIS_INDEX_TRIGGER].x;
 	}
-	if( isTouched != mTriggerTouched ) {
+	auto trigger = getTrigger();
+	if( trigger && ( isTouched != mTriggerTouched ) ) {
 		mTriggerTouched = isTouched;
-		setTriggerValue( mTriggers[0].get(), value );
+		setTriggerValue( trigger, value );
 	}
 }
 
@@ -251,21 +255,59 @@ void Controller::processAxes( const ::vr::VRControllerState_t& state )
 		value.x = state.rAxis[ci::vr::openvr::Controller::AXIS_INDEX_TOUCHPAD].x;
 		value.y = state.rAxis[ci::vr::openvr::Controller::AXIS_INDEX_TOUCHPAD].y;
 	}
-	if( isTouched != mTrackPadTouched ) {
+	auto axis = getAxis();
+	if( axis && ( isTouched != mTrackPadTouched ) ) {
 		mTrackPadTouched = isTouched;
-		setAxisValue( mAxes[0].get(), value );
+		setAxisValue( axis, value );
 	}
 }
 
+ci::vr::InputSample Controller::toInputSample( double time, const ::vr::VRControllerState_t& state ) const
+{
+	ci::vr::InputSample result = ci::vr::InputSample();
+	result.time = time;
+	result.type = static_cast<uint32_t>( getType() );
+
+	for( uint32_t bits = mButtonMask; 0 != bits; bits &= ( bits - 1 ) ) {
+		ci::vr::Controller::ButtonId id = static_cast<ci::vr::Controller::ButtonId>( bits & ( ~bits + 1 ) );
+		uint64_t buttonMask = ::vr::ButtonMaskFromId( toOpenVr( id ) );
+		if( buttonMask == ( state.ulButtonPressed & buttonMask ) ) {
+			result.buttonsDown |= static_cast<uint32_t>( id );
+		}
+	}
+
+	// Same touch gating as processTriggers() and processAxes()
+	auto trigger = getTrigger();
+	if( trigger ) {
+		const uint64_t buttonMask = ::vr::ButtonMaskFromId( ::vr::k_EButton_SteamVR_Trigger );
+		const bool isTouched = ( buttonMask == ( state.ulButtonTouched & buttonMask ) );
+		float value = isTouched ? state.rAxis[ci::vr::openvr::Controller::AXIS_INDEX_TRIGGER].x : 0.0f;
+		result.triggers[ci::vr::countTrailingZeros( trigger->getId() )] = trigger->normalize( value );
+	}
+
+	auto axis = getAxis();
+	if( axis ) {
+		const uint64_t buttonMask = ::vr::ButtonMaskFromId( ::vr::k_EButton_SteamVR_Touchpad );
+		const bool isTouched = ( buttonMask == ( state.ulButtonTouched & buttonMask ) );
+		const uint32_t i = ci::vr::countTrailingZeros( axis->getId() );
+		if( isTouched ) {
+			result.axes[i][0] = state.rAxis[ci::vr::openvr::Controller::AXIS_INDEX_TOUCHPAD].x;
+			result.axes[i][1] = state.rAxis[ci::vr::openvr::Controller::AXIS_INDEX_TOUCHPAD].y;
+		}
+	}
+
+	return result;
+}
+
 void Controller::processControllerPose( const ci::mat4& inverseLookMatrix, const ci::mat4& inverseOriginMatrix, const ci::mat4& deviceToTrackingMatrix, const ci::mat4& trackingToDeviceMatrix )
 {
 	// Ray components
 	mDeviceToTrackingMatrix = deviceToTrackingMatrix;
 	mTrackingToDeviceMatrix = trackingToDeviceMatrix;
-	ci::mat4 coordSysMatrix = inverseLookMatrix * inverseOriginMatrix * mDeviceToTrackingMatrix;
-	//ci::mat4 coordSysMatrix = inverseOriginMatrix * mDeviceToTrackingMatrix;
-	ci::vec3 p0 = ci::vec3( coordSysMatrix * ci::vec4( 0, 0, 0, 1 ) );
-	ci::vec3 dir = ci::vec3( coordSysMatrix * ci::vec4( 0, 0, -1, 0 ) );
+	ci::mat4 coordSysMatrix;
+	ci::vr::multiplyTransforms( inverseLookMatrix * inverseOriginMatrix, &mDeviceToTrackingMatrix, &coordSysMatrix, 1 );
+	ci::vec3 p0 = ci::vec3( coordSysMatrix[3] );
+	ci::vec3 dir = -ci::vec3( coordSysMatrix[2] );
 	// Input ray
 	mInputRay = ci::Ray( p0, dir );
 }
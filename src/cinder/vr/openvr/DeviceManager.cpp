@@ -41,6 +41,7 @@
 #include "cinder/vr/openvr/Context.h"
 #include "cinder/vr/openvr/OpenVr.h"
 #include "cinder/Log.h"
+#include "cinder/Utilities.h"
 
 #if defined( CINDER_VR_ENABLE_OPENVR )
 
@@ -76,12 +77,27 @@ void DeviceManager::initialize()
 
 	mDriverName = ci::vr::openvr::getTrackedDeviceString( mVrSystem, ::vr::k_unTrackedDeviceIndex_Hmd, ::vr::Prop_TrackingSystemName_String );
 	mDisplayName = ci::vr::openvr::getTrackedDeviceString( mVrSystem, ::vr::k_unTrackedDeviceIndex_Hmd, ::vr::Prop_SerialNumber_String );
+
+	// Entries are keyed by the driver version, a runtime update rebuilds them
+	ci::vr::openvr::RenderModelCacheRef renderModelCache;
+	try {
+		std::string runtimeVersion = ci::vr::openvr::getTrackedDeviceString( mVrSystem, ::vr::k_unTrackedDeviceIndex_Hmd, ::vr::Prop_DriverVersion_String ) + "/" + ::vr::IVRRenderModels_Version;
+		renderModelCache = ci::vr::openvr::RenderModelCache::create( ci::getTemporaryDirectory() / "cinder-vr" / "render-models", runtimeVersion );
+	}
+	catch( const ci::vr::openvr::Exception& e ) {
+		CI_LOG_W( "Render model cache disabled: " << e.what() );
+	}
+	mRenderModelLoader = ci::vr::openvr::RenderModelLoader::create( renderModelCache );
 }
 
 void DeviceManager::destroy()
 {
 	CI_LOG_I( "Destroying devices for HTC Vive" );
 
+	// Stops the loader thread before the runtime goes away
+	mRenderModelLoader.reset();
+	mDistortionMeshes.clear();
+
 	::vr::VR_Shutdown();
 	mVrSystem = nullptr;
 }
@@ -89,55 +105,24 @@ void DeviceManager::destroy()
 ci::vr::openvr::RenderModelDataRef DeviceManager::getRenderModelData( const std::string& renderModelName ) const
 {
 	ci::vr::openvr::RenderModelDataRef result;
-	
-	auto it = mRenderModelData.find( renderModelName );
-	if( mRenderModelData.end() != it ) {
+	if( mRenderModelLoader ) {
+		mRenderModelLoader->request( renderModelName );
+		result = mRenderModelLoader->getRenderModelData( renderModelName );
+	}
+	return result;
+}
+
+ci::vr::openvr::DistortionMeshRef DeviceManager::getDistortionMesh( uint32_t gridSize )
+{
+	ci::vr::openvr::DistortionMeshRef result;
+	auto it = mDistortionMeshes.find( gridSize );
+	if( mDistortionMeshes.end() != it ) {
 		result = it->second;
 	}
 	else {
-		::vr::RenderModel_t* renderModelModel = nullptr;
-		::vr::EVRRenderModelError error;
-		while( 1 ) {
-			error = ::vr::VRRenderModels()->LoadRenderModel_Async( renderModelName.c_str(), &renderModelModel );
-			if( ::vr::VRRenderModelError_Loading != error ) {
-				break;
-			}
-
-			threadSleep( 1 );
-		}
-
-		if( ::vr::VRRenderModelError_None != error ) {
-			return ci::vr::openvr::RenderModelDataRef();
-		}
-
-		::vr::RenderModel_TextureMap_t* renderModelTexture = nullptr;
-		while( 1 ) {
-			error = ::vr::VRRenderModels()->LoadTexture_Async( renderModelModel->diffuseTextureId, &renderModelTexture );
-			if( ::vr::VRRenderModelError_Loading != error ) {
-				break;
-			}
-
-			threadSleep( 1 );
-		}
-
-		if( ::vr::VRRenderModelError_None != error ) {
-			::vr::VRRenderModels()->FreeRenderModel( renderModelModel );
-			return ci::vr::openvr::RenderModelDataRef();
-		}
-
-		auto renderModelData = ci::vr::openvr::RenderModelData::create( renderModelName, renderModelModel, renderModelTexture );
-		if( renderModelData ) {
-			mRenderModelData[renderModelName] = renderModelData;
-			result = renderModelData;
-		}
-		else {
-			CI_LOG_W( "Couldn't find render model data for: " << renderModelName );
-		}
-
-		::vr::VRRenderModels()->FreeRenderModel( renderModelModel );
-		::vr::VRRenderModels()->FreeTexture( renderModelTexture );
+		result = ci::vr::openvr::DistortionMesh::create( mVrSystem, gridSize, ci::getTemporaryDirectory() / "cinder-vr" / "distortion" );
+		mDistortionMeshes[gridSize] = result;
 	}
-
 	return result;
 }
 
@@ -0,0 +1,276 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/openvr/DistortionMesh.h"
+#include "cinder/vr/MappedFile.h"
+#include "cinder/Log.h"
+
+#if defined( CINDER_VR_ENABLE_OPENVR )
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+namespace cinder { namespace vr { namespace openvr {
+
+const char kDistortionMeshMagic[8] = { 'C', 'I', 'V', 'R', 'D', 'S', 'T', '\0' };
+
+//! Cache file layout: header followed by 2 * gridSize * gridSize vertices, left eye first
+struct DistortionMeshHeader {
+	char		magic[8];
+	uint32_t	version;
+	uint32_t	headerSize;
+	uint64_t	key;
+	uint32_t	gridSize;
+	uint32_t	numVertices;
+	uint32_t	reserved[8];
+};
+
+// -------------------------------------------------------------------------------------------------
+// DistortionMesh
+// -------------------------------------------------------------------------------------------------
+DistortionMesh::DistortionMesh( ::vr::IVRSystem *vrSystem, uint32_t gridSize, const ci::fs::path& cacheDirectory )
+{
+	mGridSize = ( gridSize < kDistortionMeshMinGridSize ) ? kDistortionMeshMinGridSize : ( ( gridSize > kDistortionMeshMaxGridSize ) ? kDistortionMeshMaxGridSize : gridSize );
+
+	// The distortion only changes with the headset and its driver
+	ci::fs::path cachePath;
+	uint64_t key = 0;
+	if( ! cacheDirectory.empty() ) {
+		std::string serial = ci::vr::openvr::getTrackedDeviceString( vrSystem, ::vr::k_unTrackedDeviceIndex_Hmd, ::vr::Prop_SerialNumber_String );
+		std::string driverVersion = ci::vr::openvr::getTrackedDeviceString( vrSystem, ::vr::k_unTrackedDeviceIndex_Hmd, ::vr::Prop_DriverVersion_String );
+		std::string keyString = serial + "/" + driverVersion + "/" + std::to_string( mGridSize );
+		key = ci::vr::hashFnv1a( keyString.data(), keyString.size() );
+
+		std::stringstream ss;
+		ss << "distortion_" << std::hex << key << ".cvrd";
+		cachePath = cacheDirectory / ss.str();
+	}
+
+	mFromCache = ( ! cachePath.empty() ) && load( cachePath, key );
+	if( ! mFromCache ) {
+		computeVertices( vrSystem );
+		if( ! cachePath.empty() ) {
+			store( cachePath, key );
+		}
+	}
+
+	computeIndices();
+}
+
+DistortionMeshRef DistortionMesh::create( ::vr::IVRSystem *vrSystem, uint32_t gridSize, const ci::fs::path& cacheDirectory )
+{
+	DistortionMeshRef result = DistortionMeshRef( new DistortionMesh( vrSystem, gridSize, cacheDirectory ) );
+	return result;
+}
+
+void DistortionMesh::computeVertices( ::vr::IVRSystem *vrSystem )
+{
+	const uint32_t n = mGridSize;
+	mVertices.resize( 2 * n * n );
+
+	const float w = 1.0f / static_cast<float>( n - 1 );
+	const float h = 1.0f / static_cast<float>( n - 1 );
+
+	// Each row is independent, spread both eyes' rows over the workers
+	auto computeRows = [this, vrSystem, n, w, h]( uint32_t firstRow, uint32_t rowStep ) {
+		for( uint32_t row = firstRow; row < 2 * n; row += rowStep ) {
+			const uint32_t eye = row / n;
+			const uint32_t y = row % n;
+			const float xOffset = ( 0 == eye ) ? -1.0f : 0.0f;
+			const ::vr::EVREye vrEye = ( 0 == eye ) ? ::vr::Eye_Left : ::vr::Eye_Right;
+			for( uint32_t x = 0; x < n; ++x ) {
+				float u = x * w;
+				float v = 1.0f - ( y * h );
+				::vr::DistortionCoordinates_t dc = vrSystem->ComputeDistortion( vrEye, u, v );
+
+				Vertex& vert		= mVertices[row * n + x];
+				vert.position		= ci::vec2( xOffset + u, -1.0f + ( 2.0f * y * h ) );
+				vert.texCoordRed	= ci::vec2( dc.rfRed[0],   1.0f - dc.rfRed[1] );
+				vert.texCoordGreen	= ci::vec2( dc.rfGreen[0], 1.0f - dc.rfGreen[1] );
+				vert.texCoordBlue	= ci::vec2( dc.rfBlue[0],  1.0f - dc.rfBlue[1] );
+			}
+		}
+	};
+
+	uint32_t numThreads = std::thread::hardware_concurrency();
+	numThreads = ( 0 == numThreads ) ? 1 : ( ( numThreads > 2 * n ) ? 2 * n : numThreads );
+
+	std::vector<std::thread> threads;
+	for( uint32_t i = 1; i < numThreads; ++i ) {
+		threads.push_back( std::thread( computeRows, i, numThreads ) );
+	}
+	computeRows( 0, numThreads );
+	for( auto& thread : threads ) {
+		thread.join();
+	}
+}
+
+void DistortionMesh::computeIndices()
+{
+	const uint16_t n = static_cast<uint16_t>( mGridSize );
+	mIndices.clear();
+	mIndices.reserve( 2 * 6 * ( n - 1 ) * ( n - 1 ) );
+
+	for( uint16_t eye = 0; eye < 2; ++eye ) {
+		const uint16_t offset = eye * n * n;
+		for( uint16_t y = 0; y < ( n - 1 ); ++y ) {
+			for( uint16_t x = 0; x < ( n - 1 ); ++x ) {
+				uint16_t a = ( n * y ) + x + offset;
+				uint16_t b = ( n * y ) + x + 1 + offset;
+				uint16_t c = ( ( y + 1 ) * n ) + x + 1 + offset;
+				uint16_t d = ( ( y + 1 ) * n ) + x + offset;
+
+				mIndices.push_back( a );
+				mIndices.push_back( b );
+				mIndices.push_back( c );
+
+				mIndices.push_back( a );
+				mIndices.push_back( c );
+				mIndices.push_back( d );
+			}
+		}
+	}
+}
+
+bool DistortionMesh::load( const ci::fs::path& path, uint64_t key )
+{
+	if( ! ci::fs::exists( path ) ) {
+		return false;
+	}
+
+	ci::vr::MappedFileRef file;
+	try {
+		file = ci::vr::MappedFile::create( path );
+	}
+	catch( const ci::vr::Exception& e ) {
+		CI_LOG_W( e.what() );
+		return false;
+	}
+
+	const size_t numVertices = 2 * mGridSize * mGridSize;
+	if( file->getSize() != ( sizeof( DistortionMeshHeader ) + numVertices * sizeof( Vertex ) ) ) {
+		return false;
+	}
+
+	const DistortionMeshHeader *header = static_cast<const DistortionMeshHeader*>( file->getData() );
+	bool valid = ( 0 == std::memcmp( header->magic, kDistortionMeshMagic, sizeof( kDistortionMeshMagic ) ) ) &&
+				 ( kDistortionMeshVersion == header->version ) &&
+				 ( sizeof( DistortionMeshHeader ) == header->headerSize ) &&
+				 ( key == header->key ) &&
+				 ( mGridSize == header->gridSize ) &&
+				 ( numVertices == header->numVertices );
+	if( ! valid ) {
+		return false;
+	}
+
+	const Vertex *vertices = reinterpret_cast<const Vertex*>( static_cast<const uint8_t*>( file->getData() ) + header->headerSize );
+	mVertices.assign( vertices, vertices + numVertices );
+	return true;
+}
+
+void DistortionMesh::store( const ci::fs::path& path, uint64_t key ) const
+{
+	DistortionMeshHeader header = {};
+	std::memcpy( header.magic, kDistortionMeshMagic, sizeof( kDistortionMeshMagic ) );
+	header.version = kDistortionMeshVersion;
+	header.headerSize = sizeof( DistortionMeshHeader );
+	header.key = key;
+	header.gridSize = mGridSize;
+	header.numVertices = static_cast<uint32_t>( mVertices.size() );
+
+	try {
+		ci::fs::create_directories( path.parent_path() );
+	}
+	catch( const std::exception& e ) {
+		CI_LOG_W( "Couldn't create distortion cache directory: " << path.parent_path() << ", " << e.what() );
+		return;
+	}
+
+	// Write next to the entry and rename, readers never see a partial file
+	ci::fs::path tempPath = path;
+	tempPath += ".tmp";
+	std::FILE *file = std::fopen( tempPath.string().c_str(), "wb" );
+	if( nullptr == file ) {
+		CI_LOG_W( "Couldn't write distortion cache: " << path );
+		return;
+	}
+
+	bool written = ( 1 == std::fwrite( &header, sizeof( header ), 1, file ) ) &&
+				   ( mVertices.size() == std::fwrite( mVertices.data(), sizeof( Vertex ), mVertices.size(), file ) );
+	written = ( 0 == std::fclose( file ) ) && written;
+
+	try {
+		if( written ) {
+			ci::fs::rename( tempPath, path );
+		}
+		else {
+			ci::fs::remove( tempPath );
+		}
+	}
+	catch( const std::exception& e ) {
+		CI_LOG_W( "Couldn't write distortion cache: " << path << ", " << e.what() );
+	}
+}
+
+const ci::gl::VboMeshRef& DistortionMesh::getVboMesh()
+{
+	if( ! mVboMesh ) {
+		// Vertex data vbo
+		ci::geom::BufferLayout layout = ci::geom::BufferLayout();
+		layout.append( ci::geom::POSITION,    2, sizeof( Vertex ), static_cast<size_t>( offsetof( Vertex, position ) ),      0 );
+		layout.append( ci::geom::TEX_COORD_0, 2, sizeof( Vertex ), static_cast<size_t>( offsetof( Vertex, texCoordRed ) ),   0 );
+		layout.append( ci::geom::TEX_COORD_1, 2, sizeof( Vertex ), static_cast<size_t>( offsetof( Vertex, texCoordGreen ) ), 0 );
+		layout.append( ci::geom::TEX_COORD_2, 2, sizeof( Vertex ), static_cast<size_t>( offsetof( Vertex, texCoordBlue ) ),  0 );
+		ci::gl::VboRef vertexDataVbo = ci::gl::Vbo::create( GL_ARRAY_BUFFER, mVertices );
+		std::vector<std::pair<ci::geom::BufferLayout, ci::gl::VboRef>> vertexArrayBuffers = { std::make_pair( layout, vertexDataVbo ) };
+
+		// Indices vbo
+		ci::gl::VboRef indicesVbo = ci::gl::Vbo::create( GL_ELEMENT_ARRAY_BUFFER, mIndices );
+
+		// Vbo mesh
+		mVboMesh = ci::gl::VboMesh::create( static_cast<uint32_t>( mVertices.size() ), GL_TRIANGLES, vertexArrayBuffers, static_cast<uint32_t>( mIndices.size() ), GL_UNSIGNED_SHORT, indicesVbo );
+	}
+	return mVboMesh;
+}
+
+}}} // namespace cinder::vr::vive
+
+#endif // defined( CINDER_VR_ENABLE_OPENVR )
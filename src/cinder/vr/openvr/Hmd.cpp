@@ -40,6 +40,7 @@
 #include "cinder/vr/openvr/Context.h"
 #include "cinder/vr/openvr/DeviceManager.h"
 #include "cinder/vr/openvr/OpenVr.h"
+#include "cinder/vr/PoseMath.h"
 
 #if defined( CINDER_VR_ENABLE_OPENVR )
 
@@ -56,6 +57,10 @@ namespace cinder { namespace vr { namespace openvr {
 
 const float kFullFov = 110.0f; // Degrees
 
+// GL time spent uploading render models per frame, the rest of an upload continues next frame
+const double kRenderModelUploadBudget = 0.001; // Seconds
+const float kRenderModelPlaceholderSize = 0.05f; // Meters
+
 std::string toString( const ci::mat4& mat ) 
 {
 	const float *m = &(mat[0][0]);
@@ -93,6 +98,7 @@ const std::string kDistortionShaderVertex =
 const std::string kDistortionShadeFragment = 
 	"#version 410 core\n"
 	"uniform sampler2D uTex0;\n"
+	"uniform vec4 uTexCoordRect;\n"
 	"noperspective in vec2 v2UVred;\n"
 	"noperspective in vec2 v2UVgreen;\n"
 	"noperspective in vec2 v2UVblue;\n"
@@ -103,9 +109,9 @@ const std::string kDistortionShadeFragment =
 	"		outputColor = vec4( 0.0, 0.0, 0.0, 1.0 );\n"
 	"	}\n"
 	"	else {\n"
-	"		float r = texture( uTex0, v2UVred ).x;\n"
-	"		float g = texture( uTex0, v2UVgreen ).y;\n"
-	"		float b = texture( uTex0, v2UVblue ).z;\n"
+	"		float r = texture( uTex0, uTexCoordRect.xy + v2UVred   * uTexCoordRect.zw ).x;\n"
+	"		float g = texture( uTex0, uTexCoordRect.xy + v2UVgreen * uTexCoordRect.zw ).y;\n"
+	"		float b = texture( uTex0, uTexCoordRect.xy + v2UVblue  * uTexCoordRect.zw ).z;\n"
 	"		outputColor = vec4( r, g, b, 1.0 );"
 	"	}\n"
 	"}\n";
@@ -172,10 +178,16 @@ Hmd::Hmd( ci::vr::openvr::Context* context )
 
 	mVrSystem = context->getVrSystem();
 
+	mGpuSync = context->getSessionOptions().getGpuSync();
+	mGpuSyncTimeoutNs = static_cast<GLuint64>( context->getSessionOptions().getGpuSyncTimeout() * 1.0e9 );
+
 	mRenderModels.resize( ::vr::k_unMaxTrackedDeviceCount );	
+	mRenderModelNames.resize( ::vr::k_unMaxTrackedDeviceCount );
 
 	setupShaders();
 	setupMatrices();
+	setupGpuTiming();
+	setupDynamicResolution();
 	setupStereoRenderTargets();
 	setupDistortion();
 	setupRenderModels();
@@ -188,6 +200,10 @@ Hmd::Hmd( ci::vr::openvr::Context* context )
 
 Hmd::~Hmd()
 {
+	if( nullptr != mGpuFence ) {
+		glDeleteSync( mGpuFence );
+		mGpuFence = nullptr;
+	}
 }
 
 ci::vr::openvr::HmdRef Hmd::create( ci::vr::openvr::Context* context )
@@ -247,7 +263,12 @@ void Hmd::setupStereoRenderTargets()
 	uint32_t renderWidth = 0;
 	uint32_t renderHeight = 0;
 	mVrSystem->GetRecommendedRenderTargetSize( &renderWidth, &renderHeight );
-	mRenderTargetSize = ivec2( static_cast<int32_t>( renderWidth ), static_cast<int32_t>( renderHeight ) );
+	// Allocated at the largest scale, dynamic resolution renders to a sub-rectangle
+	mRenderTargetSize = ivec2( vec2( static_cast<float>( renderWidth ), static_cast<float>( renderHeight ) ) * getMaxResolutionScale() + vec2( 0.5f ) );
+	// Instanced stereo puts both eyes side by side in one target
+	if( isInstancedStereo() ) {
+		mRenderTargetSize.x *= 2;
+	}
 	CI_LOG_I( "mRenderTargetSize=" << mRenderTargetSize );
 
 	// Texture format
@@ -263,126 +284,135 @@ void Hmd::setupStereoRenderTargets()
 	fboFormat.setColorTextureFormat( texFormat );
 	fboFormat.enableDepthBuffer();
 	// Render targets
-	mRenderTargetLeft = ci::gl::Fbo::create( mRenderTargetSize.x, mRenderTargetSize.y, fboFormat );
-	mRenderTargetRight = ci::gl::Fbo::create( mRenderTargetSize.x, mRenderTargetSize.y, fboFormat );
-}
+	if( isInstancedStereo() ) {
+		mRenderTargetStereo = ci::gl::Fbo::create( mRenderTargetSize.x, mRenderTargetSize.y, fboFormat );
+	}
+	else {
+		// Multisampling happens in the texture arrays, the eye targets only get the resolved layers
+		if( isMultiviewStereo() ) {
+			setupMultiviewTarget( mRenderTargetSize, fboFormat.getSamples() );
+			fboFormat.setSamples( 0 );
+			fboFormat.disableDepth();
+		}
 
-void Hmd::setupDistortion()
-{
-	struct VertexDesc {
-		ci::vec2 position;
-		ci::vec2 texCoordRed;
-		ci::vec2 texCoordGreen;
-		ci::vec2 texCoordBlue;
-	};
+		mRenderTargetLeft = ci::gl::Fbo::create( mRenderTargetSize.x, mRenderTargetSize.y, fboFormat );
+		mRenderTargetRight = ci::gl::Fbo::create( mRenderTargetSize.x, mRenderTargetSize.y, fboFormat );
+	}
 
-	std::vector<VertexDesc> vertexData;
-	std::vector<uint16_t> indices;
-
-	int lensGridSegmentCountH = 43;
-	int lensGridSegmentCountV = 43;
-
-	float w = 1.0f/static_cast<float>( lensGridSegmentCountH - 1 );
-	float h = 1.0f/static_cast<float>( lensGridSegmentCountV - 1 );
-
-	// Left eye distortion vertex data
-	float xOffset = -1.0f;
-	for( int y = 0; y < lensGridSegmentCountV; y++ ) {
-		for( int x = 0; x < lensGridSegmentCountH; ++x ) {
-			float u = x * w; 
-			float v = 1.0f - ( y * h );
-			::vr::DistortionCoordinates_t dc = mVrSystem->ComputeDistortion( ::vr::Eye_Left, u, v );
-			
-			VertexDesc vert		= VertexDesc();
-			vert.position		= ci::vec2( xOffset + u, -1.0f + ( 2.0f * y * h ) );
-			vert.texCoordRed	= ci::vec2( dc.rfRed[0],   1.0f - dc.rfRed[1] );
-			vert.texCoordGreen	= ci::vec2( dc.rfGreen[0], 1.0f - dc.rfGreen[1] );
-			vert.texCoordBlue	= ci::vec2( dc.rfBlue[0],  1.0f - dc.rfBlue[1] );
-			vertexData.push_back( vert );
+	// Pixels hidden by the lenses, the mesh is in texture space with a top left origin
+	for( uint32_t i = 0; i < ci::vr::EYE_COUNT; ++i ) {
+		::vr::EVREye vrEye = ( ci::vr::EYE_LEFT == i ) ? ::vr::Eye_Left : ::vr::Eye_Right;
+		::vr::HiddenAreaMesh_t mesh = mVrSystem->GetHiddenAreaMesh( vrEye );
+		std::vector<ci::vec2> triangles;
+		if( ( nullptr != mesh.pVertexData ) && ( mesh.unTriangleCount > 0 ) ) {
+			triangles.resize( 3 * mesh.unTriangleCount );
+			for( size_t j = 0; j < triangles.size(); ++j ) {
+				const ::vr::HmdVector2_t& v = mesh.pVertexData[j];
+				triangles[j] = ci::vec2( 2.0f * v.v[0] - 1.0f, 1.0f - 2.0f * v.v[1] );
+			}
 		}
+		setupHiddenAreaMask( static_cast<ci::vr::Eye>( i ), triangles );
 	}
+}
 
-	// Right eye distortion vertex data
-	xOffset = 0;
-	for( int y = 0; y < lensGridSegmentCountV; y++ ) {
-		for( int x = 0; x < lensGridSegmentCountH; ++x ) {
-			float u = x * w; 
-			float v = 1 - ( y * h );
-			::vr::DistortionCoordinates_t dc = mVrSystem->ComputeDistortion( ::vr::Eye_Right, u, v );
-
-			VertexDesc vert		= VertexDesc();
-			vert.position		= ci::vec2( xOffset + u, -1.0f + ( 2.0f * y * h ) );
-			vert.texCoordRed	= ci::vec2( dc.rfRed[0],   1.0f - dc.rfRed[1] );
-			vert.texCoordGreen	= ci::vec2( dc.rfGreen[0], 1.0f - dc.rfGreen[1] );
-			vert.texCoordBlue	= ci::vec2( dc.rfBlue[0],  1.0f - dc.rfBlue[1] );
-			vertexData.push_back( vert );
-		}
+ci::gl::Texture2dRef Hmd::getEyeTexture( ci::vr::Eye eye, ci::Area *outArea ) const
+{
+	ci::gl::Texture2dRef result;
+	if( mRenderTargetStereo ) {
+		result = mRenderTargetStereo->getColorTexture();
+	}
+	else {
+		result = ( ci::vr::EYE_LEFT == eye ) ? mRenderTargetLeft->getColorTexture() : mRenderTargetRight->getColorTexture();
 	}
+	*outArea = getEyeViewport( eye );
+	return result;
+}
+
+void Hmd::setupDistortion()
+{
+	// The mesh only depends on the headset, contexts share it and it's cached on disk
+	uint32_t gridSize = getSessionOptions().getDistortionGridSize();
+	ci::vr::openvr::DistortionMeshRef distortionMesh = mContext->getDeviceManager()->getDistortionMesh( gridSize );
+	if( distortionMesh->isFromCache() ) {
+		CI_LOG_I( "Loaded cached distortion mesh, gridSize=" << distortionMesh->getGridSize() );
+	}
+
+	// Distortion index count
+	mDistortionIndexCount = 2 * distortionMesh->getEyeIndexCount();
 
-	// Left eye indices
-	uint16_t offset = 0;
-	for( uint16_t y = 0; y < ( lensGridSegmentCountV - 1 ); ++y )	{
-		for( uint16_t x = 0; x < ( lensGridSegmentCountH - 1 ); ++x )		{
-			uint16_t a = ( lensGridSegmentCountH * y ) + x + offset;
-			uint16_t b = ( lensGridSegmentCountH * y ) + x + 1 + offset;
-			uint16_t c = ( ( y+ 1 ) * lensGridSegmentCountH ) + x + 1 + offset;
-			uint16_t d = ( ( y +1 ) * lensGridSegmentCountH ) + x  + offset;
+	// Create batch
+	mDistortionBatch = ci::gl::Batch::create( distortionMesh->getVboMesh(), mDistortionShader );
+}
 
-			indices.push_back( a );
-			indices.push_back( b );
-			indices.push_back( c );
+void Hmd::syncGpu()
+{
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_GPU_SYNC );
 
-			indices.push_back( a );
-			indices.push_back( c );
-			indices.push_back( d );
+	switch( mGpuSync ) {
+		case ci::vr::GPU_SYNC_NONE: {
 		}
-	}
+		break;
 
-	// Right eye indices
-	offset = (lensGridSegmentCountH)*(lensGridSegmentCountV);
-	for( uint16_t y = 0; y < ( lensGridSegmentCountV - 1 ); ++y ) {
-		for( uint16_t x = 0; x < ( lensGridSegmentCountH - 1 ); ++x ) {
-			uint16_t a = ( lensGridSegmentCountH * y ) + x + offset;
-			uint16_t b = ( lensGridSegmentCountH * y ) + x + 1 + offset;
-			uint16_t c = ( ( y+ 1 ) * lensGridSegmentCountH ) + x + 1 + offset;
-			uint16_t d = ( ( y +1 ) * lensGridSegmentCountH ) + x  + offset;
+		case ci::vr::GPU_SYNC_FENCE_SUBMIT: {
+			mGpuFence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+			waitGpuFence();
+		}
+		break;
 
-			indices.push_back( a );
-			indices.push_back( b );
-			indices.push_back( c );
+		case ci::vr::GPU_SYNC_FENCE_NEXT_FRAME: {
+			// Waited on in bind(), a frame that was never bound leaves one behind
+			if( nullptr != mGpuFence ) {
+				glDeleteSync( mGpuFence );
+			}
+			mGpuFence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+			// Flush so the fence is guaranteed to signal even if nothing else is submitted
+			glFlush();
+		}
+		break;
 
-			indices.push_back( a );
-			indices.push_back( c );
-			indices.push_back( d );
+		case ci::vr::GPU_SYNC_FINISH: {
+			// Note from OpenVR sample:
+			//
+			// HACKHACK. From gpuview profiling, it looks like there is a bug where two renders and a present
+			// happen right before and after the vsync causing all kinds of jittering issues. This glFinish()
+			// appears to clear that up. Temporary fix while I try to get nvidia to investigate this problem.
+			// 1/29/2014 mikesart
+			//
+			glFinish();
 		}
+		break;
 	}
+}
 
-	// Distortion index count
-	mDistortionIndexCount = static_cast<uint32_t>( indices.size() );
-
-	// Vertex data vbo
-	ci::geom::BufferLayout layout = ci::geom::BufferLayout();
-	layout.append( ci::geom::POSITION,    2, sizeof( VertexDesc ), static_cast<size_t>( offsetof( VertexDesc, position ) ),      0 );
-	layout.append( ci::geom::TEX_COORD_0, 2, sizeof( VertexDesc ), static_cast<size_t>( offsetof( VertexDesc, texCoordRed ) ),   0 );
-	layout.append( ci::geom::TEX_COORD_1, 2, sizeof( VertexDesc ), static_cast<size_t>( offsetof( VertexDesc, texCoordGreen ) ), 0 );
-	layout.append( ci::geom::TEX_COORD_2, 2, sizeof( VertexDesc ), static_cast<size_t>( offsetof( VertexDesc, texCoordBlue ) ),  0 );	
-	ci::gl::VboRef vertexDataVbo = ci::gl::Vbo::create( GL_ARRAY_BUFFER, vertexData );
-	std::vector<std::pair<ci::geom::BufferLayout, ci::gl::VboRef>> vertexArrayBuffers = { std::make_pair( layout, vertexDataVbo ) };
-	
-	// Indices vbo
-	ci::gl::VboRef indicesVbo = ci::gl::Vbo::create( GL_ELEMENT_ARRAY_BUFFER, indices );
+void Hmd::waitGpuFence()
+{
+	if( nullptr == mGpuFence ) {
+		return;
+	}
 
-	// Vbo mesh
-	ci::gl::VboMeshRef vboMesh = ci::gl::VboMesh::create( static_cast<uint32_t>( vertexData.size() ), GL_TRIANGLES, vertexArrayBuffers, static_cast<uint32_t>( indices.size() ), GL_UNSIGNED_SHORT, indicesVbo );
+	double start = mFrameTiming->getTimeInSeconds();
 
-	// Create batch
-	mDistortionBatch = ci::gl::Batch::create( vboMesh, mDistortionShader );
+	GLenum status = glClientWaitSync( mGpuFence, GL_SYNC_FLUSH_COMMANDS_BIT, mGpuSyncTimeoutNs );
+	if( GL_TIMEOUT_EXPIRED == status ) {
+		CI_LOG_W( "GPU fence timed out, timeout=" << ( mGpuSyncTimeoutNs / 1000000.0 ) << "ms" );
+	}
+	else if( GL_WAIT_FAILED == status ) {
+		CI_LOG_E( "glClientWaitSync failed" );
+	}
+	glDeleteSync( mGpuFence );
+	mGpuFence = nullptr;
+
+	// In the submit phase this is already covered by PHASE_GPU_SYNC
+	if( ci::vr::GPU_SYNC_FENCE_NEXT_FRAME == mGpuSync ) {
+		mFrameTiming->addPhaseDuration( ci::vr::FrameTiming::PHASE_GPU_SYNC, mFrameTiming->getTimeInSeconds() - start );
+	}
 }
 
 void Hmd::setupRenderModels()
 {
 	// Allocate entries for all tracked devices
 	mRenderModels.resize( ::vr::k_unMaxTrackedDeviceCount );
+	mRenderModelNames.resize( ::vr::k_unMaxTrackedDeviceCount );
 
 	for( ::vr::TrackedDeviceIndex_t trackedDeviceIndex = ::vr::k_unTrackedDeviceIndex_Hmd + 1; trackedDeviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++trackedDeviceIndex ) {
 		activateRenderModel( trackedDeviceIndex );
@@ -452,20 +482,12 @@ void Hmd::updateControllerGeometry()
 	mControllerCount = 0;
 
 	std::vector<VertexDesc> vertexData;
-	for( ::vr::TrackedDeviceIndex_t deviceIndex = ::vr::k_unTrackedDeviceIndex_Hmd; deviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++deviceIndex ) {
-		if( ! mVrSystem->IsTrackedDeviceConnected( deviceIndex ) ) {		
-			continue;
-		}
-
-		if( mVrSystem->GetTrackedDeviceClass( deviceIndex ) != ::vr::TrackedDeviceClass_Controller ) {
-			continue;
-		}
-
+	ci::vr::PoseStore::forEachDevice( mContext->getControllerMask(), [&]( uint32_t deviceIndex ) {
 		mControllerCount += 1;
 
 		const auto& pose = mContext->getPose( deviceIndex );
 		if( ! pose.bPoseIsValid ) {
-			continue;
+			return;
 		}
 
 		const ci::mat4& mat = mContext->getDeviceToTrackingMatrix( deviceIndex );
@@ -483,7 +505,7 @@ void Hmd::updateControllerGeometry()
 		
 			mControllerVertexCount += 2;
 		}
-	}
+	} );
 
 	
 	if( ! vertexData.empty() ) {
@@ -507,6 +529,32 @@ void Hmd::updateControllerGeometry()
 	}
 }
 
+void Hmd::updateRenderModels()
+{
+	ci::vr::openvr::RenderModelLoader* loader = mContext->getDeviceManager()->getRenderModelLoader();
+	if( ! loader ) {
+		return;
+	}
+
+	loader->update( kRenderModelUploadBudget );
+
+	for( ::vr::TrackedDeviceIndex_t trackedDeviceIndex = ::vr::k_unTrackedDeviceIndex_Hmd + 1; trackedDeviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++trackedDeviceIndex ) {
+		const std::string& renderModelName = mRenderModelNames[trackedDeviceIndex];
+		if( mRenderModels[trackedDeviceIndex] || renderModelName.empty() ) {
+			continue;
+		}
+
+		RenderModelDataRef renderModelData = loader->getRenderModelData( renderModelName );
+		if( renderModelData ) {
+			mRenderModels[trackedDeviceIndex] = RenderModel::create( renderModelData, mRenderModelShader );
+		}
+		else if( ! loader->isLoading( renderModelName ) ) {
+			// Failed to load, stop drawing the placeholder
+			mRenderModelNames[trackedDeviceIndex].clear();
+		}
+	}
+}
+
 void Hmd::onClipValueChange( float nearClip, float farClip )
 {
 	mNearClip = nearClip;
@@ -531,13 +579,55 @@ void Hmd::recenterTrackingOrigin()
 
 void Hmd::bind()
 {
+	mFrameTiming->beginFrame();
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_BIND );
+
+	// Picks this frame's resolution scale
+	beginGpuFrame();
+
+	// Previous frame's fence, see GPU_SYNC_FENCE_NEXT_FRAME
+	waitGpuFence();
+
 	updateControllerGeometry();
+	updateRenderModels();
+
+	// Bound for the whole frame, enableEye() only picks the half
+	if( mRenderTargetStereo ) {
+		mRenderTargetStereo->bindFramebuffer();
+		ci::gl::ScopedViewport scopedViewPort( mRenderTargetSize );
+		ci::gl::clear( mClearColor );
+	}
+	// Clears both layers
+	else if( mMultiviewTarget ) {
+		mMultiviewTarget->bind();
+		ci::gl::ScopedViewport scopedViewPort( mMultiviewTarget->getSize() );
+		ci::gl::clear( mClearColor );
+	}
+
+	if( mRenderTargetStereo || mMultiviewTarget ) {
+		drawStereoHiddenAreaMasks();
+	}
 }
 
 void Hmd::unbind()
 {
-	mRenderTargetLeft->unbindFramebuffer();
-	mRenderTargetRight->unbindFramebuffer();
+	mFrameTiming->endEye();
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_UNBIND );
+
+	if( mRenderTargetStereo ) {
+		mRenderTargetStereo->unbindFramebuffer();
+	}
+	else if( mMultiviewTarget ) {
+		mMultiviewTarget->resolve( ci::vr::EYE_LEFT, mRenderTargetLeft, getEyeViewport( ci::vr::EYE_LEFT ) );
+		mMultiviewTarget->resolve( ci::vr::EYE_RIGHT, mRenderTargetRight, getEyeViewport( ci::vr::EYE_RIGHT ) );
+		ci::gl::context()->unbindFramebuffer();
+	}
+	else {
+		mRenderTargetLeft->unbindFramebuffer();
+		mRenderTargetRight->unbindFramebuffer();
+	}
+
+	endGpuFrame();
 
 /*
 	submitFrame();
@@ -552,31 +642,22 @@ void Hmd::unbind()
 
 void Hmd::submitFrame()
 {
-	// Left eye
-	{
-		GLuint resolvedTexId = mRenderTargetLeft->getColorTexture()->getId();
-		::vr::Texture_t eyeTex = { reinterpret_cast<void*>( resolvedTexId ), ::vr::API_OpenGL, ::vr::ColorSpace_Gamma };
-		::vr::VRCompositor()->Submit( ::vr::Eye_Left, &eyeTex );
-	}
-
-	// Right eye
-	{
-		GLuint resolvedTexId = mRenderTargetRight->getColorTexture()->getId();
+	mFrameTiming->beginPhase( ci::vr::FrameTiming::PHASE_SUBMIT_FRAME );
+
+	// Bounds cover the rendered sub-rectangle
+	const ::vr::EVREye kVrEyes[ci::vr::EYE_COUNT] = { ::vr::Eye_Left, ::vr::Eye_Right };
+	for( uint32_t i = 0; i < ci::vr::EYE_COUNT; ++i ) {
+		ci::Area area;
+		auto resolvedTex = getEyeTexture( static_cast<ci::vr::Eye>( i ), &area );
+		float width = static_cast<float>( resolvedTex->getWidth() );
+		float height = static_cast<float>( resolvedTex->getHeight() );
+		GLuint resolvedTexId = resolvedTex->getId();
 		::vr::Texture_t eyeTex = { reinterpret_cast<void*>( resolvedTexId ), ::vr::API_OpenGL, ::vr::ColorSpace_Gamma };
-		::vr::VRCompositor()->Submit( ::vr::Eye_Right, &eyeTex );
-	}
-
-	{
-		// Note from OpenVR sample:
-		//
-		// HACKHACK. From gpuview profiling, it looks like there is a bug where two renders and a present
-		// happen right before and after the vsync causing all kinds of jittering issues. This glFinish()
-		// appears to clear that up. Temporary fix while I try to get nvidia to investigate this problem.
-		// 1/29/2014 mikesart
-		//
-		glFinish();
+		::vr::VRTextureBounds_t bounds = { area.x1 / width, area.y1 / height, area.x2 / width, area.y2 / height };
+		::vr::VRCompositor()->Submit( kVrEyes[i], &eyeTex, &bounds );
 	}
 
+	syncGpu();
 
 	// Update pose data
 	{
@@ -587,6 +668,9 @@ void Hmd::submitFrame()
 			updateElapsedFrames();
 		}
 	}
+
+	mFrameTiming->endPhase( ci::vr::FrameTiming::PHASE_SUBMIT_FRAME );
+	mFrameTiming->endFrame();
 }
 
 float Hmd::getFullFov() const
@@ -594,29 +678,47 @@ float Hmd::getFullFov() const
 	return kFullFov;
 }
 
+double Hmd::getPredictedDisplayTime() const
+{
+	return mContext->getPredictedDisplayTime();
+}
+
 ci::Area Hmd::getEyeViewport( ci::vr::Eye eye ) const
 {
-	auto size = mRenderTargetSize;
-	if( ci::vr::EYE_LEFT == eye ) {
-		return Area( 0, 0, size.x / 2, size.y );
-	}
-	return Area( ( size.x + 1 ) / 2, 0, size.x, size.y );
+	return calcEyeViewport( eye, mRenderTargetSize, static_cast<bool>( mRenderTargetStereo ) );
 }
 
 void Hmd::enableEye( ci::vr::Eye eye, ci::vr::CoordSys eyeMatrixMode )
 {
+	if( enableStereoEye( eye, eyeMatrixMode ) ) {
+		return;
+	}
+
+	mFrameTiming->beginEye( eye );
+
+	if( mRenderTargetStereo && ( ci::vr::EYE_HMD != eye ) ) {
+		ci::Area area = getEyeViewport( eye );
+		ci::gl::viewport( area.getUL(), area.getSize() );
+		setMatricesEye( eye, eyeMatrixMode );
+		return;
+	}
+
 	switch( eye ) {
 		case ci::vr::EYE_LEFT: {
 			mRenderTargetLeft->bindFramebuffer();
-			ci::gl::viewport( mRenderTargetLeft->getSize() );
+			ci::Area area = getEyeViewport( eye );
+			ci::gl::viewport( area.getUL(), area.getSize() );
 			ci::gl::clear( mClearColor );
+			drawHiddenAreaMask( eye, area );
 		}
 		break;
 
 		case ci::vr::EYE_RIGHT: {
 			mRenderTargetRight->bindFramebuffer();
-			ci::gl::viewport( mRenderTargetRight->getSize() );
+			ci::Area area = getEyeViewport( eye );
+			ci::gl::viewport( area.getUL(), area.getSize() );
 			ci::gl::clear( mClearColor );
+			drawHiddenAreaMask( eye, area );
 		}
 		break;
 
@@ -697,9 +799,10 @@ void Hmd::calculateInputRay()
 {
 	// Ray components
 	ci::mat4 deviceToTrackingMatrix = mContext->getDeviceToTrackingMatrix( ::vr::k_unTrackedDeviceIndex_Hmd );
-	ci::mat4 coordSysMatrix = mInverseLookMatrix * mInverseOriginMatrix * deviceToTrackingMatrix;
-	ci::vec3 p0 = ci::vec3( coordSysMatrix * ci::vec4( 0, 0, 0, 1 ) );
-	ci::vec3 dir = ci::vec3( coordSysMatrix * ci::vec4( 0, 0, -1, 0 ) );
+	ci::mat4 coordSysMatrix;
+	ci::vr::multiplyTransforms( mInverseLookMatrix * mInverseOriginMatrix, &deviceToTrackingMatrix, &coordSysMatrix, 1 );
+	ci::vec3 p0 = ci::vec3( coordSysMatrix[3] );
+	ci::vec3 dir = -ci::vec3( coordSysMatrix[2] );
 	// Input ray
 	mInputRay = ci::Ray( p0, dir );
 }
@@ -729,21 +832,15 @@ void Hmd::drawMirroredImpl( const ci::Rectf& r )
 			m[3][1] =  h + r.y1;
 			ci::gl::multModelMatrix( m );
 
-			// Render left eye
-			{
-				auto resolvedTex = mRenderTargetLeft->getColorTexture();
+			// Render eyes
+			for( uint32_t i = 0; i < ci::vr::EYE_COUNT; ++i ) {
+				ci::Area area;
+				auto resolvedTex = getEyeTexture( static_cast<ci::vr::Eye>( i ), &area );
+				ci::vec2 texSize = ci::vec2( resolvedTex->getSize() );
 				resolvedTex->bind( kTexUnit );
 				mDistortionShader->uniform( "uTex0", kTexUnit );
-				mDistortionBatch->draw( 0, mDistortionIndexCount / 2 );
-				resolvedTex->unbind( kTexUnit );
-			}
-
-			// Render right eye
-			{
-				auto resolvedTex = mRenderTargetRight->getColorTexture();
-				resolvedTex->bind( kTexUnit );
-				mDistortionShader->uniform( "uTex0", kTexUnit );
-				mDistortionBatch->draw( mDistortionIndexCount / 2, mDistortionIndexCount / 2 );
+				mDistortionShader->uniform( "uTexCoordRect", ci::vec4( ci::vec2( area.getUL() ) / texSize, ci::vec2( area.getSize() ) / texSize ) );
+				mDistortionBatch->draw( i * ( mDistortionIndexCount / 2 ), mDistortionIndexCount / 2 );
 				resolvedTex->unbind( kTexUnit );
 			}
 		}
@@ -756,36 +853,31 @@ void Hmd::drawMirroredImpl( const ci::Rectf& r )
 
 			// Render left eye
 			{
-				auto resolvedTex = mRenderTargetLeft->getColorTexture();
-				ci::gl::draw( resolvedTex, fittedRect );
+				ci::Area area;
+				auto resolvedTex = getEyeTexture( ci::vr::EYE_LEFT, &area );
+				ci::gl::draw( resolvedTex, area, fittedRect );
 			}
 
 			// Render right eye
 			{
 				fittedRect += vec2( width / 2.0f, 0 );
-				auto resolvedTex = mRenderTargetRight->getColorTexture();
-				ci::gl::draw( resolvedTex, fittedRect );
+				ci::Area area;
+				auto resolvedTex = getEyeTexture( ci::vr::EYE_RIGHT, &area );
+				ci::gl::draw( resolvedTex, area, fittedRect );
 			}
 		}
 		break;
 
-		case Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_MONO_LEFT: {
-			auto tex = mRenderTargetLeft->getColorTexture();
-			float width = static_cast<float>( tex->getWidth() );
-			float height = static_cast<float>( tex->getHeight() );
-			auto texRect = ci::Rectf( 0, 0, width, height );
-			auto fittedRect = r.getCenteredFit( texRect, true );
-			ci::gl::draw( tex, Area( fittedRect ), r );	
-		}
-		break;
-
+		case Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_MONO_LEFT:
 		case Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_MONO_RIGHT: {
-			auto tex = mRenderTargetRight->getColorTexture();
-			float width = static_cast<float>( tex->getWidth() );
-			float height = static_cast<float>( tex->getHeight() );
+			ci::vr::Eye eye = ( Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_MONO_LEFT == mMirrorMode ) ? ci::vr::EYE_LEFT : ci::vr::EYE_RIGHT;
+			ci::Area area;
+			auto tex = getEyeTexture( eye, &area );
+			float width = static_cast<float>( area.getWidth() );
+			float height = static_cast<float>( area.getHeight() );
 			auto texRect = ci::Rectf( 0, 0, width, height );
 			auto fittedRect = r.getCenteredFit( texRect, true );
-			ci::gl::draw( tex, Area( fittedRect ), r );
+			ci::gl::draw( tex, Area( fittedRect ) + area.getUL(), r );
 		}
 		break;
 	}
@@ -793,6 +885,13 @@ void Hmd::drawMirroredImpl( const ci::Rectf& r )
 
 void Hmd::drawControllers( ci::vr::Eye eye )
 {
+	if( ci::vr::EYE_STEREO == eye ) {
+		forEachStereoEye( [this]( ci::vr::Eye stereoEye ) { drawControllers( stereoEye ); } );
+		return;
+	}
+
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_DRAW_CONTROLLERS );
+
 	if( mVrSystem->IsInputFocusCapturedByAnotherProcess() ) {
 		return;
 	}
@@ -807,34 +906,39 @@ void Hmd::drawControllers( ci::vr::Eye eye )
 	{
 		ci::gl::ScopedGlslProg scopedShader( mRenderModelShader );
 
-		for( uint32_t deviceIndex = 0; deviceIndex < ::vr::k_unMaxTrackedDeviceCount; ++deviceIndex ) {
-			if( ! mRenderModels[deviceIndex] ) {
-				continue;
-			}
-
-			const ::vr::TrackedDevicePose_t& pose = mContext->getPose( deviceIndex );
-			if( ! pose.bPoseIsValid ) {
-				continue;
+		// Only visit devices with a valid pose
+		ci::vr::PoseStore::forEachDevice( mContext->getPoseStore().getValidMask(), [&]( uint32_t deviceIndex ) {
+			const bool isPending = ( ! mRenderModels[deviceIndex] ) && ( ! mRenderModelNames[deviceIndex].empty() );
+			if( ( ! mRenderModels[deviceIndex] ) && ( ! isPending ) ) {
+				return;
 			}
 
 			const ci::mat4& hmdTrackingToDeviceMat = mContext->getTrackingToDeviceMatrix( ::vr::k_unTrackedDeviceIndex_Hmd );
 			const ci::mat4& ctrlDeviceToTrackingMat = mContext->getDeviceToTrackingMatrix( deviceIndex );
 			//ci::mat4 matMVP = mEyeProjectionMatrix[eye] * mEyePoseMatrix[eye] * hmdTrackingToDeviceMat * ctrlDeviceToTrackingMat;
 			ci::mat4 vpMat = getEyeViewProjectionMatrix( eye );
-			ci::mat4 mvpMat = vpMat * ctrlDeviceToTrackingMat;
-			mRenderModelShader->uniform( "uMatrix", mvpMat );
-			mRenderModelShader->uniform( "uTex0", 0 );
-
-			auto renderModel = mRenderModels[deviceIndex];
-			renderModel->draw();
-
-			ci::vr::Controller::Type ctrlType = ci::vr::Controller::TYPE_UNKNOWN;
-			::vr::ETrackedControllerRole role = mVrSystem->GetControllerRoleForTrackedDeviceIndex( deviceIndex );
-			switch( role ) {
-				case ::vr::TrackedControllerRole_LeftHand  : ctrlType = ci::vr::Controller::TYPE_LEFT; break; 
-				case ::vr::TrackedControllerRole_RightHand : ctrlType = ci::vr::Controller::TYPE_RIGHT; break;
+
+			if( isPending ) {
+				// Placeholder until the render model has been uploaded
+				ci::gl::ScopedGlslProg scopedPlaceholderShader( ci::gl::getStockShader( ci::gl::ShaderDef().color() ) );
+				ci::gl::ScopedMatrices scopedMatrices;
+				ci::gl::setProjectionMatrix( vpMat );
+				ci::gl::setViewMatrix( ci::mat4() );
+				ci::gl::setModelMatrix( ctrlDeviceToTrackingMat );
+				ci::gl::ScopedColor scopedColor( 0.5f, 0.5f, 0.5f );
+				ci::gl::drawStrokedCube( ci::vec3( 0 ), ci::vec3( kRenderModelPlaceholderSize ) );
+			}
+			else {
+				ci::mat4 mvpMat = vpMat * ctrlDeviceToTrackingMat;
+				mRenderModelShader->uniform( "uMatrix", mvpMat );
+				mRenderModelShader->uniform( "uTex0", 0 );
+
+				auto renderModel = mRenderModels[deviceIndex];
+				renderModel->draw();
 			}
 
+			ci::vr::Controller::Type ctrlType = mContext->getControllerType( deviceIndex );
+
 			if( ci::vr::Controller::TYPE_UNKNOWN != ctrlType ) {
 				ci::gl::ScopedBlendAlpha scopedBlend;
 				ci::gl::ScopedMatrices ScopedMatrices;
@@ -850,7 +954,7 @@ void Hmd::drawControllers( ci::vr::Eye eye )
 				mControllerIconBatch[ctrlType]->draw();
 				tex->unbind( 0 );
 			}
-		}
+		} );
 	}
 }
 
@@ -865,16 +969,11 @@ void Hmd::activateRenderModel( ::vr::TrackedDeviceIndex_t trackedDeviceIndex )
 		return;
 	}
 
-	ci::vr::openvr::DeviceManager* deviceManager = mContext->getDeviceManager();
+	// Queue the model, updateRenderModels picks it up once it's uploaded
 	std::string renderModelName = ci::vr::openvr::getTrackedDeviceString( mVrSystem, trackedDeviceIndex, ::vr::Prop_RenderModelName_String );
+	mRenderModelNames[trackedDeviceIndex] = renderModelName;
 	if( ! renderModelName.empty() ) {
-		RenderModelDataRef renderModelData = deviceManager->getRenderModelData( renderModelName );
-		if( renderModelData ) {
-			RenderModelRef renderModel = RenderModel::create( renderModelData, mRenderModelShader );
-			mRenderModels[trackedDeviceIndex] = renderModel;
-		}
-
-		CI_LOG_I( "...added: " << renderModelName );
+		mContext->getDeviceManager()->getRenderModelData( renderModelName );
 	}
 }
 
@@ -51,36 +51,14 @@ namespace cinder { namespace vr { namespace openvr  {
 // -------------------------------------------------------------------------------------------------
 // RenderModelData
 // -------------------------------------------------------------------------------------------------
-RenderModelData::RenderModelData( const std::string& name, ::vr::RenderModel_t* model, ::vr::RenderModel_TextureMap_t* texture )
-	: mName( name )
+RenderModelData::RenderModelData( const std::string& name, const ci::gl::VboMeshRef& vboMesh, const ci::gl::Texture2dRef& texture )
+	: mName( name ), mVboMesh( vboMesh ), mTexture( texture )
 {
-	// Vertex data vbo
-	ci::geom::BufferLayout layout = ci::geom::BufferLayout();
-	layout.append( ci::geom::POSITION,    3, sizeof( ::vr::RenderModel_Vertex_t ),(size_t)offsetof( ::vr::RenderModel_Vertex_t , vPosition ),      0 );
-	layout.append( ci::geom::NORMAL,      3, sizeof( ::vr::RenderModel_Vertex_t ),(size_t)offsetof( ::vr::RenderModel_Vertex_t , vNormal ),        0 );
-	layout.append( ci::geom::TEX_COORD_0, 2, sizeof( ::vr::RenderModel_Vertex_t ),(size_t)offsetof( ::vr::RenderModel_Vertex_t , rfTextureCoord ), 0 );
-	ci::gl::VboRef vertexDataVbo = ci::gl::Vbo::create( GL_ARRAY_BUFFER, model->unVertexCount * sizeof( ::vr::RenderModel_t ), model->rVertexData, GL_STATIC_DRAW );
-	std::vector<std::pair<ci::geom::BufferLayout, ci::gl::VboRef>> vertexArrayBuffers = { std::make_pair( layout, vertexDataVbo ) };
-	
-	// Indices vbo
-	ci::gl::VboRef indicesVbo = ci::gl::Vbo::create( GL_ELEMENT_ARRAY_BUFFER, 3 * model->unTriangleCount * sizeof( uint16_t ), model->rIndexData, GL_STATIC_DRAW );
-
-	// Vbo mesh
-	mVboMesh = ci::gl::VboMesh::create( static_cast<uint32_t>( model->unVertexCount ), GL_TRIANGLES, vertexArrayBuffers, static_cast<uint32_t>( 3 * model->unTriangleCount ), GL_UNSIGNED_SHORT, indicesVbo );
-
-	// Texture
-	ci::gl::Texture::Format texFormat;
-	texFormat.setInternalFormat( GL_RGBA );
-	texFormat.setWrapS( GL_CLAMP_TO_EDGE );
-	texFormat.setWrapT( GL_CLAMP_TO_EDGE );
-	texFormat.setMinFilter( GL_LINEAR );
-	texFormat.setMagFilter( GL_LINEAR );
-	mTexture = ci::gl::Texture::create( texture->rubTextureMapData, GL_RGBA, texture->unWidth, texture->unHeight, texFormat );
 }
 
-RenderModelDataRef RenderModelData::create( const std::string& name, ::vr::RenderModel_t* model, ::vr::RenderModel_TextureMap_t* texture )
+RenderModelDataRef RenderModelData::create( const std::string& name, const ci::gl::VboMeshRef& vboMesh, const ci::gl::Texture2dRef& texture )
 {
-	RenderModelDataRef result = RenderModelDataRef( new RenderModelData( name, model, texture ) );
+	RenderModelDataRef result = RenderModelDataRef( new RenderModelData( name, vboMesh, texture ) );
 	return result;
 }
 
@@ -0,0 +1,317 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/openvr/RenderModelCache.h"
+#include "cinder/Log.h"
+
+#if defined( CINDER_VR_ENABLE_OPENVR )
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+
+namespace cinder { namespace vr { namespace openvr {
+
+const char kRenderModelCacheMagic[8] = { 'C', 'I', 'V', 'R', 'R', 'M', 'C', '\0' };
+
+namespace {
+
+uint32_t alignOffset( uint32_t offset )
+{
+	return ( offset + 15 ) & ~15U;
+}
+
+// -------------------------------------------------------------------------------------------------
+// DXT5 block encoding: bounding box endpoints, nearest palette entry per pixel
+// -------------------------------------------------------------------------------------------------
+uint16_t toRgb565( const uint8_t *c )
+{
+	return static_cast<uint16_t>( ( ( c[0] >> 3 ) << 11 ) | ( ( c[1] >> 2 ) << 5 ) | ( c[2] >> 3 ) );
+}
+
+void fromRgb565( uint16_t v, int *out )
+{
+	int r = ( v >> 11 ) & 0x1F;
+	int g = ( v >>  5 ) & 0x3F;
+	int b = ( v >>  0 ) & 0x1F;
+	out[0] = ( r << 3 ) | ( r >> 2 );
+	out[1] = ( g << 2 ) | ( g >> 4 );
+	out[2] = ( b << 3 ) | ( b >> 2 );
+}
+
+void compressDxt5Block( const uint8_t block[16][4], uint8_t *out )
+{
+	// Alpha endpoints, a0 > a1 selects the 8 value palette
+	uint8_t minA = 255, maxA = 0;
+	uint8_t minC[3] = { 255, 255, 255 }, maxC[3] = { 0, 0, 0 };
+	for( int i = 0; i < 16; ++i ) {
+		minA = ( block[i][3] < minA ) ? block[i][3] : minA;
+		maxA = ( block[i][3] > maxA ) ? block[i][3] : maxA;
+		for( int c = 0; c < 3; ++c ) {
+			minC[c] = ( block[i][c] < minC[c] ) ? block[i][c] : minC[c];
+			maxC[c] = ( block[i][c] > maxC[c] ) ? block[i][c] : maxC[c];
+		}
+	}
+
+	out[0] = maxA;
+	out[1] = minA;
+	uint64_t alphaBits = 0;
+	if( maxA > minA ) {
+		const int range = maxA - minA;
+		for( int i = 0; i < 16; ++i ) {
+			// Position between min (0) and max (7), mapped to the palette order a0, a1, then interpolants from a0 towards a1
+			int pos = ( ( block[i][3] - minA ) * 7 + ( range / 2 ) ) / range;
+			uint64_t index = ( 7 == pos ) ? 0 : ( ( 0 == pos ) ? 1 : static_cast<uint64_t>( 8 - pos ) );
+			alphaBits |= index << ( 3 * i );
+		}
+	}
+	for( int i = 0; i < 6; ++i ) {
+		out[2 + i] = static_cast<uint8_t>( ( alphaBits >> ( 8 * i ) ) & 0xFF );
+	}
+
+	// Color endpoints, DXT5 always decodes the 4 color palette
+	uint16_t c0 = toRgb565( maxC );
+	uint16_t c1 = toRgb565( minC );
+	int palette[4][3];
+	fromRgb565( c0, palette[0] );
+	fromRgb565( c1, palette[1] );
+	for( int c = 0; c < 3; ++c ) {
+		palette[2][c] = ( 2 * palette[0][c] + palette[1][c] ) / 3;
+		palette[3][c] = ( palette[0][c] + 2 * palette[1][c] ) / 3;
+	}
+
+	uint32_t colorBits = 0;
+	if( c0 != c1 ) {
+		for( int i = 0; i < 16; ++i ) {
+			int bestIndex = 0;
+			int bestDist = INT_MAX;
+			for( int p = 0; p < 4; ++p ) {
+				int dr = block[i][0] - palette[p][0];
+				int dg = block[i][1] - palette[p][1];
+				int db = block[i][2] - palette[p][2];
+				int dist = dr*dr + dg*dg + db*db;
+				if( dist < bestDist ) {
+					bestDist = dist;
+					bestIndex = p;
+				}
+			}
+			colorBits |= static_cast<uint32_t>( bestIndex ) << ( 2 * i );
+		}
+	}
+
+	out[ 8] = static_cast<uint8_t>( c0 & 0xFF );
+	out[ 9] = static_cast<uint8_t>( c0 >> 8 );
+	out[10] = static_cast<uint8_t>( c1 & 0xFF );
+	out[11] = static_cast<uint8_t>( c1 >> 8 );
+	for( int i = 0; i < 4; ++i ) {
+		out[12 + i] = static_cast<uint8_t>( ( colorBits >> ( 8 * i ) ) & 0xFF );
+	}
+}
+
+} // anonymous namespace
+
+size_t getDxt5Size( uint32_t width, uint32_t height )
+{
+	size_t result = static_cast<size_t>( ( width + 3 ) / 4 ) * static_cast<size_t>( ( height + 3 ) / 4 ) * 16;
+	return result;
+}
+
+void compressDxt5( const uint8_t *rgba, uint32_t width, uint32_t height, uint8_t *out )
+{
+	uint8_t block[16][4];
+	for( uint32_t by = 0; by < height; by += 4 ) {
+		for( uint32_t bx = 0; bx < width; bx += 4 ) {
+			// Edge blocks repeat the last row and column
+			for( uint32_t y = 0; y < 4; ++y ) {
+				uint32_t sy = ( ( by + y ) < height ) ? ( by + y ) : ( height - 1 );
+				for( uint32_t x = 0; x < 4; ++x ) {
+					uint32_t sx = ( ( bx + x ) < width ) ? ( bx + x ) : ( width - 1 );
+					std::memcpy( block[4*y + x], rgba + 4 * ( static_cast<size_t>( sy ) * width + sx ), 4 );
+				}
+			}
+			compressDxt5Block( block, out );
+			out += 16;
+		}
+	}
+}
+
+// -------------------------------------------------------------------------------------------------
+// RenderModelCache
+// -------------------------------------------------------------------------------------------------
+RenderModelCache::RenderModelCache( const ci::fs::path& directory, const std::string& runtimeVersion )
+	: mDirectory( directory ), mRuntimeVersion( runtimeVersion )
+{
+	try {
+		ci::fs::create_directories( mDirectory );
+	}
+	catch( const std::exception& e ) {
+		throw ci::vr::openvr::Exception( "Couldn't create render model cache directory: " + mDirectory.string() + ", " + e.what() );
+	}
+}
+
+RenderModelCacheRef RenderModelCache::create( const ci::fs::path& directory, const std::string& runtimeVersion )
+{
+	RenderModelCacheRef result = RenderModelCacheRef( new RenderModelCache( directory, runtimeVersion ) );
+	return result;
+}
+
+ci::fs::path RenderModelCache::getEntryPath( const std::string& renderModelName ) const
+{
+	// Model names can contain path separators, keep them inside the cache directory
+	std::string fileName = renderModelName;
+	for( auto& c : fileName ) {
+		const bool keep = ( ( c >= 'a' ) && ( c <= 'z' ) ) || ( ( c >= 'A' ) && ( c <= 'Z' ) ) || ( ( c >= '0' ) && ( c <= '9' ) ) || ( '_' == c ) || ( '-' == c ) || ( '.' == c );
+		c = keep ? c : '_';
+	}
+	ci::fs::path result = mDirectory / ( fileName + ".cvrm" );
+	return result;
+}
+
+uint64_t RenderModelCache::getKey( const std::string& renderModelName ) const
+{
+	uint64_t result = ci::vr::hashFnv1a( renderModelName.data(), renderModelName.size() );
+	const char separator = '\0';
+	result = ci::vr::hashFnv1a( &separator, 1, result );
+	result = ci::vr::hashFnv1a( mRuntimeVersion.data(), mRuntimeVersion.size(), result );
+	return result;
+}
+
+ci::vr::MappedFileRef RenderModelCache::load( const std::string& renderModelName, RenderModelBuffers *outBuffers ) const
+{
+	ci::fs::path path = getEntryPath( renderModelName );
+	if( ! ci::fs::exists( path ) ) {
+		return ci::vr::MappedFileRef();
+	}
+
+	ci::vr::MappedFileRef file;
+	try {
+		file = ci::vr::MappedFile::create( path );
+	}
+	catch( const ci::vr::Exception& e ) {
+		CI_LOG_W( e.what() );
+		return ci::vr::MappedFileRef();
+	}
+
+	const size_t fileSize = file->getSize();
+	if( fileSize < sizeof( RenderModelCacheHeader ) ) {
+		return ci::vr::MappedFileRef();
+	}
+
+	const uint8_t *data = static_cast<const uint8_t*>( file->getData() );
+	const RenderModelCacheHeader *header = reinterpret_cast<const RenderModelCacheHeader*>( data );
+	const uint64_t vertexEnd = static_cast<uint64_t>( header->vertexOffset ) + static_cast<uint64_t>( header->numVertices ) * sizeof( ::vr::RenderModel_Vertex_t );
+	const uint64_t indexEnd = static_cast<uint64_t>( header->indexOffset ) + static_cast<uint64_t>( header->numIndices ) * sizeof( uint16_t );
+	const uint64_t textureEnd = static_cast<uint64_t>( header->textureOffset ) + header->textureSize;
+	bool valid = ( 0 == std::memcmp( header->magic, kRenderModelCacheMagic, sizeof( kRenderModelCacheMagic ) ) ) &&
+				 ( kRenderModelCacheVersion == header->version ) &&
+				 ( sizeof( RenderModelCacheHeader ) == header->headerSize ) &&
+				 ( getKey( renderModelName ) == header->key ) &&
+				 ( getDxt5Size( header->textureWidth, header->textureHeight ) == header->textureSize ) &&
+				 ( vertexEnd <= fileSize ) && ( indexEnd <= fileSize ) && ( textureEnd <= fileSize );
+	if( ! valid ) {
+		return ci::vr::MappedFileRef();
+	}
+
+	outBuffers->vertices = reinterpret_cast<const ::vr::RenderModel_Vertex_t*>( data + header->vertexOffset );
+	outBuffers->numVertices = header->numVertices;
+	outBuffers->indices = reinterpret_cast<const uint16_t*>( data + header->indexOffset );
+	outBuffers->numIndices = header->numIndices;
+	outBuffers->texture = data + header->textureOffset;
+	outBuffers->textureSize = header->textureSize;
+	outBuffers->textureWidth = header->textureWidth;
+	outBuffers->textureHeight = header->textureHeight;
+	return file;
+}
+
+bool RenderModelCache::store( const std::string& renderModelName, const RenderModelBuffers& buffers ) const
+{
+	RenderModelCacheHeader header = {};
+	std::memcpy( header.magic, kRenderModelCacheMagic, sizeof( kRenderModelCacheMagic ) );
+	header.version = kRenderModelCacheVersion;
+	header.headerSize = sizeof( RenderModelCacheHeader );
+	header.key = getKey( renderModelName );
+	header.numVertices = buffers.numVertices;
+	header.numIndices = buffers.numIndices;
+	header.textureWidth = buffers.textureWidth;
+	header.textureHeight = buffers.textureHeight;
+	header.vertexOffset = alignOffset( header.headerSize );
+	header.indexOffset = alignOffset( header.vertexOffset + buffers.numVertices * sizeof( ::vr::RenderModel_Vertex_t ) );
+	header.textureOffset = alignOffset( header.indexOffset + buffers.numIndices * sizeof( uint16_t ) );
+	header.textureSize = buffers.textureSize;
+
+	// Write next to the entry and rename, readers never see a partial file
+	ci::fs::path path = getEntryPath( renderModelName );
+	ci::fs::path tempPath = path;
+	tempPath += ".tmp";
+	std::FILE *file = std::fopen( tempPath.string().c_str(), "wb" );
+	if( nullptr == file ) {
+		return false;
+	}
+
+	const uint8_t padding[16] = {};
+	auto writeAt = [file, &padding]( uint32_t offset, const void *data, size_t size ) -> bool {
+		long pos = std::ftell( file );
+		size_t padSize = ( pos < static_cast<long>( offset ) ) ? ( offset - static_cast<size_t>( pos ) ) : 0;
+		return ( padSize == std::fwrite( padding, 1, padSize, file ) ) && ( size == std::fwrite( data, 1, size, file ) );
+	};
+
+	bool written = writeAt( 0, &header, sizeof( header ) ) &&
+				   writeAt( header.vertexOffset, buffers.vertices, buffers.numVertices * sizeof( ::vr::RenderModel_Vertex_t ) ) &&
+				   writeAt( header.indexOffset, buffers.indices, buffers.numIndices * sizeof( uint16_t ) ) &&
+				   writeAt( header.textureOffset, buffers.texture, buffers.textureSize );
+	written = ( 0 == std::fclose( file ) ) && written;
+
+	try {
+		if( written ) {
+			ci::fs::rename( tempPath, path );
+		}
+		else {
+			ci::fs::remove( tempPath );
+		}
+	}
+	catch( const std::exception& e ) {
+		CI_LOG_W( "Couldn't write render model cache entry: " << path << ", " << e.what() );
+		written = false;
+	}
+
+	return written;
+}
+
+}}} // namespace cinder::vr::vive
+
+#endif // defined( CINDER_VR_ENABLE_OPENVR )
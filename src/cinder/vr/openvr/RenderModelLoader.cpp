@@ -0,0 +1,334 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/openvr/RenderModelLoader.h"
+#include "cinder/app/App.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/Log.h"
+
+#if defined( CINDER_VR_ENABLE_OPENVR )
+
+#if ! defined( GL_COMPRESSED_RGBA_S3TC_DXT5_EXT )
+	#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+namespace cinder { namespace vr { namespace openvr {
+
+//! CPU side render model, filled by the worker thread. The buffers point either into the
+//! vectors or into the mapped cache file.
+struct RenderModelLoader::Source {
+	std::string								name;
+	bool									failed = false;
+	bool									cacheChecked = false;
+	::vr::RenderModel_t						*model = nullptr;
+	::vr::RenderModel_TextureMap_t			*texture = nullptr;
+	std::vector<::vr::RenderModel_Vertex_t>	vertices;
+	std::vector<uint16_t>					indices;
+	std::vector<uint8_t>					compressedTexture;
+	ci::vr::MappedFileRef					cacheFile;
+	RenderModelBuffers						buffers;
+};
+
+//! GL upload of a Source, split into steps so that update() can stop between them
+struct RenderModelLoader::Upload {
+	enum Step { STEP_VERTICES, STEP_INDICES, STEP_TEXTURE };
+
+	SourceRef								source;
+	Step									step = STEP_VERTICES;
+	ci::gl::VboRef							vertexDataVbo;
+	ci::gl::VboMeshRef						vboMesh;
+};
+
+// -------------------------------------------------------------------------------------------------
+// RenderModelLoader
+// -------------------------------------------------------------------------------------------------
+RenderModelLoader::RenderModelLoader( const ci::vr::openvr::RenderModelCacheRef& cache )
+	: mCache( cache )
+{
+	mThread = std::thread( &RenderModelLoader::threadProc, this );
+}
+
+RenderModelLoader::~RenderModelLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mRunning = false;
+	}
+	mCondition.notify_one();
+
+	if( mThread.joinable() ) {
+		mThread.join();
+	}
+}
+
+RenderModelLoaderRef RenderModelLoader::create( const ci::vr::openvr::RenderModelCacheRef& cache )
+{
+	RenderModelLoaderRef result = RenderModelLoaderRef( new RenderModelLoader( cache ) );
+	return result;
+}
+
+void RenderModelLoader::request( const std::string& renderModelName )
+{
+	if( renderModelName.empty() || ( mRenderModelData.end() != mRenderModelData.find( renderModelName ) ) || isLoading( renderModelName ) ) {
+		return;
+	}
+
+	mLoading.insert( renderModelName );
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mRequests.push_back( renderModelName );
+	}
+	mCondition.notify_one();
+}
+
+ci::vr::openvr::RenderModelDataRef RenderModelLoader::getRenderModelData( const std::string& renderModelName ) const
+{
+	ci::vr::openvr::RenderModelDataRef result;
+	auto it = mRenderModelData.find( renderModelName );
+	if( mRenderModelData.end() != it ) {
+		result = it->second;
+	}
+	return result;
+}
+
+bool RenderModelLoader::isLoading( const std::string& renderModelName ) const
+{
+	bool result = ( mLoading.end() != mLoading.find( renderModelName ) );
+	return result;
+}
+
+void RenderModelLoader::update( double budgetSeconds )
+{
+	const double startTime = ci::app::getElapsedSeconds();
+	do {
+		if( ! mUpload ) {
+			std::lock_guard<std::mutex> lock( mMutex );
+			if( mLoaded.empty() ) {
+				break;
+			}
+
+			mUpload = std::make_shared<Upload>();
+			mUpload->source = mLoaded.front();
+			mLoaded.pop_front();
+		}
+
+		uploadStep();
+	} while( ( ci::app::getElapsedSeconds() - startTime ) < budgetSeconds );
+}
+
+void RenderModelLoader::uploadStep()
+{
+	const Source& source = *( mUpload->source );
+	const RenderModelBuffers& buffers = source.buffers;
+	if( source.failed ) {
+		CI_LOG_W( "Couldn't load render model: " << source.name );
+		// Cache the failure so that the model isn't requested again
+		mRenderModelData[source.name] = ci::vr::openvr::RenderModelDataRef();
+		mLoading.erase( source.name );
+		mUpload.reset();
+		return;
+	}
+
+	switch( mUpload->step ) {
+		case Upload::STEP_VERTICES: {
+			mUpload->vertexDataVbo = ci::gl::Vbo::create( GL_ARRAY_BUFFER, buffers.numVertices * sizeof( ::vr::RenderModel_Vertex_t ), buffers.vertices, GL_STATIC_DRAW );
+			mUpload->step = Upload::STEP_INDICES;
+		}
+		break;
+
+		case Upload::STEP_INDICES: {
+			ci::geom::BufferLayout layout = ci::geom::BufferLayout();
+			layout.append( ci::geom::POSITION,    3, sizeof( ::vr::RenderModel_Vertex_t ),(size_t)offsetof( ::vr::RenderModel_Vertex_t , vPosition ),      0 );
+			layout.append( ci::geom::NORMAL,      3, sizeof( ::vr::RenderModel_Vertex_t ),(size_t)offsetof( ::vr::RenderModel_Vertex_t , vNormal ),        0 );
+			layout.append( ci::geom::TEX_COORD_0, 2, sizeof( ::vr::RenderModel_Vertex_t ),(size_t)offsetof( ::vr::RenderModel_Vertex_t , rfTextureCoord ), 0 );
+			std::vector<std::pair<ci::geom::BufferLayout, ci::gl::VboRef>> vertexArrayBuffers = { std::make_pair( layout, mUpload->vertexDataVbo ) };
+
+			ci::gl::VboRef indicesVbo = ci::gl::Vbo::create( GL_ELEMENT_ARRAY_BUFFER, buffers.numIndices * sizeof( uint16_t ), buffers.indices, GL_STATIC_DRAW );
+			mUpload->vboMesh = ci::gl::VboMesh::create( buffers.numVertices, GL_TRIANGLES, vertexArrayBuffers, buffers.numIndices, GL_UNSIGNED_SHORT, indicesVbo );
+			mUpload->step = Upload::STEP_TEXTURE;
+		}
+		break;
+
+		case Upload::STEP_TEXTURE: {
+			// DXT5 blocks go straight from the source buffer, no decompression on upload
+			GLuint textureId = 0;
+			glGenTextures( 1, &textureId );
+			{
+				ci::gl::ScopedTextureBind scopedTextureBind( GL_TEXTURE_2D, textureId );
+				glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+				glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+				glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+				glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+				glCompressedTexImage2D( GL_TEXTURE_2D, 0, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, buffers.textureWidth, buffers.textureHeight, 0, buffers.textureSize, buffers.texture );
+			}
+			ci::gl::Texture2dRef texture = ci::gl::Texture2d::create( GL_TEXTURE_2D, textureId, buffers.textureWidth, buffers.textureHeight, false );
+
+			mRenderModelData[source.name] = ci::vr::openvr::RenderModelData::create( source.name, mUpload->vboMesh, texture );
+			mLoading.erase( source.name );
+			mUpload.reset();
+
+			CI_LOG_I( "...added: " << source.name );
+		}
+		break;
+	}
+}
+
+bool RenderModelLoader::pollSource( Source *source )
+{
+	::vr::IVRRenderModels* renderModels = ::vr::VRRenderModels();
+	if( nullptr == renderModels ) {
+		source->failed = true;
+		return true;
+	}
+
+	// Cache hits never touch the runtime
+	if( mCache && ( ! source->cacheChecked ) ) {
+		source->cacheChecked = true;
+		source->cacheFile = mCache->load( source->name, &source->buffers );
+		if( source->cacheFile ) {
+			return true;
+		}
+	}
+
+	if( nullptr == source->model ) {
+		::vr::EVRRenderModelError error = renderModels->LoadRenderModel_Async( source->name.c_str(), &source->model );
+		if( ::vr::VRRenderModelError_Loading == error ) {
+			return false;
+		}
+
+		if( ::vr::VRRenderModelError_None != error ) {
+			source->failed = true;
+			return true;
+		}
+	}
+
+	::vr::EVRRenderModelError error = renderModels->LoadTexture_Async( source->model->diffuseTextureId, &source->texture );
+	if( ::vr::VRRenderModelError_Loading == error ) {
+		return false;
+	}
+
+	if( ::vr::VRRenderModelError_None == error ) {
+		const ::vr::RenderModel_t* model = source->model;
+		const ::vr::RenderModel_TextureMap_t* texture = source->texture;
+		source->vertices.assign( model->rVertexData, model->rVertexData + model->unVertexCount );
+		source->indices.assign( model->rIndexData, model->rIndexData + ( 3 * model->unTriangleCount ) );
+		source->compressedTexture.resize( ci::vr::openvr::getDxt5Size( texture->unWidth, texture->unHeight ) );
+		ci::vr::openvr::compressDxt5( texture->rubTextureMapData, texture->unWidth, texture->unHeight, source->compressedTexture.data() );
+
+		RenderModelBuffers& buffers = source->buffers;
+		buffers.vertices = source->vertices.data();
+		buffers.numVertices = static_cast<uint32_t>( source->vertices.size() );
+		buffers.indices = source->indices.data();
+		buffers.numIndices = static_cast<uint32_t>( source->indices.size() );
+		buffers.texture = source->compressedTexture.data();
+		buffers.textureSize = static_cast<uint32_t>( source->compressedTexture.size() );
+		buffers.textureWidth = texture->unWidth;
+		buffers.textureHeight = texture->unHeight;
+
+		if( mCache && ( ! mCache->store( source->name, buffers ) ) ) {
+			CI_LOG_W( "Couldn't cache render model: " << source->name );
+		}
+	}
+	else {
+		source->failed = true;
+	}
+
+	releaseSource( source );
+	return true;
+}
+
+void RenderModelLoader::releaseSource( Source *source )
+{
+	::vr::IVRRenderModels* renderModels = ::vr::VRRenderModels();
+	if( renderModels && ( nullptr != source->model ) ) {
+		renderModels->FreeRenderModel( source->model );
+	}
+	if( renderModels && ( nullptr != source->texture ) ) {
+		renderModels->FreeTexture( source->texture );
+	}
+	source->model = nullptr;
+	source->texture = nullptr;
+}
+
+void RenderModelLoader::threadProc()
+{
+	std::vector<SourceRef> inFlight;
+	while( true ) {
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			if( inFlight.empty() ) {
+				mCondition.wait( lock, [this]() { return ( ! mRunning ) || ( ! mRequests.empty() ); } );
+			}
+
+			if( ! mRunning ) {
+				break;
+			}
+
+			while( ! mRequests.empty() ) {
+				SourceRef source = std::make_shared<Source>();
+				source->name = mRequests.front();
+				mRequests.pop_front();
+				inFlight.push_back( source );
+			}
+		}
+
+		// Poll every model once per pass, the runtime loads them in parallel
+		for( auto it = inFlight.begin(); it != inFlight.end(); ) {
+			if( pollSource( it->get() ) ) {
+				std::lock_guard<std::mutex> lock( mMutex );
+				mLoaded.push_back( *it );
+				it = inFlight.erase( it );
+			}
+			else {
+				++it;
+			}
+		}
+
+		if( ! inFlight.empty() ) {
+			ci::vr::openvr::threadSleep( 1 );
+		}
+	}
+
+	for( auto& source : inFlight ) {
+		releaseSource( source.get() );
+	}
+}
+
+}}} // namespace cinder::vr::vive
+
+#endif // defined( CINDER_VR_ENABLE_OPENVR )
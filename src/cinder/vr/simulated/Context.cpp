@@ -0,0 +1,217 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/simulated/Context.h"
+#include "cinder/vr/simulated/Controller.h"
+#include "cinder/vr/simulated/DeviceManager.h"
+#include "cinder/vr/simulated/Hmd.h"
+#include "cinder/app/App.h"
+#include "cinder/CinderMath.h"
+#include "cinder/Log.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+#include <cmath>
+
+namespace cinder { namespace vr { namespace simulated {
+
+const float kStandingEyeHeight = 1.7f; // Meters
+
+Context::Context( const ci::vr::SessionOptions& sessionOptions, ci::vr::simulated::DeviceManager* deviceManager )
+	: ci::vr::Context( sessionOptions, deviceManager ), mDeviceManager( deviceManager )
+{
+}
+
+Context::~Context()
+{
+	endSession();
+}
+
+ContextRef Context::create( const ci::vr::SessionOptions& sessionOptions, ci::vr::simulated::DeviceManager* deviceManager )
+{
+	ContextRef result = ContextRef( new Context( sessionOptions, deviceManager ) );
+	return result;
+}
+
+void Context::scanForControllers()
+{
+	if( ( ! mCompositor ) || ( ! mDeviceManager->getOptions().getControllersEnabled() ) ) {
+		return;
+	}
+
+	const ci::vr::Controller::Type kTypes[2] = { ci::vr::Controller::TYPE_LEFT, ci::vr::Controller::TYPE_RIGHT };
+	for( auto type : kTypes ) {
+		if( ! hasController( type ) ) {
+			auto ctrl = ci::vr::simulated::Controller::create( type, this );
+			addController( ctrl );
+		}
+	}
+}
+
+void Context::beginSession()
+{
+	if( mCompositor ) {
+		return;
+	}
+
+	const auto& options = mDeviceManager->getOptions();
+	mCompositor = ci::vr::simulated::Compositor::create( options.getRefreshRate(), options.getThrottled() );
+
+	// Initial poses
+	mPoseStore.beginUpdate();
+	for( uint32_t deviceIndex = 0; deviceIndex < ci::vr::simulated::kMaxTrackedDeviceCount; ++deviceIndex ) {
+		mPoseStore.setPose( deviceIndex, calculateDevicePose( deviceIndex, 0.0 ), ci::vec3( 0 ), ci::vec3( 0 ), mCompositor->getPredictedDisplayTime() );
+	}
+	mPoseStore.endUpdate();
+
+	// Get connected controllers
+	scanForControllers();
+
+	// Create HMD
+	mHmd = ci::vr::simulated::Hmd::create( this );
+
+	// Set frame rate for VR
+	ci::gl::enableVerticalSync( getSessionOptions().getVerticalSync() );
+	ci::app::setFrameRate( getSessionOptions().getFrameRate() );
+}
+
+void Context::endSession()
+{
+	// Destroy HMD
+	mHmd.reset();
+
+	mCompositor.reset();
+}
+
+void Context::updateFrameStats( ci::vr::QualityGovernor::FrameStats* stats )
+{
+	ci::vr::Context::updateFrameStats( stats );
+	if( ! mCompositor ) {
+		return;
+	}
+
+	stats->budgetSeconds = mCompositor->getFrameDuration();
+
+	uint64_t numDroppedFrames = mCompositor->getNumDroppedFrames();
+	if( numDroppedFrames >= mPrevNumDroppedFrames ) {
+		stats->numDroppedFrames = static_cast<uint32_t>( numDroppedFrames - mPrevNumDroppedFrames );
+	}
+	mPrevNumDroppedFrames = numDroppedFrames;
+}
+
+void Context::processEvents()
+{
+	if( ( ! mCompositor ) || ( ! mDeviceManager->getOptions().getMotionEnabled() ) ) {
+		return;
+	}
+
+	double t = mCompositor->getPredictedDisplayTime();
+	for( auto& baseCtrl : mControllers ) {
+		auto ctrl = std::dynamic_pointer_cast<ci::vr::simulated::Controller>( baseCtrl );
+		ctrl->processSyntheticInput( t );
+	}
+}
+
+void Context::updatePoseData()
+{
+	updatePoseStore( mCompositor->getPredictedDisplayTime() );
+
+	ci::mat4 coordSysMatrix;
+	if( mHmd ) {
+		coordSysMatrix = mHmd->getInverseLookMatrix() * mHmd->getInverseOriginMatrix();
+	}
+
+	// Controllers without a valid pose hold their last one
+	for( auto& baseCtrl : mControllers ) {
+		auto ctrl = std::dynamic_pointer_cast<ci::vr::simulated::Controller>( baseCtrl );
+		uint32_t deviceIndex = ctrl->getTrackedDeviceIndex();
+		if( mPoseStore.isValid( deviceIndex ) ) {
+			ctrl->processControllerPose( mPoseStore.getDeviceToTrackingMatrix( deviceIndex ), coordSysMatrix );
+		}
+	}
+}
+
+void Context::updatePoseStore( double sampleTime )
+{
+	double t = mDeviceManager->getOptions().getMotionEnabled() ? sampleTime : 0.0;
+
+	// Poses are calculated for the predicted display time, velocities are estimated from the previous frame
+	mPoseStore.beginUpdate();
+	for( uint32_t deviceIndex = 0; deviceIndex < ci::vr::simulated::kMaxTrackedDeviceCount; ++deviceIndex ) {
+		ci::mat4 deviceToTracking = calculateDevicePose( deviceIndex, t );
+		ci::vec3 linearVelocity = ci::vec3( 0 );
+		ci::vec3 angularVelocity = ci::vec3( 0 );
+		if( mPoseStore.isValid( deviceIndex ) ) {
+			float dt = static_cast<float>( sampleTime - mPoseStore.getSampleTime( deviceIndex ) );
+			ci::vr::calculateVelocities( mPoseStore.getDeviceToTrackingMatrix( deviceIndex ), deviceToTracking, dt, &linearVelocity, &angularVelocity );
+		}
+		mPoseStore.setPose( deviceIndex, deviceToTracking, linearVelocity, angularVelocity, sampleTime );
+	}
+	mPoseStore.endUpdate();
+}
+
+ci::mat4 Context::calculateDevicePose( uint32_t deviceIndex, double t ) const
+{
+	float eyeHeight = ( ci::vr::TRACKING_ORIGIN_STANDING == getSessionOptions().getTrackingOrigin() ) ? kStandingEyeHeight : 0.0f;
+
+	// Head: slow look around with a little sway
+	float yaw = 0.35f * static_cast<float>( std::sin( 0.30 * t ) );
+	float pitch = 0.10f * static_cast<float>( std::sin( 0.70 * t ) );
+	ci::vec3 headPosition = ci::vec3(
+		0.05f * static_cast<float>( std::sin( 0.40 * t ) ),
+		0.02f * static_cast<float>( std::sin( 0.90 * t ) ) + eyeHeight,
+		0.03f * static_cast<float>( std::sin( 0.25 * t ) )
+	);
+	ci::mat4 bodyMatrix = glm::translate( headPosition ) * glm::rotate( yaw, ci::vec3( 0, 1, 0 ) );
+
+	if( ci::vr::simulated::kTrackedDeviceIndexHmd == deviceIndex ) {
+		ci::mat4 result = bodyMatrix * glm::rotate( pitch, ci::vec3( 1, 0, 0 ) );
+		return result;
+	}
+
+	// Hands: held in front of the body, each tracing a small circle
+	float side = ( ci::vr::simulated::kTrackedDeviceIndexLeftHand == deviceIndex ) ? -1.0f : 1.0f;
+	float theta = static_cast<float>( 2.0 * M_PI * 0.5 * t ) * side;
+	ci::vec3 handPosition = ci::vec3( side * 0.2f + 0.08f * std::cos( theta ), -0.45f + 0.08f * std::sin( theta ), -0.35f );
+	ci::mat4 result = bodyMatrix * glm::translate( handPosition ) * glm::rotate( -0.3f, ci::vec3( 1, 0, 0 ) );
+	return result;
+}
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
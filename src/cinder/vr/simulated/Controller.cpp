@@ -0,0 +1,203 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/simulated/Controller.h"
+#include "cinder/vr/simulated/Context.h"
+#include "cinder/vr/PoseMath.h"
+#include "cinder/CinderMath.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+#include <cmath>
+
+namespace cinder { namespace vr { namespace simulated {
+
+// -------------------------------------------------------------------------------------------------
+// Controller
+// -------------------------------------------------------------------------------------------------
+Controller::Controller( ci::vr::Controller::Type type, ci::vr::Context *context )
+	: ci::vr::Controller( type, context )
+{
+	mTrackedDeviceIndex = ( ci::vr::Controller::TYPE_LEFT == type ) ? ci::vr::simulated::kTrackedDeviceIndexLeftHand : ci::vr::simulated::kTrackedDeviceIndexRightHand;
+
+	addButton( ci::vr::Controller::BUTTON_1 );
+	addButton( ci::vr::Controller::BUTTON_2 );
+	addButton( ci::vr::Controller::BUTTON_3 );
+	addButton( ci::vr::Controller::BUTTON_4 );
+
+	addTrigger( ci::vr::Controller::TRIGGER_1 );
+
+	addAxis( ci::vr::Controller::AXIS_1 );
+}
+
+Controller::~Controller()
+{
+}
+
+ci::vr::simulated::ControllerRef Controller::create( ci::vr::Controller::Type type, ci::vr::Context *context )
+{
+	ci::vr::simulated::ControllerRef result = ci::vr::simulated::ControllerRef( new ci::vr::simulated::Controller( type, context ) );
+	return result;
+}
+
+std::string Controller::getName() const
+{
+	std::string result = "Simulated Controller";
+	switch( getType() ) {
+		case ci::vr::Controller::TYPE_LEFT  : result += " (LEFT)"; break;
+		case ci::vr::Controller::TYPE_RIGHT : result += " (RIGHT)"; break;
+	}
+	return result;
+}
+
+std::string Controller::getButtonName( ci::vr::Controller::ButtonId id ) const
+{
+	std::string result = "BUTTON_UNKNOWN";
+	switch( id ) {
+		case ci::vr::Controller::BUTTON_1 : result = "BUTTON_1"; break;
+		case ci::vr::Controller::BUTTON_2 : result = "BUTTON_2"; break;
+		case ci::vr::Controller::BUTTON_3 : result = "BUTTON_3"; break;
+		case ci::vr::Controller::BUTTON_4 : result = "BUTTON_4"; break;
+	}
+	return result;
+}
+
+std::string Controller::getTriggerName( ci::vr::Controller::TriggerId id ) const
+{
+	std::string result = "TRIGGER_UNKNOWN";
+	switch( id ) {
+		case ci::vr::Controller::TRIGGER_1 : result = "TRIGGER_1"; break;
+	}
+	return result;
+}
+
+std::string Controller::getAxisName( ci::vr::Controller::AxisId id ) const
+{
+	std::string result = "AXIS_UNKNOWN";
+	switch( id ) {
+		case ci::vr::Controller::AXIS_1 : result = "AXIS_1"; break;
+	}
+	return result;
+}
+
+void Controller::processControllerPose( const ci::mat4& deviceToTrackingMatrix, const ci::mat4& coordSysMatrix )
+{
+	mDeviceToTrackingMatrix = deviceToTrackingMatrix;
+	ci::vr::invertRigid( &mDeviceToTrackingMatrix, &mTrackingToDeviceMatrix, 1 );
+
+	ci::mat4 mat;
+	ci::vr::multiplyTransforms( coordSysMatrix, &mDeviceToTrackingMatrix, &mat, 1 );
+	ci::vec3 p0 = ci::vec3( mat[3] );
+	ci::vec3 dir = -ci::vec3( mat[2] );
+	mInputRay = ci::Ray( p0, dir );
+}
+
+void Controller::processSyntheticInput( double t )
+{
+	// Offset the right hand by half a cycle so the two controllers don't fire in lockstep
+	double phase = ( ci::vr::Controller::TYPE_RIGHT == getType() ) ? 0.5 : 0.0;
+
+	// Trigger pulls once every two seconds
+	float triggerValue = 0.5f - 0.5f * static_cast<float>( std::cos( M_PI * ( t + 2.0 * phase ) ) );
+	setTriggerValue( getTrigger( ci::vr::Controller::TRIGGER_1 ), triggerValue );
+
+	// Axis traces a slow circle
+	float theta = static_cast<float>( 2.0 * M_PI * ( 0.25 * t + phase ) );
+	setAxisValue( getAxis( ci::vr::Controller::AXIS_1 ), ci::vec2( std::cos( theta ), std::sin( theta ) ) );
+
+	// Button 4 follows the trigger, buttons 1-3 take turns being held for a quarter of a second
+	uint32_t buttonsDown = ( triggerValue > 0.9f ) ? ci::vr::Controller::BUTTON_4 : 0;
+	double cycle = std::fmod( t + 3.0 * phase, 3.0 );
+	const ci::vr::Controller::ButtonId kButtons[3] = { ci::vr::Controller::BUTTON_1, ci::vr::Controller::BUTTON_2, ci::vr::Controller::BUTTON_3 };
+	for( int i = 0; i < 3; ++i ) {
+		double dt = cycle - static_cast<double>( i );
+		if( ( dt >= 0.0 ) && ( dt < 0.25 ) ) {
+			buttonsDown |= kButtons[i];
+		}
+	}
+
+	// Only the buttons whose down bit differs need visiting, unknown buttons that stay up stay unknown
+	const uint32_t changed = ( getButtonMask() & buttonsDown ) ^ getButtonsDown();
+	for( uint32_t bits = changed; 0 != bits; bits &= ( bits - 1 ) ) {
+		ci::vr::Controller::Button* button = &mButtons[ci::vr::countTrailingZeros( bits )];
+		uint32_t buttonMask = static_cast<uint32_t>( button->getId() );
+		setButtonState( button, ( buttonMask == ( buttonsDown & buttonMask ) ) ? ci::vr::Controller::STATE_DOWN : ci::vr::Controller::STATE_UP );
+	}
+}
+
+void Controller::processRecordedInput( const ci::vr::RecordedController& recorded )
+{
+	mTrackedDeviceIndex = recorded.trackedDeviceIndex;
+
+	for( uint32_t bits = recorded.buttonsKnown; 0 != bits; bits &= ( bits - 1 ) ) {
+		uint32_t buttonMask = bits & ( ~bits + 1 );
+		ci::vr::Controller::ButtonId buttonId = static_cast<ci::vr::Controller::ButtonId>( buttonMask );
+		ci::vr::Controller::Button *button = addButton( buttonId );
+
+		ci::vr::Controller::State state = ( buttonMask == ( recorded.buttonsDown & buttonMask ) ) ? ci::vr::Controller::STATE_DOWN : ci::vr::Controller::STATE_UP;
+		setButtonState( button, state );
+	}
+
+	for( uint32_t i = 0; i < ci::vr::kRecordingMaxTriggers; ++i ) {
+		uint32_t triggerMask = 1u << i;
+		if( 0 == ( recorded.triggersKnown & triggerMask ) ) {
+			continue;
+		}
+
+		ci::vr::Controller::TriggerId triggerId = static_cast<ci::vr::Controller::TriggerId>( triggerMask );
+		ci::vr::Controller::Trigger *trigger = addTrigger( triggerId );
+
+		setTriggerValue( trigger, recorded.triggers[i] );
+	}
+
+	for( uint32_t i = 0; i < ci::vr::kRecordingMaxAxes; ++i ) {
+		uint32_t axisMask = 1u << i;
+		if( 0 == ( recorded.axesKnown & axisMask ) ) {
+			continue;
+		}
+
+		ci::vr::Controller::AxisId axisId = static_cast<ci::vr::Controller::AxisId>( axisMask );
+		ci::vr::Controller::Axis *axis = addAxis( axisId );
+
+		setAxisValue( axis, ci::vec2( recorded.axes[i][0], recorded.axes[i][1] ) );
+	}
+}
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
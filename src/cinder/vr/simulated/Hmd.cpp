@@ -0,0 +1,420 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/simulated/Hmd.h"
+#include "cinder/vr/simulated/Context.h"
+#include "cinder/vr/simulated/DeviceManager.h"
+#include "cinder/vr/PoseMath.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+#include "cinder/app/App.h"
+#include "cinder/gl/draw.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/Log.h"
+
+#include <cmath>
+
+namespace cinder { namespace vr { namespace simulated {
+
+Hmd::Hmd( ci::vr::simulated::Context *context )
+	: ci::vr::Hmd( context ), mContext( context )
+{
+	mNearClip = context->getSessionOptions().getNearClip();
+	mFarClip = context->getSessionOptions().getFarClip();
+
+	setupGpuTiming();
+	setupRenderTarget();
+	setupMatrices();
+
+	if( app::App::get()->isFrameRateEnabled() ) {
+		CI_LOG_I( "Disabled framerate for better performance." );
+		app::App::get()->disableFrameRate();
+	}
+
+	if( gl::isVerticalSyncEnabled() ) {
+		CI_LOG_I( "Disabled vertical sync: handled by compositor service." );
+		gl::enableVerticalSync( false );
+	}
+
+	updatePoseData();
+}
+
+Hmd::~Hmd()
+{
+}
+
+ci::vr::simulated::HmdRef Hmd::create( ci::vr::simulated::Context *context )
+{
+	ci::vr::simulated::HmdRef result = ci::vr::simulated::HmdRef( new ci::vr::simulated::Hmd( context ) );
+	return result;
+}
+
+const ci::vr::simulated::CompositorRef& Hmd::getCompositor() const
+{
+	return mContext->getCompositor();
+}
+
+void Hmd::setupMatrices()
+{
+	const auto& options = mContext->getDeviceManager()->getOptions();
+
+	// Eye to head offsets
+	float halfIpd = isMonoscopic() ? 0.0f : 0.5f * options.getIpd();
+	mEyePoseMatrix[ci::vr::EYE_LEFT] = glm::translate( ci::vec3( halfIpd, 0, 0 ) );
+	mEyePoseMatrix[ci::vr::EYE_RIGHT] = glm::translate( ci::vec3( -halfIpd, 0, 0 ) );
+	mEyeCamera[ci::vr::EYE_LEFT].setViewMatrix( mEyePoseMatrix[ci::vr::EYE_LEFT] );
+	mEyeCamera[ci::vr::EYE_RIGHT].setViewMatrix( mEyePoseMatrix[ci::vr::EYE_RIGHT] );
+
+	// Symmetric projection, options FOV is horizontal
+	ci::Area area = getEyeViewport( ci::vr::EYE_LEFT );
+	float width = static_cast<float>( area.getWidth() );
+	float height = static_cast<float>( area.getHeight() );
+	float fovY = 2.0f * std::atan( std::tan( 0.5f * toRadians( options.getFov() ) ) * height / width );
+	ci::mat4 projectionMatrix = glm::perspectiveFov( fovY, width, height, mNearClip, mFarClip );
+	mEyeCamera[ci::vr::EYE_LEFT].setProjectionMatrix( projectionMatrix );
+	mEyeCamera[ci::vr::EYE_RIGHT].setProjectionMatrix( projectionMatrix );
+}
+
+void Hmd::setupRenderTarget()
+{
+	mRenderTargetSize = mContext->getDeviceManager()->getOptions().getRenderTargetSize();
+	CI_LOG_I( "mRenderTargetSize=" << mRenderTargetSize );
+
+	// Texture format
+	ci::gl::Texture2d::Format texFormat = ci::gl::Texture2d::Format();
+	texFormat.setInternalFormat( GL_RGBA8 );
+	texFormat.setWrapS( GL_CLAMP_TO_EDGE );
+	texFormat.setWrapT( GL_CLAMP_TO_EDGE );
+	texFormat.setMinFilter( GL_LINEAR );
+	texFormat.setMagFilter( GL_LINEAR );
+	// Fbo format
+	ci::gl::Fbo::Format fboFormat = ci::gl::Fbo::Format();
+	fboFormat.setSamples( getSessionOptions().getSampleCount() );
+	fboFormat.setColorTextureFormat( texFormat );
+	fboFormat.enableDepthBuffer();
+	// Render target
+	mRenderTarget = ci::gl::Fbo::create( mRenderTargetSize.x, mRenderTargetSize.y, fboFormat );
+
+	// Layers are resolved into the side by side target the compositor reads
+	if( isMultiviewStereo() ) {
+		setupMultiviewTarget( ci::ivec2( mRenderTargetSize.x / 2, mRenderTargetSize.y ), getSessionOptions().getSampleCount() );
+	}
+}
+
+void Hmd::updatePoseData()
+{
+	mContext->updatePoseData();
+
+	const auto& hmdMat = mContext->getTrackingToDeviceMatrix( ci::vr::simulated::kTrackedDeviceIndexHmd );
+	mEyeCamera[ci::vr::EYE_LEFT].setHmdMatrix( hmdMat );
+	mEyeCamera[ci::vr::EYE_RIGHT].setHmdMatrix( hmdMat );
+	mHmdCamera.setHmdMatrix( hmdMat );
+
+	mDeviceToTrackingMatrix = mContext->getDeviceToTrackingMatrix( ci::vr::simulated::kTrackedDeviceIndexHmd );
+	mTrackingToDeviceMatrix = mContext->getTrackingToDeviceMatrix( ci::vr::simulated::kTrackedDeviceIndexHmd );
+
+	if( ! mOriginInitialized ) {
+		calculateOriginMatrix();
+		// Flag as initialized
+		mOriginInitialized = true;
+	}
+
+	calculateInputRay();
+}
+
+void Hmd::onClipValueChange( float nearClip, float farClip )
+{
+	mNearClip = nearClip;
+	mFarClip = farClip;
+	setupMatrices();
+}
+
+void Hmd::onMonoscopicChange()
+{
+	setupMatrices();
+}
+
+void Hmd::recenterTrackingOrigin()
+{
+	mOriginInitialized = false;
+}
+
+void Hmd::bind()
+{
+	mFrameTiming->beginFrame();
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_BIND );
+
+	beginGpuFrame();
+
+	if( mMultiviewTarget ) {
+		mMultiviewTarget->bind();
+		// Clears both layers
+		ci::gl::ScopedViewport scopedViewPort( mMultiviewTarget->getSize() );
+		ci::gl::clear( mClearColor );
+	}
+	else {
+		mRenderTarget->bindFramebuffer();
+		// Clear it
+		ci::gl::ScopedViewport scopedViewPort( mRenderTargetSize );
+		ci::gl::clear( mClearColor );
+	}
+}
+
+void Hmd::unbind()
+{
+	mFrameTiming->endEye();
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_UNBIND );
+
+	if( mMultiviewTarget ) {
+		mMultiviewTarget->resolve( ci::vr::EYE_LEFT, mRenderTarget, getEyeViewport( ci::vr::EYE_LEFT ) );
+		mMultiviewTarget->resolve( ci::vr::EYE_RIGHT, mRenderTarget, getEyeViewport( ci::vr::EYE_RIGHT ) );
+	}
+	mRenderTarget->unbindFramebuffer();
+
+	endGpuFrame();
+}
+
+void Hmd::submitFrame()
+{
+	mFrameTiming->beginPhase( ci::vr::FrameTiming::PHASE_SUBMIT_FRAME );
+
+	auto& compositor = mContext->getCompositor();
+	compositor->submit( mRenderTarget );
+	{
+		ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_COMPOSITOR_WAIT );
+		compositor->waitGetPoses();
+	}
+
+	// Update pose data
+	updatePoseData();
+	updateElapsedFrames();
+
+	mFrameTiming->endPhase( ci::vr::FrameTiming::PHASE_SUBMIT_FRAME );
+	mFrameTiming->endFrame();
+}
+
+float Hmd::getFullFov() const
+{
+	return mContext->getDeviceManager()->getOptions().getFov();
+}
+
+double Hmd::getTimeInSeconds() const
+{
+	return mContext->getCompositor()->getTimeInSeconds();
+}
+
+double Hmd::getPredictedDisplayTime() const
+{
+	return mContext->getCompositor()->getPredictedDisplayTime();
+}
+
+ci::Area Hmd::getEyeViewport( ci::vr::Eye eye ) const
+{
+	if( ( ci::vr::EYE_LEFT == eye ) || ( ci::vr::EYE_RIGHT == eye ) ) {
+		return calcEyeViewport( eye, mRenderTargetSize, true );
+	}
+	return Area( 0, 0, 0, 0 );
+}
+
+void Hmd::enableEye( ci::vr::Eye eye, ci::vr::CoordSys eyeMatrixMode )
+{
+	if( enableStereoEye( eye, eyeMatrixMode ) ) {
+		return;
+	}
+
+	mFrameTiming->beginEye( eye );
+
+	ci::Area area = getEyeViewport( eye );
+	if( ci::vr::EYE_HMD == eye ) {
+		auto viewport = ci::gl::getViewport();
+		area = ci::Area( viewport.first.x, viewport.first.y, viewport.first.x + viewport.second.x, viewport.first.y + viewport.second.y );
+		float width = static_cast<float>( area.getWidth() );
+		float height = static_cast<float>( area.getHeight() );
+		float aspect = width / height;
+		ci::mat4 mat = glm::perspectiveFov( toRadians( getFullFov() / aspect ), width, height, mNearClip, mFarClip );
+		mHmdCamera.setProjectionMatrix( mat );
+	}
+	ci::gl::viewport( area.getUL(), area.getSize() );
+
+	setMatricesEye( eye, eyeMatrixMode );
+}
+
+void Hmd::calculateOriginMatrix()
+{
+	// Rotation matrix
+	const ci::mat4& hmdDeviceToTrackingMat = mContext->getDeviceToTrackingMatrix( ci::vr::simulated::kTrackedDeviceIndexHmd );
+	ci::vec3 p0 = ci::vec3( hmdDeviceToTrackingMat * ci::vec4( 0, 0, 0, 1 ) );
+	ci::vec3 p1 = ci::vec3( hmdDeviceToTrackingMat * ci::vec4( 0, 0, -1, 1 ) );
+	ci::vec3 dir = p1 - p0;
+	ci::vec3 v0 = ci::vec3( 0, 0, -1 );
+	ci::vec3 v1 = ci::normalize( ci::vec3( dir.x, 0, dir.z ) );
+	ci::quat q = ci::quat( v0, v1 );
+	ci::mat4 rotationMatrix = glm::mat4_cast( q );
+	// Position matrix
+	const ci::vec3& offset = getSessionOptions().getOriginOffset();
+	ci::vec3 w = v1;
+	ci::vec3 v = ci::vec3( 0, 1, 0 );
+	ci::vec3 u = ci::cross( w, v );
+	ci::mat4 positionMatrix = ci::translate( p0 + ( offset.x * u ) + ( offset.y * v ) + ( -offset.z * w ) );
+
+	switch( getSessionOptions().getOriginMode() ) {
+		case ci::vr::ORIGIN_MODE_OFFSETTED: {
+			// Rotation matrix
+			rotationMatrix = ci::mat4();
+			// Position matrix
+			mOriginPosition = offset;
+			positionMatrix = ci::translate( mOriginPosition );
+		}
+		break;
+
+		case ci::vr::ORIGIN_MODE_HMD_OFFSETTED: {
+			// Rotation matrix
+			rotationMatrix = ci::mat4();
+			// Position matrix
+			mOriginPosition = ci::vec3( p0.z ) + offset;
+			positionMatrix = ci::translate( mOriginPosition );
+		}
+		break;
+
+		case ci::vr::ORIGIN_MODE_HMD_ORIENTED: {
+			// Uses the current rotationMatrix and positionMatrix values.
+		}
+		break;
+
+		default: {
+			rotationMatrix = ci::mat4();
+			positionMatrix = ci::mat4();
+		}
+		break;
+	}
+
+	// Compose origin matrix
+	mOriginMatrix = positionMatrix*rotationMatrix;
+	mInverseOriginMatrix = glm::affineInverse( mOriginMatrix );
+}
+
+void Hmd::calculateInputRay()
+{
+	// Ray components
+	ci::mat4 coordSysMatrix;
+	ci::vr::multiplyTransforms( mInverseLookMatrix * mInverseOriginMatrix, &mDeviceToTrackingMatrix, &coordSysMatrix, 1 );
+	ci::vec3 p0 = ci::vec3( coordSysMatrix[3] );
+	ci::vec3 dir = -ci::vec3( coordSysMatrix[2] );
+	// Input ray
+	mInputRay = ci::Ray( p0, dir );
+}
+
+void Hmd::drawMirroredImpl( const ci::Rectf& r )
+{
+	ci::gl::ScopedDepthTest scopedDepthTest( false );
+	ci::gl::ScopedModelMatrix scopedModelMatrix;
+	ci::gl::ScopedColor scopedColor( 1, 1, 1 );
+
+	switch( mMirrorMode ) {
+		// Default to stereo mirroring
+		default:
+		case Hmd::MirrorMode::MIRROR_MODE_STEREO: {
+			// What the compositor received last frame
+			const auto& output = mContext->getCompositor()->getOutput();
+			if( output ) {
+				ci::gl::draw( output->getColorTexture(), r );
+			}
+		}
+		break;
+
+		case Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_STEREO: {
+			auto tex = mRenderTarget->getColorTexture();
+			auto fittedRect = ci::Rectf( tex->getBounds() ).getCenteredFit( r, true );
+			ci::gl::draw( tex, fittedRect );
+		}
+		break;
+
+		case Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_MONO_LEFT: {
+			auto tex = mRenderTarget->getColorTexture();
+			float width = static_cast<float>( tex->getWidth() ) / 2.0f;
+			float height = static_cast<float>( tex->getHeight() );
+			auto texRect = ci::Rectf( 0, 0, width, height );
+			auto fittedRect = r.getCenteredFit( texRect, true );
+			ci::gl::draw( tex, Area( fittedRect ), r );
+		}
+		break;
+
+		case Hmd::MirrorMode::MIRROR_MODE_UNDISTORTED_MONO_RIGHT: {
+			auto tex = mRenderTarget->getColorTexture();
+			float width = static_cast<float>( tex->getWidth() ) / 2.0f;
+			float height = static_cast<float>( tex->getHeight() );
+			auto texRect = ci::Rectf( 0, 0, width, height );
+			texRect += ci::vec2( width, 0.0f );
+			auto fittedRect = r.getCenteredFit( texRect, true );
+			ci::gl::draw( tex, Area( fittedRect ), r );
+		}
+		break;
+	}
+}
+
+void Hmd::drawControllers( ci::vr::Eye eye )
+{
+	if( ci::vr::EYE_STEREO == eye ) {
+		forEachStereoEye( [this]( ci::vr::Eye stereoEye ) { drawControllers( stereoEye ); } );
+		return;
+	}
+
+	ci::vr::FrameTiming::ScopedPhase scopedPhase( mFrameTiming.get(), ci::vr::FrameTiming::PHASE_DRAW_CONTROLLERS );
+
+	const ci::vr::Controller::Type kTypes[2] = { ci::vr::Controller::TYPE_LEFT, ci::vr::Controller::TYPE_RIGHT };
+	for( auto type : kTypes ) {
+		auto ctrl = mContext->getController( type );
+		if( nullptr == ctrl ) {
+			continue;
+		}
+
+		ci::gl::ScopedMatrices scopedMatrices;
+		ci::gl::setMatrices( getEyeCamera( eye ) );
+		ci::gl::setModelMatrix( ctrl->getDeviceToTrackingMatrix() );
+		ci::gl::drawCoordinateFrame( 0.1f, 0.02f, 0.008f );
+	}
+}
+
+void Hmd::drawDebugInfo()
+{
+}
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
@@ -0,0 +1,204 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/simulated/ReplayContext.h"
+#include "cinder/vr/simulated/Controller.h"
+#include "cinder/vr/simulated/ReplayDeviceManager.h"
+#include "cinder/vr/simulated/Hmd.h"
+#include "cinder/Log.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+#include <algorithm>
+#include <cmath>
+
+namespace cinder { namespace vr { namespace simulated {
+
+ReplayContext::ReplayContext( const ci::vr::SessionOptions& sessionOptions, ci::vr::simulated::ReplayDeviceManager* deviceManager )
+	: ci::vr::simulated::Context( sessionOptions, deviceManager ), mReplayDeviceManager( deviceManager )
+{
+}
+
+ReplayContext::~ReplayContext()
+{
+	endSession();
+}
+
+ReplayContextRef ReplayContext::create( const ci::vr::SessionOptions& sessionOptions, ci::vr::simulated::ReplayDeviceManager* deviceManager )
+{
+	ReplayContextRef result = ReplayContextRef( new ReplayContext( sessionOptions, deviceManager ) );
+	return result;
+}
+
+const ci::vr::RecordedController* ReplayContext::findRecordedController( ci::vr::Controller::Type type ) const
+{
+	const ci::vr::RecordedFrame& frame = mRecording->getFrame( mFrameIndex );
+	uint32_t n = std::min( frame.numControllers, ci::vr::kRecordingMaxControllers );
+	for( uint32_t i = 0; i < n; ++i ) {
+		if( static_cast<uint32_t>( type ) == frame.controllers[i].type ) {
+			return &frame.controllers[i];
+		}
+	}
+	return nullptr;
+}
+
+void ReplayContext::scanForControllers()
+{
+	if( ( ! mCompositor ) || ( ! getDeviceManager()->getOptions().getControllersEnabled() ) ) {
+		return;
+	}
+
+	// Connect and disconnect hands as they come and go in the recording
+	const ci::vr::Controller::Type kTypes[2] = { ci::vr::Controller::TYPE_LEFT, ci::vr::Controller::TYPE_RIGHT };
+	for( auto type : kTypes ) {
+		bool recorded = ( nullptr != findRecordedController( type ) );
+		if( recorded && ( ! hasController( type ) ) ) {
+			auto ctrl = ci::vr::simulated::Controller::create( type, this );
+			addController( ctrl );
+		}
+		else if( ( ! recorded ) && hasController( type ) ) {
+			auto it = std::find_if( std::begin( mControllers ), std::end( mControllers ),
+				[type]( const ci::vr::ControllerRef& elem ) -> bool {
+					return type == elem->getType();
+				}
+			);
+			removeController( *it );
+		}
+	}
+}
+
+void ReplayContext::beginSession()
+{
+	if( mCompositor ) {
+		return;
+	}
+
+	mRecording = mReplayDeviceManager->getRecording();
+	mFrameIndex = 0;
+	mFinished = false;
+	mNumUpdates = 0;
+
+	ci::vr::simulated::Context::beginSession();
+}
+
+void ReplayContext::processEvents()
+{
+	if( ! mCompositor ) {
+		return;
+	}
+
+	for( auto& baseCtrl : mControllers ) {
+		auto ctrl = std::dynamic_pointer_cast<ci::vr::simulated::Controller>( baseCtrl );
+		const ci::vr::RecordedController* recorded = findRecordedController( ctrl->getType() );
+		if( nullptr != recorded ) {
+			ctrl->processRecordedInput( *recorded );
+		}
+	}
+}
+
+void ReplayContext::updatePoseData()
+{
+	const auto& options = mReplayDeviceManager->getReplayOptions();
+	const uint32_t numFrames = mRecording->getNumFrames();
+	const uint32_t lastFrame = numFrames - 1;
+
+	if( options.getFrameLocked() ) {
+		uint64_t frameIndex = options.getLooping() ? ( mNumUpdates % numFrames ) : std::min<uint64_t>( mNumUpdates, lastFrame );
+		mFrameIndex = static_cast<uint32_t>( frameIndex );
+		mFinished = ( ! options.getLooping() ) && ( mNumUpdates >= lastFrame );
+	}
+	else {
+		double predictedDisplayTime = mCompositor->getPredictedDisplayTime();
+		if( 0 == mNumUpdates ) {
+			mStartTime = predictedDisplayTime;
+		}
+
+		double firstTime = mRecording->getFrame( 0 ).time;
+		double lastTime = mRecording->getFrame( lastFrame ).time;
+		double t = firstTime + options.getSpeed() * ( predictedDisplayTime - mStartTime );
+		if( options.getLooping() && ( lastTime > firstTime ) ) {
+			t = firstTime + std::fmod( t - firstTime, lastTime - firstTime );
+		}
+		mFrameIndex = mRecording->findFrame( t, mFrameIndex );
+		mFinished = ( ! options.getLooping() ) && ( t >= lastTime );
+	}
+
+	++mNumUpdates;
+
+	ci::vr::simulated::Context::updatePoseData();
+}
+
+void ReplayContext::updatePoseStore( double sampleTime )
+{
+	const ci::vr::RecordedFrame& frame = mRecording->getFrame( mFrameIndex );
+
+	mPoseStore.beginUpdate();
+	ci::vr::PoseStore::forEachDevice( mPoseStore.getValidMask() & ( ~frame.validMask ), [this]( uint32_t deviceIndex ) {
+		mPoseStore.invalidate( deviceIndex );
+	} );
+	ci::vr::PoseStore::forEachDevice( frame.validMask, [this, &frame, sampleTime]( uint32_t deviceIndex ) {
+		const ci::vr::RecordedDevicePose& rec = frame.devices[deviceIndex];
+		ci::vec3 position = ci::vec3( rec.position[0], rec.position[1], rec.position[2] );
+		ci::quat rotation = ci::quat( rec.rotation[3], rec.rotation[0], rec.rotation[1], rec.rotation[2] );
+		ci::vec3 linearVelocity = ci::vec3( rec.linearVelocity[0], rec.linearVelocity[1], rec.linearVelocity[2] );
+		ci::vec3 angularVelocity = ci::vec3( rec.angularVelocity[0], rec.angularVelocity[1], rec.angularVelocity[2] );
+		mPoseStore.setPose( deviceIndex, position, rotation, linearVelocity, angularVelocity, sampleTime + rec.sampleTime );
+	} );
+	mPoseStore.endUpdate();
+}
+
+ci::mat4 ReplayContext::calculateDevicePose( uint32_t deviceIndex, double t ) const
+{
+	if( ci::vr::simulated::kTrackedDeviceIndexHmd == deviceIndex ) {
+		ci::mat4 result = ci::vr::fromRecorded( mRecording->getFrame( mFrameIndex ).hmdDeviceToTracking );
+		return result;
+	}
+
+	// Hold the last known pose while a hand is missing from the recording
+	ci::mat4 result = mPoseStore.getDeviceToTrackingMatrix( deviceIndex );
+	ci::vr::Controller::Type type = ( ci::vr::simulated::kTrackedDeviceIndexLeftHand == deviceIndex ) ? ci::vr::Controller::TYPE_LEFT : ci::vr::Controller::TYPE_RIGHT;
+	const ci::vr::RecordedController* recorded = findRecordedController( type );
+	if( nullptr != recorded ) {
+		result = ci::vr::fromRecorded( recorded->deviceToTracking );
+	}
+	return result;
+}
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
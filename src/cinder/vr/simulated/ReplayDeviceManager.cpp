@@ -0,0 +1,97 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/simulated/ReplayDeviceManager.h"
+#include "cinder/vr/simulated/ReplayContext.h"
+#include "cinder/vr/simulated/Simulated.h"
+#include "cinder/Log.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+#include <string>
+
+namespace cinder { namespace vr { namespace simulated {
+
+const std::string kReplayDeviceVendorName = "Simulated Replay";
+
+// -------------------------------------------------------------------------------------------------
+// ReplayDeviceManager
+// -------------------------------------------------------------------------------------------------
+ReplayDeviceManager::ReplayDeviceManager( ci::vr::Environment *env, const ci::fs::path& path, const ReplayOptions& replayOptions, const Options& options )
+	: ci::vr::simulated::DeviceManager( ci::vr::API_SIMULATED, kReplayDeviceVendorName, env, options ), mPath( path ), mReplayOptions( replayOptions )
+{
+}
+
+ReplayDeviceManager::~ReplayDeviceManager()
+{
+}
+
+void ReplayDeviceManager::initialize()
+{
+	try {
+		mRecording = ci::vr::Recording::create( mPath );
+		CI_LOG_I( "Initializing devices for " << getDeviceVendorName() << " (" << mPath << ", " << mRecording->getNumFrames() << " frames, " << mRecording->getDuration() << "s)" );
+	}
+	catch( const std::exception& e ) {
+		CI_LOG_E( "Couldn't open recording for " << getDeviceVendorName() << ": " << e.what() );
+	}
+}
+
+void ReplayDeviceManager::destroy()
+{
+	CI_LOG_I( "Destroying devices for " << getDeviceVendorName() );
+	mRecording.reset();
+}
+
+ci::vr::ContextRef ReplayDeviceManager::createContext( const ci::vr::SessionOptions& sessionOptions, uint32_t deviceIndex )
+{
+	if( deviceIndex >= numDevices() ) {
+		throw ci::vr::simulated::Exception( "Device index out of range, deviceIndex=" + std::to_string( deviceIndex ) + ", maxIndex=" + std::to_string( numDevices() ) );
+	}
+
+	if( ( ! mRecording ) || ( 0 == mRecording->getNumFrames() ) ) {
+		throw ci::vr::simulated::Exception( "No frames to replay in " + mPath.string() );
+	}
+
+	ci::vr::ContextRef result = ci::vr::simulated::ReplayContext::create( sessionOptions, this );
+	return result;
+}
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )
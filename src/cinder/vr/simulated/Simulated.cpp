@@ -0,0 +1,120 @@
+/*
+ Copyright 2016 Google Inc.
+ 
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+
+
+ Copyright (c) 2016, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/vr/simulated/Simulated.h"
+
+#if defined( CINDER_VR_ENABLE_SIMULATED )
+
+#include <cmath>
+#include <thread>
+
+namespace cinder { namespace vr { namespace simulated  {
+
+// -------------------------------------------------------------------------------------------------
+// Compositor
+// -------------------------------------------------------------------------------------------------
+Compositor::Compositor( float refreshRate, bool throttled )
+	: mRefreshRate( refreshRate ), mThrottled( throttled )
+{
+	if( mRefreshRate <= 0.0f ) {
+		throw ci::vr::simulated::Exception( "Invalid refresh rate: " + std::to_string( mRefreshRate ) );
+	}
+
+	mFrameDuration = 1.0 / static_cast<double>( mRefreshRate );
+	mPredictedDisplayTime = mFrameDuration;
+	mStartTime = Clock::now();
+}
+
+CompositorRef Compositor::create( float refreshRate, bool throttled )
+{
+	CompositorRef result = CompositorRef( new Compositor( refreshRate, throttled ) );
+	return result;
+}
+
+void Compositor::submit( const ci::gl::FboRef& renderTarget )
+{
+	if( ! renderTarget ) {
+		return;
+	}
+
+	if( ( ! mOutput ) || ( mOutput->getSize() != renderTarget->getSize() ) ) {
+		ci::gl::Fbo::Format fboFmt = ci::gl::Fbo::Format();
+		fboFmt.disableDepth();
+		mOutput = ci::gl::Fbo::create( renderTarget->getWidth(), renderTarget->getHeight(), fboFmt );
+	}
+
+	// Resolves multisampled render targets as a side effect
+	renderTarget->blitTo( mOutput, renderTarget->getBounds(), mOutput->getBounds() );
+
+	++mNumFramePresents;
+}
+
+double Compositor::waitGetPoses()
+{
+	++mFrameIndex;
+
+	if( mThrottled ) {
+		// Frames that arrive after their vsync are shown on the next one
+		double elapsed = std::chrono::duration<double>( Clock::now() - mStartTime ).count();
+		uint64_t vsyncIndex = static_cast<uint64_t>( std::ceil( elapsed / mFrameDuration ) );
+		if( vsyncIndex > mFrameIndex ) {
+			mNumDroppedFrames += ( vsyncIndex - mFrameIndex );
+			mFrameIndex = vsyncIndex;
+		}
+
+		auto vsyncTime = mStartTime + std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( mFrameIndex * mFrameDuration ) );
+		std::this_thread::sleep_until( vsyncTime );
+	}
+
+	mPredictedDisplayTime = static_cast<double>( mFrameIndex + 1 ) * mFrameDuration;
+	return mPredictedDisplayTime;
+}
+
+double Compositor::getTimeInSeconds() const
+{
+	// Unthrottled compositors run on simulated time so runs are repeatable
+	if( ! mThrottled ) {
+		return static_cast<double>( mFrameIndex ) * mFrameDuration;
+	}
+
+	return std::chrono::duration<double>( Clock::now() - mStartTime ).count();
+}
+
+}}} // namespace cinder::vr::simulated
+
+#endif // defined( CINDER_VR_ENABLE_SIMULATED )